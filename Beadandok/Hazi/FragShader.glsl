@@ -1,17 +1,13 @@
 #version 330 core
+in vec2 local;
 out vec4 FragColor;
-uniform vec2 circCenter;
-uniform float circRadius;
 uniform vec3 innerColor;
 uniform vec3 outerColor;
 void main() {
-    vec2 fragCoord = gl_FragCoord.xy;
-    float dx = fragCoord.x - circCenter.x;
-    float dy = fragCoord.y - circCenter.y;
-    float dist = sqrt(dx * dx + dy * dy);
-    if (dist > circRadius) {
+    // Distance from the center in units of the radius (unsigned, 1.0 is the edge), local (0, 0) is the center.
+    float t = length(local);
+    if (t > 1.0) {
         discard;
     }
-    float t = dist / circRadius;
     FragColor = vec4(mix(innerColor, outerColor, t), 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 330 core
+in vec2 local;
+in float radius;
+in vec3 innerColor;
+out vec4 FragColor;
+uniform vec3 outerColor;
+void main() {
+    float dist = length(local);
+    float coverage = clamp(radius - dist + 0.5, 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    float t = min(dist / radius, 1.0);
+    FragColor = vec4(mix(innerColor, outerColor, t), coverage);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 330 core
+layout(location = 0) in vec4 aState;
+layout(location = 1) in float aRadius;
+uniform float dt;
+uniform vec2 bounds;
+out vec4 state;
+// Wall bounce along one axis, the same logic as bounceScalar in particleSystem.cpp.
+void bounce(inout float pos, inout float vel, float r, float limit) {
+    if (pos - r < 0.0) {
+        pos = r;
+        vel = abs(vel);
+    }
+    else if (pos + r > limit) {
+        pos = limit - r;
+        vel = -abs(vel);
+    }
+}
+void main() {
+    // One particle per point, captured with transform feedback; nothing is rasterized.
+    vec2 pos = aState.xy + aState.zw * dt;
+    vec2 vel = aState.zw;
+    bounce(pos.x, vel.x, aRadius, bounds.x);
+    bounce(pos.y, vel.y, aRadius, bounds.y);
+    state = vec4(pos, vel);
+}
\ No newline at end of file
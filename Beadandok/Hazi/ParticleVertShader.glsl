@@ -0,0 +1,18 @@
+#version 330 core
+layout(location = 0) in vec2 aCorner;
+layout(location = 1) in float aPosX;
+layout(location = 2) in float aPosY;
+layout(location = 3) in float aRadius;
+layout(location = 4) in vec4 aColor;
+uniform vec2 viewportSize;
+out vec2 local;
+out float radius;
+out vec3 innerColor;
+void main() {
+    // Bounding quad of the circle plus one pixel for the antialiased edge, in window pixels.
+    local = aCorner * (aRadius + 1.0);
+    radius = aRadius;
+    innerColor = aColor.rgb;
+    vec2 pixel = vec2(aPosX, aPosY) + local;
+    gl_Position = vec4(pixel / viewportSize * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
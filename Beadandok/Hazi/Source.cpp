@@ -1,12 +1,24 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "common.cpp"
+#include <particleSystem.cpp>
+#include <gpuParticles.cpp>
+#include <polylineRenderer.cpp>
+#include <collision.cpp>
+#include <inputQueue.cpp>
+#include <tripleBuffer.cpp>
 
 const int WINDOW_WIDTH = 600;
 const int WINDOW_HEIGHT = 600;
@@ -40,29 +52,6 @@ GLuint createShaderProgram(const std::string& vertexSource, const std::string& f
     return shaderProgram;
 }
 
-float distBetween(const glm::vec2& a, const glm::vec2& b) {
-    float dx = b.x - a.x;
-    float dy = b.y - a.y;                                       // Két pont közti táv kiszámolása
-    return std::sqrt(dx * dx + dy * dy);
-}
-
-bool metszesCheck(const glm::vec2& circPos, float radius,
-    const glm::vec2& lineStart, const glm::vec2& lineEnd) {
-    glm::vec2 lineDir = lineEnd - lineStart;
-    float lineLength = std::sqrt(lineDir.x * lineDir.x + lineDir.y * lineDir.y);
-    glm::vec2 lineNorm = lineDir / lineLength;
-
-    glm::vec2 toCircle = circPos - lineStart;
-    float proj = toCircle.x * lineNorm.x + toCircle.y * lineNorm.y;               // Metszés ellenőrzésre szolgáló kód
-
-    glm::vec2 closest;
-    if (proj <= 0) closest = lineStart;
-    else if (proj >= lineLength) closest = lineEnd;
-    else closest = lineStart + lineNorm * proj;
-
-    return distBetween(circPos, closest) <= radius;
-}
-
 glm::vec2 circCenter(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
 float circRadius = 50.0f;
 glm::vec3 innerColor(0.8f, 0.0f, 0.0f);
@@ -71,17 +60,236 @@ glm::vec3 lineColor(0.0f, 0.0f, 1.0f);
 
 float lineY = 0.0f;
 const float lineMove = 0.01f;
+const float lineWidth = 3.0f;
+PolylineRenderer linePolyline;
+
+const float gridCellSize = 32.0f;               // Ütközési rács cellamérete, akadályok száma és hossza pixelben
+const size_t obstacleCount = 2000;
+const float obstacleMinLength = 8.0f;
+const float obstacleMaxLength = 32.0f;
+const float obstacleWidth = 1.5f;
+const unsigned int obstacleSeed = 7;
+SegmentGrid collisionGrid;
+GLuint paddleSegment;
+PolylineRenderer obstaclePolyline;
+std::vector<glm::vec4> obstacleVertices;
+GLuint obstacleGeneration = 0;
+std::vector<CollisionPair> circlePairs, particlePairs;
+size_t particleHits = 0;
+
+glm::vec2 paddleStart() {
+    return glm::vec2(WINDOW_WIDTH / 2.0f - WINDOW_WIDTH / 6.0f, lineY * WINDOW_HEIGHT / 2.0f + WINDOW_HEIGHT / 2.0f);
+}
+
+glm::vec2 paddleEnd() {
+    return glm::vec2(WINDOW_WIDTH / 2.0f + WINDOW_WIDTH / 6.0f, lineY * WINDOW_HEIGHT / 2.0f + WINDOW_HEIGHT / 2.0f);
+}
+
+void updateLine(float y) {
+    glm::vec3 linePoints[] = {
+        {-0.33f, y, 0.0f},                          // Vonal végpontjai
+        {0.33f, y, 0.0f}
+    };
+    std::vector<glm::vec4> vertices;
+    appendPolyline(vertices, linePoints, 2, lineWidth);
+    updatePolylines(linePolyline, vertices);
+}
+
+void movePaddle() {
+    moveSegment(collisionGrid, paddleSegment, paddleStart(), paddleEnd());      // Csak a vonal celláit frissíti
+}
+
+void spawnObstacles() {
+    std::mt19937 generator(obstacleSeed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (size_t i = 0; i < obstacleCount; i++) {
+        glm::vec2 start(WINDOW_WIDTH * unit(generator), WINDOW_HEIGHT * unit(generator));
+        float length = obstacleMinLength + (obstacleMaxLength - obstacleMinLength) * unit(generator);
+        float dir = glm::two_pi<float>() * unit(generator);                    // Véletlen rövid szakaszok a rácsba és a vonalrajzolóba
+        glm::vec2 end = start + length * glm::vec2(std::cos(dir), std::sin(dir));
+        glm::vec3 points[] = { glm::vec3(start, 0.0f), glm::vec3(end, 0.0f) };
+
+        addSegment(collisionGrid, start, end);
+        appendPolyline(obstacleVertices, points, 2, obstacleWidth);
+    }
+    obstacleGeneration++;                                                       // A rajzoló szál ebből tudja, hogy fel kell tölteni
+}
+
+bool circleHitsSegments(const glm::vec2& center, float radius) {
+    circlePairs.clear();
+    queryCircle(collisionGrid, 0, center, radius, circlePairs);
+    for (const CollisionPair& pair : circlePairs) {
+        const Segment& segment = collisionGrid.segments[pair.segment];        // Durva szűrés után pontos vizsgálat a jelöltekre
+        if (circleSegmentOverlap(center, radius, segment.start, segment.end)) return true;
+    }
+    return false;
+}
 
 glm::vec2 veloc(3.0f, 0.0f);     // Kör alap mozgása
 bool isMoving = true;
 const float initSpeed = 3.0f;                   // Kör mozgásához és irányához szükséges paraméterek
 const float angle = glm::radians(25.0f);
+const float speedFactor = 2.0f;                 // Sebesség szorzó a +/- billentyűkhöz
+const float minSpeed = initSpeed / 64.0f;       // A +/- billentyűk korlátai: se nem áll meg, se nem lesz végtelen, az allépések bírják
+const float maxSpeed = initSpeed * 64.0f;
+const int maxCircleSubsteps = 64;
+bool circleContact = false;                     // A képkocka lépései alatt érintette-e a kör valamelyik szakaszt
+unsigned long long circleSubsteps = 0;
+bool tightCircleQuad = true;                    // A kör csak a befoglaló négyzetét rajzolja, nem az egész képernyőt
+
+const size_t particleLoadCount = 1000000;       // Terheléses teszt: részecskék száma, mérete és seedje
+const float particleMinRadius = 1.0f;
+const float particleMaxRadius = 4.0f;
+const unsigned int particleSeed = 2025;
+ParticleSystem particles;
+ParticleRenderer particleRenderer;
+bool particlesActive = false;
+GLuint particleGeneration = 0;
+bool gpuParticles = false;                      // GPU mód: a részecskéket a rajzoló szál lépteti transform feedbackkel
+bool checkRequested = false;
+unsigned long long particleSteps = 0;           // A részecskék összes allépése, GPU módban a GPU-n
+unsigned long long cpuParticleSteps = 0;        // Ennyi allépést tett meg a CPU referencia
+GLuint gpuGeneration = 0, checkGeneration = 0;
+bool gpuAvailable = false;                      // A léptető program lefordult-e
+bool awaitingGpuState = false;                  // A GPU mód kikapcsolása után a CPU a visszaolvasott állapotra vár, nem lépteti újra a GPU lépéseit
+GLuint readbackGeneration = 0;
+unsigned long long readbackSteps = 0;           // Ennyi allépés utáni GPU állapotot kér a szimulációs szál
+
+typedef struct {
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool done;
+    ParticleSystem state;                       // Üres, ha a GPU állapot nem használható, ilyenkor a CPU maga lépteti utol
+} GpuReadback;                                  // A rajzoló szál visszaolvasása a szimulációs szálnak
+
+GpuReadback gpuReadback;
+const float gpuTolerance = 0.01f;               // Pixelben, a GPU másképp kerekíthet (pl. összevont szorzás-összeadás)
+GpuParticleSystem gpuParticleSystem;
+
+const double simulationStep = 1.0 / 60.0;      // Rögzített szimulációs lépésköz, allépések és a képkockánkénti lépések korlátja
+const int simulationSubsteps = 1;
+const int maxStepsPerFrame = 8;
+const double maxInputWait = 0.002;              // A szimulációs szál legfeljebb ennyit alszik, hogy a bemenet hamar sorra kerüljön
+int swapInterval = 1;
+
+typedef struct {
+    glm::vec2 prevCircCenter, circCenter;
+    float alpha;                                // Interpolációs tényező a közzétételkor
+    double publishTime;
+    float lineY;
+    bool metszes, particlesActive, tightQuad;
+    int swapInterval;
+    ParticleSystem particles;                   // Pozíciók CPU módban mindig, sugár és szín csak új generációnál másolva
+    GLuint particleGeneration, obstacleGeneration;
+    bool gpuParticles;
+    GLuint gpuGeneration, checkGeneration;      // GPU módban a teljes CPU állapot csak ezek változásakor kerül a pillanatképbe
+    GLuint readbackGeneration;
+    unsigned long long particleSteps, referenceSteps, readbackSteps;
+    float particleDt;
+    std::vector<glm::vec4> obstacleVertices;
+    size_t particleHits;
+    unsigned long long simFrames, circleSubsteps;
+    double simTime;                             // Összesített szimulációs idő, a rajzoló szál ebből számol átlagot
+    GLdouble inputTime;                         // A pillanatképbe került legrégebbi bemenet ideje, < 0 ha nincs
+} SimulationSnapshot;                           // A szimulációs szál változatlan pillanatképe a rajzoló szálnak
+
+TripleBuffer<SimulationSnapshot> snapshots;
+std::atomic<bool> simulationRunning(false);
+
+void toggleParticles() {
+    particlesActive = !particlesActive;
+    if (particlesActive && particleCount(particles) == 0) {
+        spawnParticles(particles, particleLoadCount, WINDOW_WIDTH, WINDOW_HEIGHT, particleMinRadius, particleMaxRadius, initSpeed, particleSeed);
+        particleGeneration++;
+    }
+}
+
+void advanceParticles(float dt) {
+    particleSteps++;
+    if (gpuParticles || awaitingGpuState) return;                   // GPU módban a rajzoló szál lép, a CPU referencia áll
+    stepParticles(particles, dt, WINDOW_WIDTH, WINDOW_HEIGHT);
+    cpuParticleSteps++;
+}
+
+void requestGpuReadback() {
+    std::lock_guard<std::mutex> lock(gpuReadback.mutex);
+    gpuReadback.done = false;
+    awaitingGpuState = true;
+    readbackSteps = particleSteps;
+    readbackGeneration++;
+}
+
+void installGpuReadback() {
+    std::unique_lock<std::mutex> lock(gpuReadback.mutex);
+    gpuReadback.ready.wait(lock, [] { return gpuReadback.done || !simulationRunning; });       // A következő lépés előtt, így a visszajátszás determinisztikus marad
+    if (!gpuReadback.done) return;
+    if (particleCount(gpuReadback.state) == particleCount(particles)) {
+        particles.posX.swap(gpuReadback.state.posX);
+        particles.posY.swap(gpuReadback.state.posY);
+        particles.velX.swap(gpuReadback.state.velX);
+        particles.velY.swap(gpuReadback.state.velY);
+        cpuParticleSteps = readbackSteps;                                               // Csak a kérés óta tett lépéseket kell utolérni
+    }
+    awaitingGpuState = false;
+}
+
+void syncCpuParticles(float dt) {
+    if ((gpuParticles || awaitingGpuState) && !checkRequested) return;
+    for (; cpuParticleSteps < particleSteps; cpuParticleSteps++)
+        stepParticles(particles, dt, WINDOW_WIDTH, WINDOW_HEIGHT);  // A CPU referencia utoléri a GPU-t: ellenőrzéskor és a GPU mód kikapcsolásakor
+    if (checkRequested) checkGeneration++;
+    checkRequested = false;
+}
+
+void bounceCircle() {
+    if (circCenter.x - circRadius < 0) {
+        circCenter.x = circRadius;
+        veloc.x = std::abs(veloc.x);
+    }
+    else if (circCenter.x + circRadius > WINDOW_WIDTH) {           // Kör visszapattanása a falakról
+        circCenter.x = WINDOW_WIDTH - circRadius;
+        veloc.x = -std::abs(veloc.x);
+    }
+
+    if (circCenter.y - circRadius < 0) {
+        circCenter.y = circRadius;
+        veloc.y = std::abs(veloc.y);
+    }
+    else if (circCenter.y + circRadius > WINDOW_HEIGHT) {
+        circCenter.y = WINDOW_HEIGHT - circRadius;
+        veloc.y = -std::abs(veloc.y);
+    }
+}
+
+void simulateCircle(float dt) {
+    if (!isMoving) return;
+    int substeps = sweptSubsteps(glm::length(veloc) * dt, circRadius, maxCircleSubsteps);      // Csak gyors mozgásnál bontjuk allépésekre
+    circleSubsteps += substeps;
+
+    for (int substep = 0; substep < substeps; substep++) {
+        glm::vec2 motion = veloc * (dt / substeps);
+        float toi;
+        glm::vec2 normal;
+        GLuint segment;
+        if (sweptCircleGrid(collisionGrid, circCenter, motion, circRadius, toi, normal, segment, circlePairs)) circleContact = true;   // Folytonos ütközésvizsgálat, a vékony vonalon sem ugrik át
+
+        circCenter += motion;
+        bounceCircle();
+    }
+}
+
+void scaleSpeed(float factor) {
+    float speed = glm::length(veloc);
+    if (speed == 0.0f) return;
+    veloc *= glm::clamp(speed * factor, minSpeed, maxSpeed) / speed;       // Az irány marad, a nagyság korlátos
+}
 
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         switch (key) {
-        case GLFW_KEY_UP: lineY = std::min(lineY + lineMove, 1.0f); break;
-        case GLFW_KEY_DOWN: lineY = std::max(lineY - lineMove, -1.0f); break;
+        case GLFW_KEY_UP: lineY = std::min(lineY + lineMove, 1.0f); movePaddle(); break;
+        case GLFW_KEY_DOWN: lineY = std::max(lineY - lineMove, -1.0f); movePaddle(); break;
         case GLFW_KEY_S:
             if (isMoving) {
                 veloc.x = initSpeed * std::cos(angle);                          // Billentyű események kezelése
@@ -93,31 +301,179 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
                 veloc.y = initSpeed * std::sin(angle);
             }
             break;
+        case GLFW_KEY_P:
+            if (action == GLFW_PRESS) toggleParticles();                      // Részecskés terheléses teszt ki- és bekapcsolása
+            break;
+        case GLFW_KEY_O:
+            if (action == GLFW_PRESS && collisionGrid.segments.size() == 1) spawnObstacles();     // Akadályok elhelyezése a rácsban
+            break;
+        case GLFW_KEY_EQUAL: scaleSpeed(speedFactor); break;
+        case GLFW_KEY_MINUS: scaleSpeed(1.0f / speedFactor); break;                   // Kör gyorsítása és lassítása
+        case GLFW_KEY_T:
+            if (action == GLFW_PRESS) tightCircleQuad = !tightCircleQuad;       // Szoros és teljes képernyős négyzet váltása
+            break;
+        case GLFW_KEY_B:
+            if (action == GLFW_PRESS) runCollisionBenchmark(4096, 1024, WINDOW_WIDTH, WINDOW_HEIGHT, particleSeed);    // Kötegelt ütközési kernel mérése
+            break;
+        case GLFW_KEY_G:
+            if (action == GLFW_PRESS && particlesActive && gpuAvailable) {
+                gpuParticles = !gpuParticles;                               // CPU és GPU részecske-szimuláció váltása
+                if (gpuParticles) gpuGeneration++;
+                else requestGpuReadback();                                  // Vissza a CPU-ra a GPU állapotából
+            }
+            break;
+        case GLFW_KEY_C:
+            if (action == GLFW_PRESS && gpuParticles) checkRequested = true;    // GPU eredmény ellenőrzése a CPU referencia ellen
+            break;
+        case GLFW_KEY_V:
+            if (action == GLFW_PRESS) swapInterval = 1 - swapInterval;          // V-sync ki- és bekapcsolása, a rajzoló szál alkalmazza
+            break;
+        }
+    }
+}
+
+GLuint64 simulationHash() {
+    GLuint64 hash = hashBytes(&circCenter, sizeof(circCenter));
+    hash = hashBytes(&veloc, sizeof(veloc), hash);
+    float state[] = { lineY, (float)isMoving, (float)particlesActive, (float)collisionGrid.segments.size() };     // Visszajátszáskor ellenőrzött állapot
+    hash = hashBytes(state, sizeof(state), hash);
+    hash = hashBytes(particles.posX.data(), particles.posX.size() * sizeof(float), hash);
+    return hashBytes(particles.posY.data(), particles.posY.size() * sizeof(float), hash);
+}
+
+void publishSnapshot(const glm::vec2& prevCircCenter, bool metszes, const SimulationClock& clock, GLdouble inputTime, double simTime, unsigned long long simFrames) {
+    SimulationSnapshot& snapshot = tripleBufferWriteSlot(snapshots);
+    snapshot.prevCircCenter = prevCircCenter;
+    snapshot.circCenter = circCenter;
+    snapshot.alpha = simulationAlpha(clock);
+    snapshot.publishTime = clock.lastTime;
+    snapshot.lineY = lineY;
+    snapshot.metszes = metszes;
+    snapshot.particlesActive = particlesActive;
+    snapshot.tightQuad = tightCircleQuad;
+    snapshot.swapInterval = swapInterval;
+
+    if (snapshot.particleGeneration != particleGeneration) {
+        snapshot.particles.radius = particles.radius;
+        snapshot.particles.color = particles.color;                             // Csak akkor, ha a rés még a régi generációt tartja
+        snapshot.particleGeneration = particleGeneration;
+    }
+    if (gpuParticles && (snapshot.gpuGeneration != gpuGeneration || snapshot.checkGeneration != checkGeneration)) {
+        snapshot.particles.posX = particles.posX;
+        snapshot.particles.posY = particles.posY;
+        snapshot.particles.velX = particles.velX;                               // Feltöltéshez vagy ellenőrzéshez, nem képkockánként
+        snapshot.particles.velY = particles.velY;
+        snapshot.referenceSteps = cpuParticleSteps;
+    }
+    else if (particlesActive && !gpuParticles) {
+        snapshot.particles.posX = particles.posX;
+        snapshot.particles.posY = particles.posY;
+    }
+    snapshot.gpuParticles = gpuParticles;
+    snapshot.gpuGeneration = gpuGeneration;
+    snapshot.checkGeneration = checkGeneration;
+    snapshot.readbackGeneration = readbackGeneration;
+    snapshot.readbackSteps = readbackSteps;
+    snapshot.particleSteps = particleSteps;
+    snapshot.particleDt = substepTicks(clock);
+    if (snapshot.obstacleGeneration != obstacleGeneration) {
+        snapshot.obstacleVertices = obstacleVertices;
+        snapshot.obstacleGeneration = obstacleGeneration;
+    }
+
+    snapshot.particleHits = particleHits;
+    snapshot.simFrames = simFrames;
+    snapshot.circleSubsteps = circleSubsteps;
+    snapshot.simTime = simTime;
+    snapshot.inputTime = inputTime;
+    publishTripleBuffer(snapshots);
+}
+
+void simulationThread(GLFWwindow* window, SimulationClock simClock) {
+    glm::vec2 prevCircCenter = circCenter;
+    double simTime = 0.0;
+    unsigned long long simFrames = 0;
+
+    while (simulationRunning) {
+        if (awaitingGpuState) installGpuReadback();
+        double frameStart = glfwGetTime();
+        drainInputQueue(window);                                                    // A vonal csak itt mozdul, nem a lépések közben
+        int steps = beginJournalFrame(window, advanceSimulationClock(simClock, frameStart));      // Visszajátszáskor a rögzített lépésszám
+        for (int step = 0; step < steps; step++) {
+            prevCircCenter = circCenter;
+            for (int substep = 0; substep < simClock.substeps; substep++) {
+                simulateCircle(substepTicks(simClock));                                 // Rögzített lépésközű szimuláció
+                if (particlesActive) advanceParticles(substepTicks(simClock));
+            }
+        }
+        syncCpuParticles(substepTicks(simClock));
+        bool metszes = circleContact || circleHitsSegments(circCenter, circRadius);
+        circleContact = false;
+        if (particlesActive && !gpuParticles && steps > 0) {
+            collectCandidatePairs(collisionGrid, particles.posX.data(), particles.posY.data(), particles.radius.data(), particleCount(particles), particlePairs);
+            particleHits = narrowphasePairs(collisionGrid, particles.posX.data(), particles.posY.data(), particles.radius.data(), particlePairs);    // Részecske-szakasz párok kötegelve
+        }
+        if (journalHashFrame()) checkJournalState(simulationHash());         // A hash csak a napló hash képkockáin készül
+
+        GLdouble inputTime = takeInputTime();
+        if (steps > 0 || inputTime >= 0.0) {
+            simTime += glfwGetTime() - frameStart;
+            publishSnapshot(prevCircCenter, metszes, simClock, inputTime, simTime, ++simFrames);       // Csak változáskor készül új pillanatkép
         }
+        else if (inputJournal.mode != JournalReplay)
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::min(simClock.step - simClock.accumulator, maxInputWait)));     // Várakozás a következő lépésig vagy bemenetig
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    parseInputJournalArguments(argc, argv);
     if (!glfwInit()) {
         return EXIT_FAILURE;
     }
 
+    prepareInputJournalWindow();
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Pattogó Kör", nullptr, nullptr);
     if (!window) {
         glfwTerminate();                                                                                        // Inicializálás
         return EXIT_FAILURE;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(swapInterval = journalSwapInterval(1));
 
     if (glewInit() != GLEW_OK) {
         return EXIT_FAILURE;
     }
 
-    glfwSetKeyCallback(window, keyCallback);
+    installInputQueue(window, keyCallback, nullptr, nullptr, nullptr);        // Billentyű callback a bemeneti soron és naplón keresztül
 
     GLuint circShader = createShaderProgram(readShaderFile("VertShader.glsl"),readShaderFile("FragShader.glsl"));
-    GLuint lineShader = createShaderProgram(readShaderFile("LineVertShader.glsl"),readShaderFile("LineFragShader.glsl"));
+    GLuint lineShader = createShaderProgram(readShaderFile("PolylineVertShader.glsl"),readShaderFile("PolylineFragShader.glsl"));
+    initSegmentGrid(collisionGrid, glm::vec2(0.0f), glm::vec2(WINDOW_WIDTH, WINDOW_HEIGHT), gridCellSize);
+    paddleSegment = addSegment(collisionGrid, paddleStart(), paddleEnd());
+    initPolylineRenderer(linePolyline, lineShader);
+    initPolylineRenderer(obstaclePolyline, lineShader);
+    updateLine(lineY);
+    GLuint particleShader = createShaderProgram(readShaderFile("ParticleVertShader.glsl"), readShaderFile("ParticleFragShader.glsl"));
+    initParticleRenderer(particleRenderer, particleShader);
+    GLuint particleStepShader = createParticleStepProgram(readShaderFile("ParticleStepShader.glsl").c_str());
+    gpuAvailable = particleStepShader != 0;                                     // Hibás léptető programmal a GPU mód nem kapcsolható be
+    initGpuParticles(gpuParticleSystem, particleStepShader, particleShader);
+    SimulationClock simClock;
+    initSimulationClock(simClock, simulationStep, simulationSubsteps, maxStepsPerFrame, glfwGetTime());
+    initTripleBuffer(snapshots);
+    publishSnapshot(circCenter, circleHitsSegments(circCenter, circRadius), simClock, -1.0, 0.0, 0);      // Kezdeti pillanatkép, a szál indulása előtt
+    simulationRunning = true;
+    std::thread simulation(simulationThread, window, simClock);                 // Szimulációs szál, a GL kontextus a fő (rajzoló) szálé marad
+
+    float renderedLineY = lineY;
+    int renderedSwapInterval = swapInterval;
+    GLuint uploadedParticleGeneration = 0, uploadedObstacleGeneration = 0;
+    GLuint uploadedGpuGeneration = 0, checkedGeneration = 0, answeredReadbackGeneration = 0;
+    size_t gpuMismatches = 0;
+    float gpuMaxError = 0.0f;
+    unsigned long long statSimFrames = 0, statCircleSubsteps = 0;
+    double statSimTime = 0.0, renderTime = 0.0, statTime = glfwGetTime();
+    int statFrames = 0;
 
     GLuint circVAO, circVBO;
     glGenVertexArrays(1, &circVAO);           // Kör VAO és VBO-ja
@@ -125,7 +481,7 @@ int main() {
 
     std::vector<glm::vec2> circVert = {
         {-1.0f, -1.0f},
-        {1.0f, -1.0f},                         // Kör határai
+        {1.0f, -1.0f},                         // Egységnégyzet: szoros módban a kör befoglaló négyzete, különben a teljes képernyő
         {-1.0f, 1.0f},
         {1.0f, 1.0f}
     };
@@ -136,52 +492,61 @@ int main() {
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
     glEnableVertexAttribArray(0);
 
-    GLuint lineVAO, lineVBO;
-    glGenVertexArrays(1, &lineVAO);                 // Vonal VAO és VBO-ja
-    glGenBuffers(1, &lineVBO);
-
-    std::vector<glm::vec2> lineVert = {
-        {-0.33f, 0.0f},                             // Vonal hossza
-        {0.33f, 0.0f}
-    };
-
-    glBindVertexArray(lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, lineVert.size() * sizeof(glm::vec2), lineVert.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-    glEnableVertexAttribArray(0);
-
     while (!glfwWindowShouldClose(window)) {
-        glClearColor(1.0f, 0.7f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        if (isMoving) {
-            circCenter += veloc;
-
-            if (circCenter.x - circRadius < 0) {
-                circCenter.x = circRadius;
-                veloc.x = std::abs(veloc.x);
+        bool fresh = acquireTripleBuffer(snapshots);
+        const SimulationSnapshot& snapshot = tripleBufferReadSlot(snapshots);      // Mindig a legfrissebb közzétett állapot
+        double renderStart = glfwGetTime();
+
+        if (snapshot.swapInterval != renderedSwapInterval) glfwSwapInterval(renderedSwapInterval = snapshot.swapInterval);
+        if (snapshot.lineY != renderedLineY) updateLine(renderedLineY = snapshot.lineY);
+        if (snapshot.obstacleGeneration != uploadedObstacleGeneration) {
+            updatePolylines(obstaclePolyline, snapshot.obstacleVertices);            // GL feltöltések csak a rajzoló szálon
+            uploadedObstacleGeneration = snapshot.obstacleGeneration;
+        }
+        if (snapshot.particleGeneration != uploadedParticleGeneration) {
+            uploadParticleAttributes(particleRenderer, snapshot.particles);
+            uploadedParticleGeneration = snapshot.particleGeneration;
+        }
+        else if (fresh && snapshot.particlesActive && !snapshot.gpuParticles)
+            uploadParticlePositions(particleRenderer, snapshot.particles);
+        if (snapshot.gpuParticles && snapshot.particlesActive) {
+            if (snapshot.gpuGeneration != uploadedGpuGeneration) {
+                uploadGpuParticles(gpuParticleSystem, snapshot.particles, snapshot.referenceSteps);     // Egyszeri feltöltés a GPU mód bekapcsolásakor
+                uploadedGpuGeneration = snapshot.gpuGeneration;
             }
-            else if (circCenter.x + circRadius > WINDOW_WIDTH) {           // Kör mozgatására és visszapattanására felelős kód
-                circCenter.x = WINDOW_WIDTH - circRadius;
-                veloc.x = -std::abs(veloc.x);
+            if (snapshot.checkGeneration != checkedGeneration) {
+                while (gpuParticleSystem.steps < snapshot.referenceSteps)
+                    stepGpuParticles(gpuParticleSystem, snapshot.particleDt, WINDOW_WIDTH, WINDOW_HEIGHT);
+                gpuMismatches = compareGpuParticles(gpuParticleSystem, snapshot.particles, gpuTolerance, gpuMaxError);     // Ugyanannyi lépés után a CPU referencia ellen
+                std::cout << "GPU particle check after " << gpuParticleSystem.steps << " steps: " << gpuMismatches << " mismatches, max error " << gpuMaxError << " px" << std::endl;
+                checkedGeneration = snapshot.checkGeneration;
             }
-
-            if (circCenter.y - circRadius < 0) {
-                circCenter.y = circRadius;
-                veloc.y = std::abs(veloc.y);
+            while (gpuParticleSystem.steps < snapshot.particleSteps)
+                stepGpuParticles(gpuParticleSystem, snapshot.particleDt, WINDOW_WIDTH, WINDOW_HEIGHT);    // A szimulációs szál lépésszámáig, visszaolvasás nélkül
+        }
+        if (snapshot.readbackGeneration != answeredReadbackGeneration) {
+            ParticleSystem state;
+            if (snapshot.gpuGeneration == uploadedGpuGeneration && gpuParticleSystem.steps <= snapshot.readbackSteps) {
+                while (gpuParticleSystem.steps < snapshot.readbackSteps)
+                    stepGpuParticles(gpuParticleSystem, snapshot.particleDt, WINDOW_WIDTH, WINDOW_HEIGHT);
+                readbackGpuParticles(gpuParticleSystem, state);                        // A GPU mód kikapcsolásakor egyszer, a kérés lépésszámánál
             }
-            else if (circCenter.y + circRadius > WINDOW_HEIGHT) {
-                circCenter.y = WINDOW_HEIGHT - circRadius;
-                veloc.y = -std::abs(veloc.y);
+            {
+                std::lock_guard<std::mutex> lock(gpuReadback.mutex);
+                gpuReadback.state = std::move(state);
+                gpuReadback.done = true;
             }
+            gpuReadback.ready.notify_one();
+            answeredReadbackGeneration = snapshot.readbackGeneration;
         }
 
-        glm::vec2 lineStart(WINDOW_WIDTH / 2.0f - WINDOW_WIDTH / 6.0f,lineY * WINDOW_HEIGHT / 2.0f + WINDOW_HEIGHT / 2.0f);
-        glm::vec2 lineEnd(WINDOW_WIDTH / 2.0f + WINDOW_WIDTH / 6.0f,lineY * WINDOW_HEIGHT / 2.0f + WINDOW_HEIGHT / 2.0f);
+        float alpha = (float)std::min(snapshot.alpha + (renderStart - snapshot.publishTime) / simulationStep, 1.0);
+        glm::vec2 renderCenter = glm::mix(snapshot.prevCircCenter, snapshot.circCenter, alpha);     // Interpoláció az utolsó két állapot között
+
+        glClearColor(1.0f, 0.7f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
 
-        bool metszes = metszesCheck(circCenter, circRadius, lineStart, lineEnd);
-        if (metszes) {
+        if (snapshot.metszes) {
             innerColor = glm::vec3(0.8f, 0.0f, 0.0f);
             outerColor = glm::vec3(0.0f, 0.8f, 0.0f);                       // Metszés ellenőrzése és a színek beállítása
         }
@@ -190,9 +555,19 @@ int main() {
             outerColor = glm::vec3(0.8f, 0.0f, 0.0f);
         }
 
+        if (snapshot.particlesActive) {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);                 // Részecskék kirajzolása
+            if (snapshot.gpuParticles) drawGpuParticles(gpuParticleSystem, outerColor, WINDOW_WIDTH, WINDOW_HEIGHT);
+            else drawParticles(particleRenderer, outerColor, WINDOW_WIDTH, WINDOW_HEIGHT);
+            glDisable(GL_BLEND);
+        }
+
         glUseProgram(circShader);
-        glUniform2f(glGetUniformLocation(circShader, "circCenter"), circCenter.x, circCenter.y);
+        glUniform2f(glGetUniformLocation(circShader, "circCenter"), renderCenter.x, renderCenter.y);
         glUniform1f(glGetUniformLocation(circShader, "circRadius"), circRadius);                       // Kör kirajzolása
+        glUniform2f(glGetUniformLocation(circShader, "viewportSize"), (float)WINDOW_WIDTH, (float)WINDOW_HEIGHT);
+        glUniform1i(glGetUniformLocation(circShader, "tightQuad"), snapshot.tightQuad);
         glUniform3fv(glGetUniformLocation(circShader, "innerColor"), 1, glm::value_ptr(innerColor));
         glUniform3fv(glGetUniformLocation(circShader, "outerColor"), 1, glm::value_ptr(outerColor));
 
@@ -200,30 +575,51 @@ int main() {
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
 
-        glUseProgram(lineShader);
-        glUniform3fv(glGetUniformLocation(lineShader, "lineColor"), 1, glm::value_ptr(lineColor));          // Vonal kirajzolása és frissítése
-
-        std::vector<glm::vec2> newLineVert = {
-            {-0.33f, lineY},
-            {0.33f, lineY}
-        };
-        glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-        glBufferData(GL_ARRAY_BUFFER, newLineVert.size() * sizeof(glm::vec2), newLineVert.data(), GL_STATIC_DRAW);
-
-        glBindVertexArray(lineVAO);
-        glLineWidth(3.0f);
-        glDrawArrays(GL_LINES, 0, 2);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        drawPolylines(linePolyline, glm::mat4(1.0f), glm::vec4(lineColor, 1.0f), WINDOW_WIDTH, WINDOW_HEIGHT);      // Vonal kirajzolása
+        if (!snapshot.obstacleVertices.empty())
+            drawPolylines(obstaclePolyline, glm::ortho(0.0f, (float)WINDOW_WIDTH, 0.0f, (float)WINDOW_HEIGHT), glm::vec4(lineColor, 1.0f), WINDOW_WIDTH, WINDOW_HEIGHT);
+        glDisable(GL_BLEND);
+
+        renderTime += glfwGetTime() - renderStart;
+        statFrames++;
+        if (glfwGetTime() - statTime >= 1.0) {
+            double simFrameTime = snapshot.simFrames > statSimFrames ? (snapshot.simTime - statSimTime) / (snapshot.simFrames - statSimFrames) : 0.0;
+            std::string title = "Pattogó Kör - szimuláció: " + std::to_string(1000.0 * simFrameTime) + " ms, rajzolás: " + std::to_string(1000.0 * renderTime / statFrames) + " ms, kör allépés/s: " + std::to_string(snapshot.circleSubsteps - statCircleSubsteps) + ", bemenet-kép: " + std::to_string(1000.0 * inputQueue.latency) + " ms";
+            if (snapshot.particlesActive && snapshot.gpuParticles) title += ", " + std::to_string(gpuParticleSystem.count) + " részecske a GPU-n, eltérés: " + std::to_string(gpuMismatches) + " (max " + std::to_string(gpuMaxError) + " px)";
+            else if (snapshot.particlesActive) title += ", " + std::to_string(snapshot.particles.posX.size()) + " részecske, " + std::to_string(snapshot.particleHits) + " ütközés";
+            glfwSetWindowTitle(window, title.c_str());                        // Szimulációs idő pillanatképenként, rajzolási idő képkockánként, külön szálon mérve
+            statSimFrames = snapshot.simFrames;
+            statSimTime = snapshot.simTime;
+            statCircleSubsteps = snapshot.circleSubsteps;
+            renderTime = 0.0;
+            statFrames = 0;
+            statTime = glfwGetTime();
+        }
 
         glfwSwapBuffers(window);
+        if (fresh) markInputPresented(snapshot.inputTime);                      // Bemenet és megjelenítés közti késleltetés
         glfwPollEvents();
     }
 
+    simulationRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(gpuReadback.mutex);                       // Ha a szimulációs szál még visszaolvasásra vár
+    }
+    gpuReadback.ready.notify_all();
+    simulation.join();
+    finishInputJournal();
     glDeleteVertexArrays(1, &circVAO);
     glDeleteBuffers(1, &circVBO);
-    glDeleteVertexArrays(1, &lineVAO);
-    glDeleteBuffers(1, &lineVBO);
+    deletePolylineRenderer(linePolyline);
+    deletePolylineRenderer(obstaclePolyline);
+    deleteParticleRenderer(particleRenderer);
+    deleteGpuParticles(gpuParticleSystem);
     glDeleteProgram(circShader);
     glDeleteProgram(lineShader);
+    glDeleteProgram(particleShader);
+    glDeleteProgram(particleStepShader);
     glfwTerminate();
 
     return EXIT_SUCCESS;
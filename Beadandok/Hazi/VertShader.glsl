@@ -1,5 +1,14 @@
 #version 330 core
 layout(location = 0) in vec2 aPos;
+uniform vec2 circCenter;
+uniform float circRadius;
+uniform vec2 viewportSize;
+uniform bool tightQuad;
+out vec2 local;
 void main() {
-    gl_Position = vec4(aPos, 0.0, 1.0);
+    // Tight mode: the unit quad is scaled to the bounding box of the circle, so only its pixels are shaded.
+    // Full screen mode: the quad covers clip space, as before.
+    vec2 pixel = tightQuad ? circCenter + aPos * circRadius : (aPos * 0.5 + 0.5) * viewportSize;
+    local = (pixel - circCenter) / circRadius;
+    gl_Position = vec4(pixel / viewportSize * 2.0 - 1.0, 0.0, 1.0);
 }
\ No newline at end of file
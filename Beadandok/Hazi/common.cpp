@@ -0,0 +1,125 @@
+/** A Hazi közös segédkódja. */
+/** Shared helpers of Hazi. */
+#ifndef HAZI_COMMON_CPP
+#define HAZI_COMMON_CPP
+
+#include <algorithm>
+#include <chrono>
+#include <collision.cpp>
+#include <iostream>
+#include <random>
+
+/** Rögzített lépésközű szimulációs óra: a megjelenítés frissítési frekvenciájától független léptetés. */
+/** Fixed timestep simulation clock: stepping independent of the display refresh rate. */
+typedef struct {
+	double				step;				// length of one simulation step in seconds
+	int					substeps;			// substeps per step
+	int					maxStepsPerFrame;	// cap on the work of one frame, prevents the spiral of death
+	double				accumulator;		// simulated time still owed to the wall clock
+	double				lastTime;
+	unsigned long long	stepCount;
+	unsigned long long	droppedSteps;		// steps discarded by the cap
+} SimulationClock;
+
+void initSimulationClock(SimulationClock &clock, double step, int substeps, int maxStepsPerFrame, double now) {
+	clock.step				= step;
+	clock.substeps			= std::max(substeps, 1);
+	clock.maxStepsPerFrame	= std::max(maxStepsPerFrame, 1);
+	clock.accumulator		= 0.0;
+	clock.lastTime			= now;
+	clock.stepCount			= 0;
+	clock.droppedSteps		= 0;
+}
+
+/** Hozzáadja az eltelt valós időt, és visszaadja, hány lépést kell futtatni ebben a képkockában. */
+/** Adds the elapsed wall time and returns how many steps have to run in this frame. */
+int advanceSimulationClock(SimulationClock &clock, double now) {
+	clock.accumulator	+= std::max(now - clock.lastTime, 0.0);
+	clock.lastTime		= now;
+
+	int	steps = (int)(clock.accumulator / clock.step);
+	/** A korláton felüli lépéseket eldobjuk, a szimuláció ilyenkor lassabban halad a valós időnél. */
+	/** Steps above the cap are dropped, the simulation then runs slower than wall time. */
+	if (steps > clock.maxStepsPerFrame) {
+		clock.droppedSteps	+= steps - clock.maxStepsPerFrame;
+		clock.accumulator	-= (steps - clock.maxStepsPerFrame) * clock.step;
+		steps				= clock.maxStepsPerFrame;
+	}
+	clock.accumulator	-= steps * clock.step;
+	clock.stepCount		+= steps;
+
+	return steps;
+}
+
+/** Egy allépés hossza "tick" egységben, ahol 1 tick = 1/60 s, az eredeti sebességek mértékegysége. */
+/** Length of one substep in ticks, where 1 tick = 1/60 s, the unit of the original velocities. */
+float substepTicks(const SimulationClock &clock) {
+	return (float)(clock.step * 60.0 / clock.substeps);
+}
+
+/** Az utolsó két szimulációs állapot közötti interpolációs tényező, [0, 1). */
+/** Interpolation factor between the last two simulation states, [0, 1). */
+float simulationAlpha(const SimulationClock &clock) {
+	return (float)(clock.accumulator / clock.step);
+}
+
+/** Mikro-benchmark: a kötegelt kör-szakasz kernel minden, a processzor által támogatott változata a skalár metszésvizsgálat ellen, azonos véletlen jeleneten. */
+/** Micro-benchmark: every variant of the batched circle/segment kernel the CPU supports against the scalar intersection test, on the same random scene. */
+void runCollisionBenchmark(size_t circleCount, size_t segmentCount, float width, float height, unsigned int seed) {
+	std::mt19937							generator(seed);
+	std::uniform_real_distribution<float>	unit(0.0f, 1.0f);
+	std::vector<Segment>					segments(segmentCount);
+	std::vector<GLfloat>					circX(circleCount), circY(circleCount), radius(circleCount);
+
+	for (Segment &segment : segments) {
+		segment.start	= glm::vec2(width * unit(generator), height * unit(generator));
+		segment.end		= segment.start + glm::vec2(64.0f * unit(generator) - 32.0f, 64.0f * unit(generator) - 32.0f);
+	}
+	for (size_t c = 0; c < circleCount; c++) {
+		circX[c]	= width * unit(generator);
+		circY[c]	= height * unit(generator);
+		radius[c]	= 1.0f + 15.0f * unit(generator);
+	}
+
+	SegmentBatch	batch;
+	buildSegmentBatch(batch, segments);
+
+	size_t					words = hitMaskWords(segmentCount);
+	std::vector<GLuint>		hitMask(circleCount * words);
+	std::vector<GLfloat>	param(circleCount * segmentCount);
+	std::vector<char>		reference(circleCount * segmentCount);
+
+	auto	scalarStart = std::chrono::steady_clock::now();
+	for (size_t c = 0; c < circleCount; c++)
+		for (size_t s = 0; s < segmentCount; s++)
+			reference[c * segmentCount + s] = circleSegmentOverlap(glm::vec2(circX[c], circY[c]), radius[c], segments[s].start, segments[s].end);
+	auto	scalarEnd = std::chrono::steady_clock::now();
+
+	double	tests		= (double)circleCount * segmentCount;
+	double	scalarTime	= std::chrono::duration<double>(scalarEnd - scalarStart).count();
+
+	std::cout << "Collision benchmark, " << circleCount << " circles x " << segmentCount << " segments:" << std::endl;
+	std::cout << "  scalar metszesCheck: " << 1e9 * scalarTime / tests << " ns/test" << std::endl;
+
+	for (int kernel = SimdKernelScalar; kernel <= selectSimdKernel(); kernel++) {
+		auto	batchStart = std::chrono::steady_clock::now();
+		intersectCirclesSegments(batch, circX.data(), circY.data(), radius.data(), circleCount, hitMask.data(), param.data(), (eSimdKernel)kernel);
+		auto	batchEnd = std::chrono::steady_clock::now();
+
+		/** Eltérés csak a határon lehet, ahol a gyökös és a négyzetes összehasonlítás másképp kerekít. */
+		/** Differences can only occur on the boundary, where the square root and the squared comparison round differently. */
+		size_t	hits = 0, mismatches = 0;
+		for (size_t c = 0; c < circleCount; c++)
+			for (size_t s = 0; s < segmentCount; s++) {
+				bool	hit = (hitMask[c * words + s / 32] >> (s % 32)) & 1u;
+
+				hits		+= hit;
+				mismatches	+= hit != (bool)reference[c * segmentCount + s];
+			}
+
+		double	batchTime = std::chrono::duration<double>(batchEnd - batchStart).count();
+
+		std::cout << "  batch " << simdKernelName((eSimdKernel)kernel) << ": " << 1e9 * batchTime / tests << " ns/test (" << scalarTime / batchTime << "x), hits: " << hits << ", mismatches: " << mismatches << std::endl;
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec3 aPosition;
+layout (location = 2) in float aSize;
+layout (location = 3) in vec4 aColor;
+layout (location = 4) in float aSelected;
+
+uniform mat4 matTransform;
+uniform vec2 viewportSize;
+
+out vec2 local;
+out float radius;
+out vec4 color;
+out float selected;
+
+void main() {
+    // One extra pixel around the circle leaves room for the antialiased edge.
+    float extent = 0.5 * aSize + 1.0;
+    vec4 center = matTransform * vec4(aPosition, 1.0);
+
+    local = aCorner * extent;
+    radius = 0.5 * aSize;
+    color = aColor;
+    selected = aSelected;
+    gl_Position = center + vec4(local * 2.0 / viewportSize * center.w, 0.0, 0.0);
+}
\ No newline at end of file
@@ -5,6 +5,11 @@
 #include <cmath>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <inputQueue.cpp>
+#include <markerRenderer.cpp>
+#include <tripleBuffer.cpp>
 
 const int WINDOW_WIDTH = 600;
 const int WINDOW_HEIGHT = 600;
@@ -12,6 +17,18 @@ const int WINDOW_HEIGHT = 600;
 std::vector<glm::vec2> controlPoints;
 bool drag = false;
 int selectedPoint = -1;
+MarkerRenderer controlPointMarkers;
+std::vector<MarkerInstance> markerInstances;
+std::atomic<int> windowWidth(WINDOW_WIDTH), windowHeight(WINDOW_HEIGHT);      // A rajzoló szál frissíti, a callbackek a kiértékelő szálon olvassák
+
+typedef struct {
+    std::vector<glm::vec2> controlPoints, bezierPoints;
+    std::vector<MarkerInstance> markers;
+    GLdouble inputTime;                         // A pillanatképbe került legrégebbi bemenet ideje, < 0 ha nincs
+} CurveSnapshot;                                // A kiértékelő szál változatlan pillanatképe a rajzoló szálnak
+
+TripleBuffer<CurveSnapshot> snapshots;
+std::atomic<bool> evaluationRunning(false);
 
 std::string readShaderFile(const std::string& filePath) {
     std::ifstream shaderFile(filePath);
@@ -42,6 +59,14 @@ GLuint createShaderProgram(const std::string& vertexSource, const std::string& f
     return shaderProgram;
 }
 
+void updateControlPointMarkers() {
+    markerInstances.resize(controlPoints.size());
+    for (size_t i = 0; i < controlPoints.size(); i++) {
+        bool selected = drag && (int)i == selectedPoint;                                                // Kontrollpont markerek, a húzott pont kiemelve
+        markerInstances[i] = { glm::vec3(controlPoints[i], 0.0f), 8.0f, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f), selected ? 1.0f : 0.0f };
+    }
+}
+
 float sqrDistance(const glm::vec2& p1, const glm::vec2& p2) {
     float sx = p1.x - p2.x;                                                 // Távolság négyzete két pont között
     float sy = p1.y - p2.y;
@@ -79,22 +104,21 @@ glm::vec2 bezierCalc(float t, std::vector<glm::vec2>& points) {
 
 void cursorPosCallback(GLFWwindow* window, double xPos, double yPos) {
     if (drag && selectedPoint != -1) {
-        int width, height;
-        glfwGetWindowSize(window, &width, &height);                           // Kurzor pozíciója
+        int width = windowWidth, height = windowHeight;                       // Kurzor pozíciója
         glm::vec2 mousePos(
             (float)xPos / width * 2.0f - 1.0f,
             1.0f - (float)yPos / height * 2.0f
         );
         controlPoints[selectedPoint] = mousePos;
+        updateControlPointMarkers();
     }
 }
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
         double xPos, yPos;
-        glfwGetCursorPos(window, &xPos, &yPos);
-        int width, height;
-        glfwGetWindowSize(window, &width, &height);
+        journalCursorPos(window, &xPos, &yPos);
+        int width = windowWidth, height = windowHeight;
         glm::vec2 mousePos(
             (float)xPos / width * 2.0f - 1.0f,
             1.0f - (float)yPos / height * 2.0f
@@ -111,12 +135,12 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
         else if (action == GLFW_RELEASE) {
             drag = false;
         }
+        updateControlPointMarkers();
     }
     else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
         double xPos, yPos;
-        glfwGetCursorPos(window, &xPos, &yPos);
-        int width, height;
-        glfwGetWindowSize(window, &width, &height);
+        journalCursorPos(window, &xPos, &yPos);
+        int width = windowWidth, height = windowHeight;
         glm::vec2 mousePos(
             (float)xPos / width * 2.0f - 1.0f,
             1.0f - (float)yPos / height * 2.0f
@@ -125,29 +149,65 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
         int removePoint = actPoint(controlPoints, 0.1f, mousePos);
         if (removePoint != -1) {
             controlPoints.erase(controlPoints.begin() + removePoint);
+            updateControlPointMarkers();
         }
     }
 }
 
+GLuint64 sceneHash() {
+    GLuint64 hash = hashBytes(controlPoints.data(), controlPoints.size() * sizeof(glm::vec2));
+    int state[] = { selectedPoint, drag };                                  // Visszajátszáskor ellenőrzött állapot
+    return hashBytes(state, sizeof(state), hash);
+}
 
-int main() {
+void publishCurve(GLdouble inputTime) {
+    CurveSnapshot& snapshot = tripleBufferWriteSlot(snapshots);
+    snapshot.controlPoints = controlPoints;
+    snapshot.markers = markerInstances;
+    snapshot.bezierPoints.clear();
+    if (controlPoints.size() >= 2) {
+        for (float point = 0; point <= 1; point += 0.01f) {
+            snapshot.bezierPoints.push_back(bezierCalc(point, controlPoints));     // Bézier görbe kiértékelése a kiértékelő szálon
+        }
+    }
+    snapshot.inputTime = inputTime;
+    publishTripleBuffer(snapshots);
+}
+
+void evaluationThread(GLFWwindow* window) {
+    while (evaluationRunning) {
+        drainInputQueue(window);                                            // Sorba állított bemenet, összevont kurzormozgással
+        beginJournalFrame(window, 0);                                       // Rögzített vagy visszajátszott bemenet
+        if (journalHashFrame()) checkJournalState(sceneHash());
+
+        GLdouble inputTime = takeInputTime();
+        if (inputTime >= 0.0) publishCurve(inputTime);                      // Csak változáskor számol és tesz közzé
+        else if (inputJournal.mode != JournalReplay) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+int main(int argc, char** argv) {
+    parseInputJournalArguments(argc, argv);
     if (!glfwInit()) {
         return EXIT_FAILURE;
     }
 
+    prepareInputJournalWindow();
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Bézier-görbe", nullptr, nullptr);
     if (!window) {
         glfwTerminate();                                                                                                // Inicializálás
         return EXIT_FAILURE;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(journalSwapInterval(1));
 
     if (glewInit() != GLEW_OK) {
         return EXIT_FAILURE;
     }
 
     GLuint shaderProgram = createShaderProgram(readShaderFile("VertShader.glsl"),readShaderFile("FragShader.glsl"));
+    GLuint markerProgram = createShaderProgram(readShaderFile("MarkerVertShader.glsl"), readShaderFile("MarkerFragShader.glsl"));
+    initMarkerRenderer(controlPointMarkers, markerProgram);
 
     controlPoints = {
         glm::vec2(-0.7f, -0.5f),
@@ -157,8 +217,11 @@ int main() {
     };
 
 
-    glfwSetMouseButtonCallback(window, mouseButtonCallback);
-    glfwSetCursorPosCallback(window, cursorPosCallback);
+    updateControlPointMarkers();
+    initTripleBuffer(snapshots);
+    publishCurve(-1.0);                     // Kezdeti pillanatkép, a szál indulása előtt
+
+    installInputQueue(window, nullptr, cursorPosCallback, mouseButtonCallback, nullptr);        // Egér callbackek a bemeneti soron és naplón keresztül
 
     GLuint VAO, VBO;
     glGenVertexArrays(1, &VAO);             // VAO és VBO inicializálása
@@ -169,44 +232,57 @@ int main() {
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
     glEnableVertexAttribArray(0);
 
+    evaluationRunning = true;
+    std::thread evaluation(evaluationThread, window);       // Kiértékelő szál, a GL kontextus a fő (rajzoló) szálé marad
+
     while (!glfwWindowShouldClose(window)) {
+        bool fresh = acquireTripleBuffer(snapshots);
+        const CurveSnapshot& snapshot = tripleBufferReadSlot(snapshots);                                                           // Mindig a legfrissebb közzétett állapot
+        if (fresh) updateMarkers(controlPointMarkers, snapshot.markers);
+        int width = windowWidth, height = windowHeight;
+        glViewport(0, 0, width, height);                                                                                           // A rajz kitölti az átméretezett ablakot, mint a kurzor leképezése
         glClear(GL_COLOR_BUFFER_BIT);
         glUseProgram(shaderProgram);
 
-        if (controlPoints.size() >= 2) {
+        if (snapshot.controlPoints.size() >= 2) {
             glUniform3f(glGetUniformLocation(shaderProgram, "color"), 0.3f, 0.0f, 0.5f);
             glBindVertexArray(VAO);                                                                                                 // Kontrollpoligon
-            glBufferData(GL_ARRAY_BUFFER, controlPoints.size() * sizeof(glm::vec2), controlPoints.data(), GL_DYNAMIC_DRAW);
-            glDrawArrays(GL_LINE_STRIP, 0, controlPoints.size());
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, snapshot.controlPoints.size() * sizeof(glm::vec2), snapshot.controlPoints.data(), GL_DYNAMIC_DRAW);
+            glDrawArrays(GL_LINE_STRIP, 0, snapshot.controlPoints.size());
         }
 
 
-        if (controlPoints.size() >= 2) {
-            std::vector<glm::vec2> bezierPoints;
-            for (float point = 0; point <= 1; point += 0.01f) {
-                bezierPoints.push_back(bezierCalc(point, controlPoints));
-            }                                                                                                                       // Bézier görbe
-            glUniform3f(glGetUniformLocation(shaderProgram, "color"), 0.8f, 0.4f, 0.5f);
-            glBufferData(GL_ARRAY_BUFFER, bezierPoints.size() * sizeof(glm::vec2), bezierPoints.data(), GL_DYNAMIC_DRAW);
-            glDrawArrays(GL_LINE_STRIP, 0, bezierPoints.size());
+        if (!snapshot.bezierPoints.empty()) {
+            glUniform3f(glGetUniformLocation(shaderProgram, "color"), 0.8f, 0.4f, 0.5f);                                          // Bézier görbe
+            glBufferData(GL_ARRAY_BUFFER, snapshot.bezierPoints.size() * sizeof(glm::vec2), snapshot.bezierPoints.data(), GL_DYNAMIC_DRAW);
+            glDrawArrays(GL_LINE_STRIP, 0, snapshot.bezierPoints.size());
         }
 
 
-        glUniform3f(glGetUniformLocation(shaderProgram, "color"), 1.0f, 1.0f, 0.0f);
-        glBufferData(GL_ARRAY_BUFFER, controlPoints.size() * sizeof(glm::vec2), controlPoints.data(), GL_DYNAMIC_DRAW);
-        glPointSize(8.0f);                                                                                                         // Kontrollpontok
-        glEnable(GL_POINT_SMOOTH);  // Pont kinézetért felelős parancs
         glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDrawArrays(GL_POINTS, 0, controlPoints.size());
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);                                                                         // Kontrollpontok
+        drawMarkers(controlPointMarkers, glm::mat4(1.0f), width, height);
 
         glfwSwapBuffers(window);
+        if (fresh && markInputPresented(snapshot.inputTime)) {
+            std::string title = "Bézier-görbe - bemenet-kép késleltetés: " + std::to_string(1000.0 * inputQueue.latency) + " ms (max " + std::to_string(1000.0 * inputQueue.maxLatency) + " ms)";
+            glfwSetWindowTitle(window, title.c_str());                      // Bemenet és megjelenítés közti késleltetés
+        }
         glfwPollEvents();
+        glfwGetWindowSize(window, &width, &height);                         // Ablakméret a kiértékelő szál callbackjeinek
+        windowWidth = width;
+        windowHeight = height;
     }
 
+    evaluationRunning = false;
+    evaluation.join();
+    finishInputJournal();
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    deleteMarkerRenderer(controlPointMarkers);
     glDeleteProgram(shaderProgram);
+    glDeleteProgram(markerProgram);
     glfwTerminate();
 
     return EXIT_SUCCESS;
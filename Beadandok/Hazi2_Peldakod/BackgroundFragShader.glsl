@@ -0,0 +1,9 @@
+#version 400 core
+
+in vec2 texCoord;
+uniform sampler2D background;
+out vec4 outColor;
+
+void main() {
+    outColor = texture(background, texCoord);
+}
\ No newline at end of file
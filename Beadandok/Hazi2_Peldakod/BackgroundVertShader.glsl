@@ -0,0 +1,12 @@
+#version 400 core
+
+uniform mat4 matModelView;
+uniform mat4 matProjection;
+uniform float worldSize;
+out vec2 texCoord;
+
+void main() {
+	// The world square as a triangle strip from gl_VertexID, without a vertex buffer.
+	texCoord = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+	gl_Position = matProjection * matModelView * vec4((texCoord * 2.0 - 1.0) * worldSize, 0.0, 1.0);
+}
\ No newline at end of file
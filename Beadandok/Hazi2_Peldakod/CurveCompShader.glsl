@@ -0,0 +1,121 @@
+#version 430 core
+#define	HERMITE_GMT			1
+#define	BEZIER_GMT			2
+#define	BEZIER_BERNSTEIN	3
+#define	MAX_CURVE_VERTICES	256
+
+layout (local_size_x = 64) in;
+
+struct Curve {
+	int	first;
+	int	count;
+	int	type;
+	int	padding;
+};
+
+struct DrawArraysIndirectCommand {
+	uint	count;
+	uint	instanceCount;
+	uint	first;
+	uint	baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer ControlPoints	{ vec4 points[]; };
+layout (std430, binding = 1) readonly buffer Curves			{ Curve curves[]; };
+// The buffer of the polyline renderer: vec4(x, y, z, width in pixels), zero width separates the curves.
+layout (std430, binding = 2) writeonly buffer Vertices		{ vec4 vertices[]; };
+// One command per curve, drawPolylinesIndirect draws them with one glMultiDrawArraysIndirect.
+layout (std430, binding = 3) writeonly buffer Commands		{ DrawArraysIndirectCommand commands[]; };
+
+uniform mat4	matModelView;
+uniform mat4	matProjection;
+uniform vec2	viewportSize;
+uniform float	pixelsPerSegment;
+uniform float	curveWidth;
+
+const mat4x4	hermite	= mat4x4( 2, -2,  1,  1,
+								 -3,  3, -2, -1,
+								  0,  0,  1,  0,
+								  1,  0,  0,  0);
+
+const mat4x4	bezier	= mat4x4(-1,  3, -3,  1,
+								  3, -6,  3,  0,
+								 -3,  3,  0,  0,
+								  1,  0,  0,  0);
+
+vec3 GMT(const Curve curve, const mat4x4 M, const float t) {
+	mat4x3	G = mat4x3(points[curve.first].xyz, points[curve.first + 1].xyz, points[curve.first + 2].xyz, points[curve.first + 3].xyz);
+	vec4	T = vec4(t * t * t, t * t, t, 1.0f);
+
+	return (G * M) * T;
+}
+
+// Bernstein form in nested (Horner) order: the powers of t and 1 - t are built by multiplication, no pow(0, 0) at the endpoints.
+vec3 BezierCurve(const Curve curve, const float t) {
+	int		n = curve.count - 1;
+	float	s = 1.0f - t;
+	float	coefficient = 1.0f;
+	float	tPower = 1.0f;
+	vec3	nextPoint = points[curve.first].xyz * s;
+
+	if (n < 1) return points[curve.first].xyz;
+
+	for (int i = 1; i < n; i++) {
+		tPower *= t;
+		coefficient *= float(n - i + 1) / float(i);
+		nextPoint = (nextPoint + coefficient * tPower * points[curve.first + i].xyz) * s;
+	}
+
+	return nextPoint + tPower * t * points[curve.first + n].xyz;
+}
+
+vec3 evaluate(const Curve curve, const float t) {
+	switch (curve.type) {
+	case HERMITE_GMT:	return GMT(curve, hermite, t);
+	case BEZIER_GMT:	return GMT(curve, bezier, t);
+	default:			return BezierCurve(curve, t);
+	}
+}
+
+vec2 toScreen(const vec3 p) {
+	vec4	clip = matProjection * matModelView * vec4(p, 1.0f);
+
+	return (clip.xy / clip.w) * 0.5f * viewportSize;
+}
+
+// Control polygon length in pixels; a Hermite segment is measured through its equivalent Bezier polygon.
+float screenLength(const Curve curve) {
+	float	len = 0.0f;
+
+	if (curve.type == HERMITE_GMT) {
+		vec2	b0 = toScreen(points[curve.first].xyz);
+		vec2	b1 = toScreen(points[curve.first].xyz + points[curve.first + 2].xyz / 3.0f);
+		vec2	b2 = toScreen(points[curve.first + 1].xyz - points[curve.first + 3].xyz / 3.0f);
+		vec2	b3 = toScreen(points[curve.first + 1].xyz);
+
+		len = distance(b0, b1) + distance(b1, b2) + distance(b2, b3);
+	} else {
+		for (int i = 1; i < curve.count; i++)
+			len += distance(toScreen(points[curve.first + i - 1].xyz), toScreen(points[curve.first + i].xyz));
+	}
+
+	return len;
+}
+
+void main() {
+	uint	curveIndex = gl_WorkGroupID.x;
+	Curve	curve = curves[curveIndex];
+	// The block of the curve: a separator, segments + 1 points and a separator, so the joins stop at the curve's ends.
+	int		segments = clamp(int(ceil(screenLength(curve) / pixelsPerSegment)), 1, MAX_CURVE_VERTICES - 3);
+	uint	first = curveIndex * MAX_CURVE_VERTICES + 1;
+
+	for (int i = int(gl_LocalInvocationID.x); i <= segments; i += int(gl_WorkGroupSize.x))
+		vertices[first + i] = vec4(evaluate(curve, float(i) / float(segments)), curveWidth);
+
+	if (gl_LocalInvocationID.x == 0) {
+		vertices[first - 1] = vec4(0.0f);
+		vertices[first + segments + 1] = vec4(0.0f);
+		// A quad (4 vertices) per segment; gl_VertexID carries the first point, see PolylineVertShader.glsl.
+		commands[curveIndex] = DrawArraysIndirectCommand(4u, uint(segments), 4u * first, 0u);
+	}
+}
\ No newline at end of file
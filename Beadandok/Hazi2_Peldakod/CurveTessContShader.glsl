@@ -1,5 +1,9 @@
 #version 400 core
-layout (vertices = 32) out;
+#ifndef MAX_CONTROL_POINTS
+#define MAX_CONTROL_POINTS	32
+#endif
+
+layout (vertices = MAX_CONTROL_POINTS) out;
 
 void main() {
     if (gl_InvocationID == 0) {
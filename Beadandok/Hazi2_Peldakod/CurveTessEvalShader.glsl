@@ -2,24 +2,37 @@
 #define	HERMITE_GMT			1
 #define	BEZIER_GMT			2
 #define	BEZIER_BERNSTEIN	3
+// CURVE_TYPE and MAX_CONTROL_POINTS are injected after the #version line by LoadShaders, called from initCurveVariant.
+#ifndef CURVE_TYPE
+#define CURVE_TYPE			BEZIER_BERNSTEIN
+#endif
+#ifndef MAX_CONTROL_POINTS
+#define MAX_CONTROL_POINTS	32
+#endif
 
 layout (isolines, equal_spacing, ccw) in;
 
 uniform mat4	matModelView;
 uniform mat4	matProjection;
-uniform int		curveType;
 uniform int		controlPointsNumber;
+uniform float	curveWidth;
 
+// The curve point and its width in pixels, captured by transform feedback for the polyline renderer.
+out vec4		polylinePoint;
+
+#if CURVE_TYPE == HERMITE_GMT
 const mat4x4	hermite	= mat4x4( 2, -2,  1,  1,
 								 -3,  3, -2, -1,
 								  0,  0,  1,  0,
 								  1,  0,  0,  0);
-
+#elif CURVE_TYPE == BEZIER_GMT
 const mat4x4	bezier	= mat4x4(-1,  3, -3,  1,
 								  3, -6,  3,  0,
 								 -3,  3,  0,  0,
 								  1,  0,  0,  0);
+#endif
 
+#if CURVE_TYPE != BEZIER_BERNSTEIN
 vec3 GMT(const mat4x3 G, const mat4x4 M, const float t) {
 	mat4x3	C = G * M;
 	vec4	T = vec4(t * t * t, t * t, t, 1.0f);
@@ -27,7 +40,7 @@ vec3 GMT(const mat4x3 G, const mat4x4 M, const float t) {
 
 	return P;
 }
-
+#else
 float NCR(int n, int r) {
 	if (r == 0) return 1;
 	double result = 1.0f;
@@ -46,34 +59,33 @@ float blending(int n, int i, float t) {
 
 vec3 BezierCurve(float t) {
 	vec3	nextPoint = vec3(0.0f, 0.0f, 0.0f);
-		
-	for (int i = 0; i < controlPointsNumber; i++)
-		nextPoint += blending(controlPointsNumber - 1, i, t) * vec3(gl_in[i].gl_Position);
+
+	// Constant loop bound, so the compiler can unroll the loop.
+	for (int i = 0; i < MAX_CONTROL_POINTS; i++)
+		if (i < controlPointsNumber)
+			nextPoint += blending(controlPointsNumber - 1, i, t) * vec3(gl_in[i].gl_Position);
 
 	return nextPoint;
 }
+#endif
 
 void main() {
 
 if (controlPointsNumber < 2) {
         gl_Position = matProjection * matModelView * vec4(0, 0, 0, 1);
+        polylinePoint = vec4(0.0);          // zero width: a separator, nothing is drawn
         return;
     }
-    
-    float t = gl_TessCoord.x;
-    vec3 result = vec3(0.0);
-    int n = controlPointsNumber - 1;
 
+#if CURVE_TYPE == HERMITE_GMT
 	mat4x3	G = mat4x3(vec3(gl_in[0].gl_Position), vec3(gl_in[1].gl_Position), vec3(gl_in[2].gl_Position), vec3(gl_in[3].gl_Position));
-	switch (curveType) {
-	case HERMITE_GMT:
-		gl_Position = matProjection * matModelView * vec4(GMT(G, hermite, gl_TessCoord.x), 1.0);
-		break;
-	case BEZIER_GMT:
-		gl_Position = matProjection * matModelView * vec4(GMT(G, bezier, gl_TessCoord.x), 1.0);
-		break;
-	case BEZIER_BERNSTEIN:
-		gl_Position = matProjection * matModelView * vec4(BezierCurve(gl_TessCoord.x), 1.0);
-		break;
-	}
+	vec3	P = GMT(G, hermite, gl_TessCoord.x);
+#elif CURVE_TYPE == BEZIER_GMT
+	mat4x3	G = mat4x3(vec3(gl_in[0].gl_Position), vec3(gl_in[1].gl_Position), vec3(gl_in[2].gl_Position), vec3(gl_in[3].gl_Position));
+	vec3	P = GMT(G, bezier, gl_TessCoord.x);
+#else
+	vec3	P = BezierCurve(gl_TessCoord.x);
+#endif
+	gl_Position = matProjection * matModelView * vec4(P, 1.0);
+	polylinePoint = vec4(P, curveWidth);
 }
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 330 core
+in vec2 local;
+in float radius;
+in vec4 color;
+in float selected;
+
+uniform vec4 highlightColor;
+out vec4 outColor;
+
+void main() {
+    // Signed distance to the circle edge in pixels.
+    float dist = length(local) - radius;
+    float coverage = clamp(0.5 - dist, 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+
+    // Selected markers get a 2 pixel wide ring in the highlight color.
+    float ring = selected * clamp(dist + 2.5, 0.0, 1.0);
+    vec4 fill = mix(color, highlightColor, ring);
+    outColor = vec4(fill.rgb, fill.a * coverage);
+}
\ No newline at end of file
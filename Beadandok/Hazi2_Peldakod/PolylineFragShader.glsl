@@ -0,0 +1,30 @@
+#version 330 core
+#define JOIN_MITER  0
+#define JOIN_ROUND  1
+
+flat in vec2 segStart;
+flat in vec2 segEnd;
+flat in vec2 halfWidths;
+in vec2 pixel;
+
+uniform vec4 color;
+uniform int joinStyle;
+out vec4 outColor;
+
+void main() {
+    vec2 ab = segEnd - segStart;
+    float lenSqr = max(dot(ab, ab), 1e-8);
+    float h = clamp(dot(pixel - segStart, ab) / lenSqr, 0.0, 1.0);
+    float halfWidth = mix(halfWidths.x, halfWidths.y, h);
+    float dist;
+
+    // Signed distance in pixels: to the capsule for round joins, to the segment's line for miter joins.
+    if (joinStyle == JOIN_ROUND)
+        dist = length(pixel - segStart - ab * h) - halfWidth;
+    else
+        dist = abs(dot(pixel - segStart, vec2(-ab.y, ab.x)) * inversesqrt(lenSqr)) - halfWidth;
+
+    float coverage = clamp(0.5 - dist, 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+    outColor = vec4(color.rgb, color.a * coverage);
+}
\ No newline at end of file
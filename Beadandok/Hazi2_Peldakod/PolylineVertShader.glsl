@@ -0,0 +1,90 @@
+#version 330 core
+#define JOIN_MITER  0
+#define JOIN_ROUND  1
+// Closer than this in pixels counts as the same point: transform feedback of GL_LINES writes every inner point twice.
+#define SAME_POINT  1e-3
+
+uniform samplerBuffer points;
+uniform int pointCount;
+uniform mat4 matTransform;
+uniform vec2 viewportSize;
+uniform int joinStyle;
+uniform float miterLimit;
+
+flat out vec2 segStart;
+flat out vec2 segEnd;
+flat out vec2 halfWidths;
+out vec2 pixel;
+
+vec2 toPixels(vec3 p) {
+    vec4 clip = matTransform * vec4(p, 1.0);
+    return (clip.xy / clip.w * 0.5 + 0.5) * viewportSize;
+}
+
+vec2 safeNormalize(vec2 v, vec2 fallback) {
+    float len = length(v);
+    return len > 1e-4 ? v / len : fallback;
+}
+
+// The neighbour of point index in the direction step (-1 or 1) in pixels, skipping a copy of the point itself; false at the end of the polyline.
+bool neighbourPixels(int index, int step, vec2 p, out vec2 pn) {
+    pn = p;
+    for (int k = 0; k < 2; k++) {
+        index += step;
+        if (index < 0 || index >= pointCount) return false;
+        vec4 n = texelFetch(points, index);
+        if (n.w <= 0.0) return false;
+        pn = toPixels(n.xyz);
+        if (distance(pn, p) >= SAME_POINT) return true;
+    }
+    return false;
+}
+
+void main() {
+    // Instance i is the segment between points i and i + 1, the strip vertices are (a, -), (a, +), (b, -), (b, +).
+    // An indirect draw starts at point first / 4: gl_VertexID includes first, gl_InstanceID does not include baseInstance.
+    int i = (gl_VertexID >> 2) + gl_InstanceID;
+    vec4 a = texelFetch(points, i);
+    vec4 b = texelFetch(points, i + 1);
+    if (a.w <= 0.0 || b.w <= 0.0) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);     // separator: degenerate quad, nothing is rasterized
+        return;
+    }
+
+    int end = (gl_VertexID >> 1) & 1;
+    float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+    vec2 pa = toPixels(a.xyz);
+    vec2 pb = toPixels(b.xyz);
+    vec2 pn;
+    // The zero-length segment between the two copies of a captured point is not drawn, the segments on its two sides are joined instead.
+    if (distance(pa, pb) < SAME_POINT && (neighbourPixels(i, -1, pa, pn) || neighbourPixels(i + 1, 1, pb, pn))) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    vec2 dir = safeNormalize(pb - pa, vec2(1.0, 0.0));
+    vec2 normal = vec2(-dir.y, dir.x);
+    vec2 p = end == 0 ? pa : pb;
+    // One extra pixel leaves room for the antialiased edge.
+    float extent = 0.5 * (end == 0 ? a.w : b.w) + 1.0;
+    vec2 offset;
+
+    if (joinStyle == JOIN_ROUND) {
+        // Capsules overlap at the joins, the fragment shader cuts the round ends.
+        offset = normal * side * extent + dir * (end == 0 ? -extent : extent);
+    } else {
+        vec2 miter = normal;
+        if (end == 0 ? neighbourPixels(i, -1, pa, pn) : neighbourPixels(i + 1, 1, pb, pn)) {
+            vec2 ndir = safeNormalize(end == 0 ? pa - pn : pn - pb, dir);
+            vec2 m = safeNormalize(normal + vec2(-ndir.y, ndir.x), normal);
+            miter = m / max(dot(m, normal), 1.0 / miterLimit);
+        }
+        offset = miter * side * extent;
+    }
+
+    segStart = pa;
+    segEnd = pb;
+    halfWidths = 0.5 * vec2(a.w, b.w);
+    pixel = p + offset;
+    gl_Position = vec4(pixel / viewportSize * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,25 +1,45 @@
 enum eVertexArrayObject {
     VAOCurveData,
+    VAOSplineData,
     VAOCount
 };
 enum eVertexBufferObject {
     VBOBezierData,
+    VBOSplineData,
+    EBOSplineIndices,
+    SSBOComputePoints,
+    SSBOComputeCurves,
+    DIBOComputeCommands,
     BOCount
 };
 enum eProgram {
     CurveTesselationProgram,
     QuadScreenProgram,
+    CurveComputeProgram,
+    MarkerProgram,
+    PolylineProgram,
+    BackgroundProgram,
     ProgramCount
 };
 enum eTexture {
-    NoTexture,
+    TextureBackground,
     TextureCount
 };
 
 #include "common.cpp"
+#include <markerRenderer.cpp>
+#include <polylineRenderer.cpp>
+#include <asyncTextures.cpp>
+#include <frameCapture.cpp>
 
+#define HERMITE_GMT         1
+#define BEZIER_GMT          2
 #define BEZIER_BERNSTEIN    3
 #define MAX_CONTROL_POINTS  32
+#define GMT_CONTROL_POINTS  4
+#define MAX_SPLINE_POINTS   1024
+#define MAX_CURVE_VERTICES  256                     // Egyezik a CurveCompShader.glsl értékével
+#define CURVE_SEGMENTS      64                      // Egyezik a CurveTessContShader.glsl értékével
 
 GLchar  windowTitle[] = "Bézier-görbe";
 vector<vec3> controlPoints = {
@@ -29,19 +49,147 @@ vector<vec3> controlPoints = {
     vec3(0.7f, -0.5f, 0.0f)
 };
 
-GLuint locationTessMatProjection, locationTessMatModelView, locationCurveType, locationControlPointsNumber;
-GLuint locationCurveColor, locationLineColor, locationPointColor;
+typedef struct {
+    GLuint program;
+    GLint  locationMatProjection, locationMatModelView, locationControlPointsNumber, locationCurveColor, locationCurveWidth;
+} CurveVariant;
+
+const GLint curveDegreeBuckets[] = { 4, 8, 16, MAX_CONTROL_POINTS };       // Fokszám szerinti shader variánsok
+map<GLint, CurveVariant> curveVariants;
+
+GLuint locationLineColor;
+MarkerRenderer controlPointMarkers;
+PolylineRenderer controlPolygon;
+PolylineRenderer curvePolylines;                    // A görbe, a tesszellátor vagy a compute shader írja
+const float pointSize = 8.0f;
+const float lineWidth = 2.0f;
+const float curveWidth = 3.0f;
 GLuint curveType = BEZIER_BERNSTEIN;
+bool splineMode = false;
+float splineTension = 0.0f;                         // 0 = Catmull-Rom, egyébként kardinális spline
+GLsizei splineIndexCount = 0;
+
+typedef struct {
+    GLint first, count, type, padding;
+} ComputeCurve;                                     // A CurveCompShader.glsl Curve struktúrája
+
+bool computeSupported = false;
+bool computeMode = false;
+GLsizei computeCurveCount = 0;
+float pixelsPerSegment = 4.0f;
+GLint locationCompMatModelView, locationCompMatProjection, locationCompViewportSize, locationCompPixelsPerSegment, locationCompCurveWidth;
 GLint selPoint = -1;
 bool drag = false;
 
+string backgroundFile;                              // --background <kép>: átrajzolandó referencia kép
+AsyncTextureLoader textureLoader;
+const GLsizeiptr textureUploadBudget = 1 << 20;     // Képkockánként legfeljebb ennyi bájt textúra feltöltés
+GLint locationBackgroundMatModelView, locationBackgroundMatProjection, locationBackgroundWorldSize;
+string capturePrefix;                               // --capture <előtag>: visszajátszáskor minden képkocka <előtag><képkocka>.qoi fileba
+FrameCapture frameCapture;
+
 vec3 curveColor = vec3(0.8f, 0.4f, 0.5f);
 vec3 lineColor = vec3(0.3f, 0.0f, 0.5f);            // Színek beállítása
 vec3 pointColor = vec3(1.0f, 1.0f, 0.0f);
 
+size_t maxControlPoints() {
+    return splineMode ? MAX_SPLINE_POINTS : MAX_CONTROL_POINTS;
+}
+
+bool drawAsSpline() {
+    return splineMode || controlPoints.size() > MAX_CONTROL_POINTS;                                    // A spline módban felvett sok pontra a Bézier út nem képes, marad a spline
+}
+
+vec3 splineTangent(size_t i) {
+    size_t n = controlPoints.size();
+    float scale = (1.0f - splineTension) * 0.5f;
+    vec3 prev = controlPoints[i > 0 ? i - 1 : i];
+    vec3 next = controlPoints[i + 1 < n ? i + 1 : i];                                                   // Érintők: kardinális spline, a végpontokon egyoldali különbség
+    return (next - prev) * ((i == 0 || i + 1 == n) ? 2.0f * scale : scale);
+}
+
+void updateSpline() {
+    size_t n = controlPoints.size();
+    splineIndexCount = n > 1 ? (GLsizei)(4 * (n - 1)) : 0;
+    if (splineIndexCount == 0) return;
+
+    vector<vec3> splineData(2 * n);
+    vector<GLuint> splineIndices;
+    splineIndices.reserve(splineIndexCount);
+
+    for (size_t i = 0; i < n; i++) {
+        splineData[i] = controlPoints[i];
+        splineData[n + i] = splineTangent(i);
+    }
+
+    for (GLuint i = 0; i + 1 < n; i++) {
+        GLuint segment[] = { i, i + 1, (GLuint)n + i, (GLuint)n + i + 1 };                            // Hermite patch: P0, P1, T0, T1
+        splineIndices.insert(splineIndices.end(), segment, segment + 4);
+    }
+
+    glBindVertexArray(VAO[VAOSplineData]);
+    glBindBuffer(GL_ARRAY_BUFFER, BO[VBOSplineData]);
+    glBufferData(GL_ARRAY_BUFFER, splineData.size() * sizeof(vec3), splineData.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BO[EBOSplineIndices]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, splineIndices.size() * sizeof(GLuint), splineIndices.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glEnableVertexAttribArray(0);
+}
+
+void updateComputeCurves() {
+    vector<vec4> points;
+    vector<ComputeCurve> curves;
+    size_t n = controlPoints.size();
+
+    if (drawAsSpline()) {
+        for (size_t i = 0; i + 1 < n; i++) {
+            curves.push_back({ (GLint)points.size(), GMT_CONTROL_POINTS, HERMITE_GMT, 0 });
+            points.push_back(vec4(controlPoints[i], 1.0f));
+            points.push_back(vec4(controlPoints[i + 1], 1.0f));                                         // Spline szegmensenként egy görbe
+            points.push_back(vec4(splineTangent(i), 0.0f));
+            points.push_back(vec4(splineTangent(i + 1), 0.0f));
+        }
+    }
+    else if (curveType == BEZIER_BERNSTEIN ? n > 1 : n >= GMT_CONTROL_POINTS) {
+        GLint count = curveType == BEZIER_BERNSTEIN ? (GLint)n : GMT_CONTROL_POINTS;
+        curves.push_back({ 0, count, (GLint)curveType, 0 });
+        for (GLint i = 0; i < count; i++)
+            points.push_back(vec4(controlPoints[i], 1.0f));
+    }
+
+    computeCurveCount = (GLsizei)curves.size();
+    if (computeCurveCount == 0) return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, BO[SSBOComputePoints]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, points.size() * sizeof(vec4), points.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, BO[SSBOComputeCurves]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, curves.size() * sizeof(ComputeCurve), curves.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, BO[DIBOComputeCommands]);                                     // Görbénként egy DrawArraysIndirectCommand, a compute shader írja
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, curves.size() * 4 * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void updateControlPointMarkers() {
+    vector<MarkerInstance> markers(controlPoints.size());
+    for (size_t i = 0; i < controlPoints.size(); i++)                                                   // Kontrollpont markerek, a húzott pont kiemelve
+        markers[i] = { controlPoints[i], pointSize, vec4(pointColor, 1.0f), (drag && (GLint)i == selPoint) ? 1.0f : 0.0f };
+    updateMarkers(controlPointMarkers, markers);
+}
+
+void updateControlPolygon() {
+    vector<vec4> vertices;
+    appendPolyline(vertices, controlPoints.data(), controlPoints.size(), lineWidth);                  // Kontrollpoligon csúcspontjai
+    updatePolylines(controlPolygon, vertices);
+}
+
 void updateControlPoints() {
+    if (drawAsSpline()) updateSpline();
+    if (computeMode) updateComputeCurves();
+    updateControlPointMarkers();
+    updateControlPolygon();
+
     glBindBuffer(GL_ARRAY_BUFFER, BO[VBOBezierData]);
-    glBufferData(GL_ARRAY_BUFFER, MAX_CONTROL_POINTS * sizeof(vec3), nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, MAX_SPLINE_POINTS * sizeof(vec3), nullptr, GL_DYNAMIC_DRAW);
     if (!controlPoints.empty()) {
         glBufferSubData(GL_ARRAY_BUFFER, 0, controlPoints.size() * sizeof(vec3), controlPoints.data());     // Kontrolpontok tömbjének frissítése
     }
@@ -50,7 +198,18 @@ void updateControlPoints() {
     glEnableVertexAttribArray(0);
 }
 
-void initTesselationShader() {
+GLint curveVariantKey(GLuint type, GLint bucket) {
+    return type * (MAX_CONTROL_POINTS + 1) + bucket;
+}
+
+GLint curveDegreeBucket(GLuint type, size_t pointsNumber) {
+    if (type != BEZIER_BERNSTEIN) return GMT_CONTROL_POINTS;
+    for (GLint bucket : curveDegreeBuckets)
+        if (pointsNumber <= (size_t)bucket) return bucket;
+    return MAX_CONTROL_POINTS;
+}
+
+void initCurveVariant(GLuint type, GLint bucket) {
     ShaderInfo shader_info[] = {
         { GL_FRAGMENT_SHADER,          "./CurveFragShader.glsl" },
         { GL_TESS_CONTROL_SHADER,      "./CurveTessContShader.glsl" },
@@ -58,25 +217,89 @@ void initTesselationShader() {
         { GL_VERTEX_SHADER,            "./CurveVertShader.glsl" },
         { GL_NONE,                     nullptr }
     };
-    program[CurveTesselationProgram] = LoadShaders(shader_info);                                        // Shader fileok betöltése és inicializálása
+    CurveVariant variant;
+    variant.program = LoadShaders(shader_info, ShaderDefine("CURVE_TYPE", type) + ShaderDefine("MAX_CONTROL_POINTS", bucket), { "polylinePoint" });
+    variant.locationMatProjection = glGetUniformLocation(variant.program, "matProjection");
+    variant.locationMatModelView = glGetUniformLocation(variant.program, "matModelView");          // Variáns fordítása és uniform helyek lekérdezése
+    variant.locationControlPointsNumber = glGetUniformLocation(variant.program, "controlPointsNumber");
+    variant.locationCurveColor = glGetUniformLocation(variant.program, "curveColor");
+    variant.locationCurveWidth = glGetUniformLocation(variant.program, "curveWidth");
+
+    glUseProgram(variant.program);
+    glUniform3fv(variant.locationCurveColor, 1, value_ptr(curveColor));
+    glUniform1f(variant.locationCurveWidth, curveWidth);
+    curveVariants[curveVariantKey(type, bucket)] = variant;
+}
+
+void deleteCurveVariants() {
+    for (auto& variant : curveVariants)                                                                 // Minden variáns egyszer, itt van eltárolva
+        glDeleteProgram(variant.second.program);
+    curveVariants.clear();
+}
+
+const CurveVariant& selectCurveVariant() {
+    return curveVariants.at(curveVariantKey(curveType, curveDegreeBucket(curveType, controlPoints.size())));
+}
+
+void initTesselationShader() {
+    initCurveVariant(HERMITE_GMT, GMT_CONTROL_POINTS);
+    initCurveVariant(BEZIER_GMT, GMT_CONTROL_POINTS);
+    for (GLint bucket : curveDegreeBuckets)                                                             // Shader variánsok előfordítása
+        initCurveVariant(BEZIER_BERNSTEIN, bucket);
+    program[CurveTesselationProgram] = selectCurveVariant().program;
+
     glBindVertexArray(VAO[VAOCurveData]);
     glBindBuffer(GL_ARRAY_BUFFER, BO[VBOBezierData]);
-    glBufferData(GL_ARRAY_BUFFER, MAX_CONTROL_POINTS * sizeof(vec3), nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, MAX_SPLINE_POINTS * sizeof(vec3), nullptr, GL_DYNAMIC_DRAW);
     updateControlPoints();
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
+}
+
+void initComputeShader() {
+    computeSupported = GLEW_VERSION_4_3;
+    if (!computeSupported) return;                                                                      // Compute shader nélkül a tesszellációs út marad
+
+    ShaderInfo shader_info[] = {
+        { GL_COMPUTE_SHADER,           "./CurveCompShader.glsl" },
+        { GL_NONE,                     nullptr }
+    };
+    program[CurveComputeProgram] = LoadShaders(shader_info);
+    locationCompMatModelView = glGetUniformLocation(program[CurveComputeProgram], "matModelView");
+    locationCompMatProjection = glGetUniformLocation(program[CurveComputeProgram], "matProjection");
+    locationCompViewportSize = glGetUniformLocation(program[CurveComputeProgram], "viewportSize");
+    locationCompPixelsPerSegment = glGetUniformLocation(program[CurveComputeProgram], "pixelsPerSegment");
+    locationCompCurveWidth = glGetUniformLocation(program[CurveComputeProgram], "curveWidth");
+}
+
+void computeCurvePolylines() {
+    reservePolylines(curvePolylines, computeCurveCount * MAX_CURVE_VERTICES);                          // Görbénként MAX_CURVE_VERTICES hely, csak a használt rész íródik
+    glUseProgram(program[CurveComputeProgram]);
+    glUniformMatrix4fv(locationCompMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
+    glUniformMatrix4fv(locationCompMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
+    glUniform2f(locationCompViewportSize, (float)windowWidth, (float)windowHeight);
+    glUniform1f(locationCompPixelsPerSegment, pixelsPerSegment);
+    glUniform1f(locationCompCurveWidth, curveWidth);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, BO[SSBOComputePoints]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, BO[SSBOComputeCurves]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, curvePolylines.buffer);                             // Görbék kiértékelése: görbénként egy munkacsoport
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, BO[DIBOComputeCommands]);
+    glDispatchCompute(computeCurveCount, 1, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);                            // Buffer textúraként olvasott pontok, indirekt parancsok
+}
 
-    locationCurveType = glGetUniformLocation(program[CurveTesselationProgram], "curveType");
-    locationControlPointsNumber = glGetUniformLocation(program[CurveTesselationProgram], "controlPointsNumber");
-    locationTessMatProjection = glGetUniformLocation(program[CurveTesselationProgram], "matProjection");
-    locationTessMatModelView = glGetUniformLocation(program[CurveTesselationProgram], "matModelView");
-    locationCurveColor = glGetUniformLocation(program[CurveTesselationProgram], "curveColor");
+void beginCurveCapture(GLsizei patches) {
+    reservePolylines(curvePolylines, patches * CURVE_SEGMENTS * 2);                                     // Izovonalak: szakaszonként két csúcspont
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, curvePolylines.buffer);
+    glBeginTransformFeedback(GL_LINES);
+}
 
-    glUseProgram(program[CurveTesselationProgram]);
-    glUniform1i(locationCurveType, curveType);
-    glUniform1i(locationControlPointsNumber, controlPoints.size());
-    glUniform3fv(locationCurveColor, 1, value_ptr(curveColor));
+void endCurveCapture() {
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
 }
 
 void initShaderProgram() {
@@ -89,41 +312,111 @@ void initShaderProgram() {
     locationMatProjection = glGetUniformLocation(program[QuadScreenProgram], "matProjection");          // Shader program inicializálása
     locationMatModelView = glGetUniformLocation(program[QuadScreenProgram], "matModelView");
     locationLineColor = glGetUniformLocation(program[QuadScreenProgram], "lineColor");
-    locationPointColor = glGetUniformLocation(program[QuadScreenProgram], "lineColor");
+}
+
+void initMarkerShader() {
+    ShaderInfo shader_info[] = {
+        { GL_FRAGMENT_SHADER,          "./MarkerFragShader.glsl" },
+        { GL_VERTEX_SHADER,            "./MarkerVertShader.glsl" },
+        { GL_NONE,                     nullptr }
+    };
+    program[MarkerProgram] = LoadShaders(shader_info);
+    initMarkerRenderer(controlPointMarkers, program[MarkerProgram]);                                  // Instancolt kontrollpont markerek
+    updateControlPointMarkers();
+}
+
+void initPolylineShader() {
+    ShaderInfo shader_info[] = {
+        { GL_FRAGMENT_SHADER,          "./PolylineFragShader.glsl" },
+        { GL_VERTEX_SHADER,            "./PolylineVertShader.glsl" },
+        { GL_NONE,                     nullptr }
+    };
+    program[PolylineProgram] = LoadShaders(shader_info);
+    initPolylineRenderer(controlPolygon, program[PolylineProgram]);                                   // Vastag, élsimított kontrollpoligon
+    initPolylineRenderer(curvePolylines, program[PolylineProgram]);                                   // A görbe ugyanígy, a GPU írja a csúcspontjait
+    updateControlPolygon();
+}
+
+void initBackground() {
+    if (backgroundFile.empty()) return;
+
+    ShaderInfo shader_info[] = {
+        { GL_FRAGMENT_SHADER,          "./BackgroundFragShader.glsl" },
+        { GL_VERTEX_SHADER,            "./BackgroundVertShader.glsl" },
+        { GL_NONE,                     nullptr }
+    };
+    program[BackgroundProgram] = LoadShaders(shader_info);
+    locationBackgroundMatModelView = glGetUniformLocation(program[BackgroundProgram], "matModelView");
+    locationBackgroundMatProjection = glGetUniformLocation(program[BackgroundProgram], "matProjection");
+    locationBackgroundWorldSize = glGetUniformLocation(program[BackgroundProgram], "worldSize");
+
+    initAsyncTextureLoader(textureLoader, 2, textureUploadBudget);                                      // Dekódolás munkaszálakon, feltöltés képkockánként részletekben
+    texture[TextureBackground] = loadTextureAsync(textureLoader, backgroundFile.c_str(), SOIL_LOAD_AUTO, SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_COMPRESS_TO_DXT);
+}
+
+void drawBackground() {
+    glUseProgram(program[BackgroundProgram]);
+    glUniformMatrix4fv(locationBackgroundMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
+    glUniformMatrix4fv(locationBackgroundMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
+    glUniform1f(locationBackgroundWorldSize, (float)worldSize);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture[TextureBackground]);                                           // Betöltésig szürke helyőrző, utána a legfinomabb kész mipmap szint
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void display(GLFWwindow* window, double currentTime) {
-    glEnable(GL_POINT_SMOOTH);
-    glEnable(GL_LINE_SMOOTH);
-    glEnable(GL_BLEND);                                                         // Kontrolpont kör alakjáért felelős parancsok
+    glEnable(GL_BLEND);                                                         // Élsimításhoz szükséges parancsok
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
 
     glClear(GL_COLOR_BUFFER_BIT);
 
-    if (controlPoints.size() > 1) {
-        glUseProgram(program[CurveTesselationProgram]);
-        glUniform1i(locationControlPointsNumber, controlPoints.size());         // Bézier görbe kirajzolása
-        glPatchParameteri(GL_PATCH_VERTICES, controlPoints.size());             
-        glDrawArrays(GL_PATCHES, 0, controlPoints.size());
+    if (texture[TextureBackground]) drawBackground();                          // Referencia kép a görbe alatt
+
+    reservePolylines(curvePolylines, 0);
+    if (computeMode) {
+        if (computeCurveCount > 0) computeCurvePolylines();
+    }
+    else if (drawAsSpline() && splineIndexCount > 0) {
+        const CurveVariant& variant = curveVariants.at(curveVariantKey(HERMITE_GMT, GMT_CONTROL_POINTS));
+        glUseProgram(variant.program);
+        glUniformMatrix4fv(variant.locationMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
+        glUniformMatrix4fv(variant.locationMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
+        glUniform1i(variant.locationControlPointsNumber, GMT_CONTROL_POINTS);             // Spline szegmensek egyetlen rajzolási hívással
+        glPatchParameteri(GL_PATCH_VERTICES, GMT_CONTROL_POINTS);
+        glBindVertexArray(VAO[VAOSplineData]);
+        beginCurveCapture(splineIndexCount / GMT_CONTROL_POINTS);
+        glDrawElements(GL_PATCHES, splineIndexCount, GL_UNSIGNED_INT, nullptr);
+        endCurveCapture();
+        glBindVertexArray(VAO[VAOCurveData]);
     }
 
-    if (!controlPoints.empty()) {
-        glUseProgram(program[QuadScreenProgram]);
+    size_t minPoints = curveType == BEZIER_BERNSTEIN ? 2 : GMT_CONTROL_POINTS;
+    if (!computeMode && !splineMode && controlPoints.size() >= minPoints && controlPoints.size() <= MAX_CONTROL_POINTS) {
+        const CurveVariant& variant = selectCurveVariant();
+        program[CurveTesselationProgram] = variant.program;
+        glUseProgram(variant.program);
+        glUniformMatrix4fv(variant.locationMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
+        glUniformMatrix4fv(variant.locationMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
+        glUniform1i(variant.locationControlPointsNumber, controlPoints.size());         // Bézier görbe kirajzolása
+        glPatchParameteri(GL_PATCH_VERTICES, controlPoints.size());
+        beginCurveCapture(1);
+        glDrawArrays(GL_PATCHES, 0, controlPoints.size());
+        endCurveCapture();
+    }
 
-        if (controlPoints.size() > 1) {
-            glUniform3fv(locationLineColor, 1, value_ptr(lineColor));                   // Kontrollpoligon kirajzolása
-            glLineWidth(2.0f);
-            glDrawArrays(GL_LINE_STRIP, 0, controlPoints.size());
-        }
+    if (computeMode)
+        drawPolylinesIndirect(curvePolylines, matProjection * matModelView, vec4(curveColor, 1.0f), windowWidth, windowHeight, BO[DIBOComputeCommands], computeCurveCount);     // Görbénként a GPU által számolt szakaszszám, egyetlen hívással
+    else
+        drawPolylines(curvePolylines, matProjection * matModelView, vec4(curveColor, 1.0f), windowWidth, windowHeight);     // A görbe vastag, élsimított vonallal
 
-        glUniform3fv(locationPointColor, 1, value_ptr(pointColor));
-        glPointSize(8.0);                                                               // Kontrollpontokkirajzolása
-        glDrawArrays(GL_POINTS, 0, controlPoints.size());
+    if (!controlPoints.empty()) {
+        drawPolylines(controlPolygon, matProjection * matModelView, vec4(lineColor, 1.0f), windowWidth, windowHeight);    // Kontrollpoligon kirajzolása
+        drawMarkers(controlPointMarkers, matProjection * matModelView, windowWidth, windowHeight);     // Kontrollpontok kirajzolása
+        glBindVertexArray(VAO[VAOCurveData]);
     }
 
     glDisable(GL_BLEND);
-    glDisable(GL_LINE_SMOOTH);
 }
 
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
@@ -148,16 +441,27 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
     glUseProgram(program[QuadScreenProgram]);
     glUniformMatrix4fv(locationMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
     glUniformMatrix4fv(locationMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
-
-    glUseProgram(program[CurveTesselationProgram]);
-    glUniformMatrix4fv(locationTessMatModelView, 1, GL_FALSE, glm::value_ptr(matModelView));
-    glUniformMatrix4fv(locationTessMatProjection, 1, GL_FALSE, glm::value_ptr(matProjection));
 }
 
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if ((action == GLFW_PRESS) && (key == GLFW_KEY_ESCAPE))
         glfwSetWindowShouldClose(window, GLFW_TRUE);
 
+    if ((action == GLFW_PRESS) && (key >= GLFW_KEY_1) && (key <= GLFW_KEY_3)) {
+        curveType = HERMITE_GMT + (key - GLFW_KEY_1);                           // Görbe típus váltása: 1 = Hermite, 2 = Bézier GMT, 3 = Bernstein
+        if (computeMode) updateComputeCurves();
+    }
+
+    if ((action == GLFW_PRESS) && (key == GLFW_KEY_C) && computeSupported) {
+        computeMode = !computeMode;                                             // Compute shaderes kiértékelés ki- és bekapcsolása
+        updateControlPoints();
+    }
+
+    if ((action == GLFW_PRESS) && (key == GLFW_KEY_S)) {
+        splineMode = !splineMode;                                               // Spline mód ki- és bekapcsolása
+        updateControlPoints();
+    }
+
     if (action == GLFW_PRESS)
         keyboard[key] = GL_TRUE;
     else if (action == GLFW_RELEASE)
@@ -176,7 +480,7 @@ void cursorPosCallback(GLFWwindow* window, double xPos, double yPos) {
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     double x, y;
-    glfwGetCursorPos(window, &x, &y);
+    journalCursorPos(window, &x, &y);
     float worldX = ((2.0f * x) / windowWidth - 1.0f) * (windowWidth > windowHeight ? worldSize * (float)windowWidth / windowHeight : worldSize);
     float worldY = (1.0f - (2.0f * y) / windowHeight) * (windowWidth > windowHeight ? worldSize : worldSize * (float)windowHeight / windowWidth);
 
@@ -196,17 +500,17 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
         }
 
         drag = true;
+        updateControlPointMarkers();
 
-        if (selPoint == -1 && controlPoints.size() < MAX_CONTROL_POINTS) {                     // Egér mozgatási események kezelése
+        if (selPoint == -1 && controlPoints.size() < maxControlPoints()) {                     // Egér mozgatási események kezelése
             controlPoints.push_back(vec3(worldX, worldY, 0.0f));
             updateControlPoints();
-            glUseProgram(program[CurveTesselationProgram]);
-            glUniform1i(locationControlPointsNumber, controlPoints.size());
         }
     }
     else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE) {
         drag = false;
         selPoint = -1;                                                                     // Kontrollpont mozgatása és görbe újrarajzolása
+        updateControlPointMarkers();
     }
     else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS) {
         float minDist = 0.1f;
@@ -226,27 +530,77 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
         if (selPoint != -1) {
             controlPoints.erase(controlPoints.begin() + selPoint);
             updateControlPoints();                                                            // Kontrollpont törlése
-            glUseProgram(program[CurveTesselationProgram]);
-            glUniform1i(locationControlPointsNumber, controlPoints.size());
         }
     }
 }
 
-int main(void) {
+GLuint64 sceneHash() {
+    GLuint64 hash = hashBytes(controlPoints.data(), controlPoints.size() * sizeof(vec3));
+    GLint state[] = { (GLint)curveType, splineMode, computeMode, selPoint, drag, windowWidth, windowHeight };      // Visszajátszáskor ellenőrzött állapot
+    return hashBytes(state, sizeof(state), hash);
+}
+
+void updateLatencyTitle() {
+    string title = string(windowTitle) + " - bemenet-kép késleltetés: " + to_string(1000.0 * inputQueue.latency) + " ms (max " + to_string(1000.0 * inputQueue.maxLatency) + " ms)";
+    glfwSetWindowTitle(window, title.c_str());
+}
+
+bool capturing() {
+    return inputJournal.mode == JournalReplay && !capturePrefix.empty();
+}
+
+void captureReplayFrame() {
+    char number[16];
+    snprintf(number, sizeof(number), "%06u", inputJournal.frame - 1);                                   // A napló képkocka sorszáma, mint az eltérés üzenetében
+    captureFrame(frameCapture, (capturePrefix + number + ".qoi").c_str(), SOIL_SAVE_TYPE_QOI, 0, 0, windowWidth, windowHeight);
+}
+
+void parseArguments(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i++)
+        if (string(argv[i]) == "--background") backgroundFile = argv[++i];                              // A napló kapcsolóit a parseInputJournalArguments kezeli
+        else if (string(argv[i]) == "--capture") capturePrefix = argv[++i];
+}
+
+int main(int argc, char** argv) {
+    parseInputJournalArguments(argc, argv);
+    parseArguments(argc, argv);
     init(4, 0, GLFW_OPENGL_COMPAT_PROFILE);
     initTesselationShader();
     initShaderProgram();
+    initComputeShader();
+    initMarkerShader();
+    initPolylineShader();
+    initBackground();
+    if (capturing()) initFrameCapture(frameCapture, 3, 8, 2);                   // Kiolvasás 3 képkockával később, legfeljebb 8 kódolásra váró kép
 
     setlocale(LC_ALL, "");
 
     framebufferSizeCallback(window, windowWidth, windowHeight);
 
     while (!glfwWindowShouldClose(window)) {
+        drainInputQueue(window);                                                    // Sorba állított bemenet, összevont kurzormozgással
+        beginJournalFrame(window, 0);                                               // Rögzített vagy visszajátszott bemenet
+        if (journalHashFrame()) checkJournalState(sceneHash());
+        if (texture[TextureBackground]) updateAsyncTextures(textureLoader, textureUploadBudget);
         display(window, glfwGetTime());
+        if (capturing()) captureReplayFrame();                                      // A hátsó bufferből, csere előtt
         glfwSwapBuffers(window);
+        if (markInputPresented()) updateLatencyTitle();
         glfwPollEvents();
     }
 
+    finishInputJournal();
+    if (capturing()) {
+        size_t written, failed;
+        deleteFrameCapture(frameCapture);                                           // Megvárja az utolsó fileokat is
+        frameCaptureStatistics(frameCapture, written, failed);
+        cout << "Captured " << written << " frames to " << capturePrefix << "*.qoi, " << failed << " failed." << endl;
+    }
+    deleteMarkerRenderer(controlPointMarkers);
+    deletePolylineRenderer(controlPolygon);
+    deletePolylineRenderer(curvePolylines);
+    deleteCurveVariants();
+    if (texture[TextureBackground]) deleteAsyncTextureLoader(textureLoader);                           // A munkaszálak leállítása a kilépés előtt
     cleanUpScene(EXIT_SUCCESS);
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -115,12 +115,17 @@
 #include "stb_image_write.h"
 #include "image_helper.h"
 #include "image_DXT.h"
+#include "image_QOI.h"
+#include "texture_cache.h"
+#include "file_map.h"
 #include "pvr_helper.h"
 #include "pkm_helper.h"
+#include "ktx_helper.h"
 #include "jo_jpeg.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 /*	error reporting	*/
 const char *result_string_pointer = "SOIL initialized";
@@ -156,6 +161,8 @@ static int has_tex_rectangle_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_tex_rectangle_capability( void );
 #define SOIL_TEXTURE_RECTANGLE_ARB				0x84F5
 #define SOIL_MAX_RECTANGLE_TEXTURE_SIZE_ARB		0x84F8
+/*	for the DDS pixel formats	*/
+#define SOIL_FOURCC( a, b, c, d )	( ((unsigned int)(a) << 0) | ((unsigned int)(b) << 8) | ((unsigned int)(c) << 16) | ((unsigned int)(d) << 24) )
 /*	for using DXT compression	*/
 static int has_DXT_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_DXT_capability( void );
@@ -166,12 +173,26 @@ int query_DXT_capability( void );
 #define SOIL_RGBA_S3TC_DXT3		0x83F2
 #define SOIL_RGBA_S3TC_DXT5		0x83F3
 #define SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT  0x8C4C
+#define SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
 #define SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+/*	for using BC4 / BC5 (RGTC) and BC7 (BPTC) compression	*/
+static int has_RGTC_capability = SOIL_CAPABILITY_UNKNOWN;
+int query_RGTC_capability( void );
+static int has_BPTC_capability = SOIL_CAPABILITY_UNKNOWN;
+int query_BPTC_capability( void );
+#define SOIL_COMPRESSED_RED_RGTC1				0x8DBB
+#define SOIL_COMPRESSED_RG_RGTC2				0x8DBD
+#define SOIL_COMPRESSED_RGBA_BPTC_UNORM			0x8E8C
+#define SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM	0x8E8D
 static int has_sRGB_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_sRGB_capability( void );
 typedef void (APIENTRY * P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC) (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid * data);
 static P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC soilGlCompressedTexImage2D = NULL;
 
+/*	for reading the textures back into the texture cache	*/
+typedef void (APIENTRY * P_SOIL_GLGETCOMPRESSEDTEXIMAGEPROC) (GLenum target, GLint level, GLvoid *img);
+static P_SOIL_GLGETCOMPRESSEDTEXIMAGEPROC soilGlGetCompressedTexImage = NULL;
+
 typedef void (APIENTRY *P_SOIL_GLGENERATEMIPMAPPROC)(GLenum target);
 static P_SOIL_GLGENERATEMIPMAPPROC soilGlGenerateMipmap = NULL;
 
@@ -192,6 +213,16 @@ int query_ETC1_capability( void );
 #define SOIL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG                     0x8C03
 #define SOIL_GL_ETC1_RGB8_OES                                     0x8D64
 
+/*	for the array and 3D textures of KTX files	*/
+#define SOIL_TEXTURE_3D						0x806F
+#define SOIL_TEXTURE_2D_ARRAY				0x8C1A
+#define SOIL_TEXTURE_CUBE_MAP_ARRAY			0x9009
+#define SOIL_TEXTURE_MAX_LEVEL				0x813D
+typedef void (APIENTRY * P_SOIL_GLTEXIMAGE3DPROC) (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+static P_SOIL_GLTEXIMAGE3DPROC soilGlTexImage3D = NULL;
+typedef void (APIENTRY * P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC) (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const GLvoid *data);
+static P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC soilGlCompressedTexImage3D = NULL;
+
 #if defined( SOIL_X11_PLATFORM ) || defined( SOIL_PLATFORM_WIN32 ) || defined( SOIL_PLATFORM_OSX )
 typedef const GLubyte *(APIENTRY * P_SOIL_glGetStringiFunc) (GLenum, GLuint);
 static P_SOIL_glGetStringiFunc soilGlGetStringiFunc = NULL;
@@ -384,6 +415,22 @@ int SOIL_GL_ExtensionSupported(const char *extension)
 	return 0;
 }
 
+int SOIL_GL_compression_supported( unsigned int compress_flag )
+{
+	switch( compress_flag )
+	{
+	case SOIL_FLAG_COMPRESS_TO_DXT:
+		return query_DXT_capability() == SOIL_CAPABILITY_PRESENT;
+	case SOIL_FLAG_COMPRESS_TO_BC4:
+	case SOIL_FLAG_COMPRESS_TO_BC5:
+		return query_RGTC_capability() == SOIL_CAPABILITY_PRESENT;
+	case SOIL_FLAG_COMPRESS_TO_BC7:
+		return query_BPTC_capability() == SOIL_CAPABILITY_PRESENT;
+	default:
+		return 0;
+	}
+}
+
 /*	other functions	*/
 unsigned int
 	SOIL_internal_create_OGL_texture
@@ -396,6 +443,28 @@ unsigned int
 		unsigned int opengl_texture_target,
 		unsigned int texture_check_size_enum
 	);
+static unsigned int
+	SOIL_internal_load_cached_OGL_texture
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	);
+static void
+	SOIL_internal_cache_OGL_texture
+	(
+		const texture_cache_key *key,
+		unsigned int tex_id,
+		unsigned int flags
+	);
+static int
+	SOIL_internal_map_file
+	(
+		const char *filename,
+		file_map *map
+	);
 
 /*	and the code magic begins here [8^)	*/
 unsigned int
@@ -436,6 +505,16 @@ unsigned int
 		}
 	}
 
+	if( flags & SOIL_FLAG_KTX_LOAD_DIRECT )
+	{
+		tex_id = SOIL_direct_load_KTX( filename, reuse_texture_ID, flags, 0 );
+		if( tex_id )
+		{
+			/*	hey, it worked!!	*/
+			return tex_id;
+		}
+	}
+
 	if( flags & SOIL_FLAG_ETC1_LOAD_DIRECT )
 	{
 		tex_id = SOIL_direct_load_ETC1( filename, reuse_texture_ID, flags );
@@ -446,6 +525,21 @@ unsigned int
 		}
 	}
 
+	/*	with a texture cache the whole file is needed for its key	*/
+	if( texture_cache_is_open() )
+	{
+		file_map map;
+		if( SOIL_internal_map_file( filename, &map ) )
+		{
+			tex_id = SOIL_internal_load_cached_OGL_texture(
+					map.data, (int)map.length, force_channels,
+					reuse_texture_ID, flags );
+			file_map_close( &map );
+			return tex_id;
+		}
+		/*	let stb_image report the problem	*/
+	}
+
 	/*	try to load the image	*/
 	img = SOIL_load_image( filename, &width, &height, &channels, force_channels );
 	/*	channels holds the original number of channels, which may have been forced	*/
@@ -572,6 +666,18 @@ unsigned int
 		}
 	}
 
+	if( flags & SOIL_FLAG_KTX_LOAD_DIRECT )
+	{
+		tex_id = SOIL_direct_load_KTX_from_memory(
+				buffer, buffer_length,
+				reuse_texture_ID, flags, 0 );
+		if( tex_id )
+		{
+			/*	hey, it worked!!	*/
+			return tex_id;
+		}
+	}
+
 	if( flags & SOIL_FLAG_ETC1_LOAD_DIRECT )
 	{
 		tex_id = SOIL_direct_load_ETC1_from_memory(
@@ -584,6 +690,13 @@ unsigned int
 		}
 	}
 
+	if( texture_cache_is_open() )
+	{
+		return SOIL_internal_load_cached_OGL_texture(
+				buffer, buffer_length, force_channels,
+				reuse_texture_ID, flags );
+	}
+
 	/*	try to load the image	*/
 	img = SOIL_load_image_from_memory(
 					buffer, buffer_length,
@@ -612,6 +725,390 @@ unsigned int
 	return tex_id;
 }
 
+/*	maps a whole file for the loaders that take a buffer
+	(with an int length), they read it in place	*/
+static int
+	SOIL_internal_map_file
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	if( !file_map_open( filename, map ) )
+	{
+		return 0;
+	}
+	if( map->length > INT_MAX )
+	{
+		file_map_close( map );
+		return 0;
+	}
+	return 1;
+}
+
+struct SOIL_archive
+{
+	file_archive archive;
+};
+
+SOIL_archive*
+	SOIL_open_archive
+	(
+		const char *filename
+	)
+{
+	SOIL_archive *archive = (SOIL_archive*)malloc( sizeof( SOIL_archive ) );
+	if( NULL == archive )
+	{
+		result_string_pointer = "malloc failed";
+		return NULL;
+	}
+	if( !file_archive_open( filename, &archive->archive ) )
+	{
+		free( archive );
+		result_string_pointer = "Can not open the archive, or it is not a ZIP file";
+		return NULL;
+	}
+	result_string_pointer = "Archive opened";
+	return archive;
+}
+
+unsigned int
+	SOIL_load_OGL_texture_from_archive
+	(
+		const SOIL_archive *archive,
+		const char *name,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	)
+{
+	const file_archive_entry *entry;
+	unsigned int tex_id;
+	if( NULL == archive )
+	{
+		result_string_pointer = "NULL archive";
+		return 0;
+	}
+	entry = file_archive_find( &archive->archive, name );
+	if( NULL == entry )
+	{
+		result_string_pointer = "Image not found in the archive (or it is compressed)";
+		return 0;
+	}
+	if( entry->length > INT_MAX )
+	{
+		result_string_pointer = "Image in the archive is too large";
+		return 0;
+	}
+	/*	OpenGL has its own copy once the upload returns, so
+		the pages of the image are only needed in between	*/
+	file_map_advise( &archive->archive.map, entry->offset, entry->length, FILE_MAP_WILLNEED );
+	tex_id = SOIL_load_OGL_texture_from_memory(
+			archive->archive.map.data + entry->offset, (int)entry->length,
+			force_channels, reuse_texture_ID, flags );
+	file_map_advise( &archive->archive.map, entry->offset, entry->length, FILE_MAP_DONTNEED );
+	return tex_id;
+}
+
+void
+	SOIL_close_archive
+	(
+		SOIL_archive *archive
+	)
+{
+	if( NULL != archive )
+	{
+		file_archive_close( &archive->archive );
+		free( archive );
+	}
+}
+
+int
+	SOIL_set_texture_cache
+	(
+		const char *directory,
+		unsigned int max_megabytes
+	)
+{
+	if( NULL == directory )
+	{
+		texture_cache_close();
+		result_string_pointer = "Texture cache closed";
+		return 1;
+	}
+	if( !texture_cache_open( directory, (unsigned long)max_megabytes * 1024 ) )
+	{
+		result_string_pointer = "Texture cache directory can not be written";
+		return 0;
+	}
+	result_string_pointer = "Texture cache opened";
+	return 1;
+}
+
+static unsigned int
+	SOIL_internal_load_cached_OGL_texture
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	)
+{
+	/*	variables	*/
+	texture_cache_key key;
+	unsigned char *cached;
+	int cached_length;
+	unsigned char* img;
+	int width, height, channels;
+	unsigned int tex_id;
+	/*	a hit is the finished texture, upload it as it is	*/
+	texture_cache_make_key( buffer, buffer_length, flags, force_channels, &key );
+	cached = texture_cache_read( &key, &cached_length );
+	if( NULL != cached )
+	{
+		tex_id = SOIL_direct_load_DDS_from_memory(
+				cached, cached_length,
+				reuse_texture_ID, flags, 0 );
+		SOIL_free_image_data( cached );
+		if( tex_id )
+		{
+			result_string_pointer = "Texture loaded from the cache";
+			return tex_id;
+		}
+		/*	e.g. made with a driver that had other formats, redo it	*/
+		texture_cache_remove( &key );
+	}
+	/*	a miss, the usual way	*/
+	img = SOIL_load_image_from_memory(
+					buffer, buffer_length,
+					&width, &height, &channels,
+					force_channels );
+	/*	channels holds the original number of channels, which may have been forced	*/
+	if( (force_channels >= 1) && (force_channels <= 4) )
+	{
+		channels = force_channels;
+	}
+	if( NULL == img )
+	{
+		/*	image loading failed	*/
+		result_string_pointer = stbi_failure_reason();
+		return 0;
+	}
+	/*	OK, make it a texture!	*/
+	tex_id = SOIL_internal_create_OGL_texture(
+			img, &width, &height, channels,
+			reuse_texture_ID, flags,
+			GL_TEXTURE_2D, GL_TEXTURE_2D,
+			GL_MAX_TEXTURE_SIZE );
+	/*	and keep it for the next time	*/
+	if( tex_id && !(flags & SOIL_FLAG_TEXTURE_RECTANGLE) )
+	{
+		SOIL_internal_cache_OGL_texture( &key, tex_id, flags );
+	}
+	/*	and nuke the image data	*/
+	SOIL_free_image_data( img );
+	/*	and return the handle, such as it is	*/
+	return tex_id;
+}
+
+/*	Reads every level of the texture back and stores it in the cache as
+	a DDS file, in a form SOIL_direct_load_DDS_from_memory gives back the
+	same way.  Other internal formats are not cached.	*/
+static void
+	SOIL_internal_cache_OGL_texture
+	(
+		const texture_cache_key *key,
+		unsigned int tex_id,
+		unsigned int flags
+	)
+{
+#if !defined( SOIL_GLES1 ) && !defined( SOIL_GLES2 )
+	/*	variables	*/
+	DDS_header header;
+	DDS_header_DXT10 header_DXT10;
+	GLint width, height, internal_format;
+	GLint pack_aligment;
+	GLenum pixel_format = 0;
+	int block_size = 0;
+	int DXGI_format = 0;
+	int header_size = sizeof( DDS_header );
+	int levels = 1;
+	int DDS_size = 0;
+	int level, offset;
+	unsigned char *DDS_data;
+
+	glBindTexture( GL_TEXTURE_2D, tex_id );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format );
+	if( (width < 1) || (height < 1) )
+	{
+		return;
+	}
+	memset( &header, 0, sizeof( DDS_header ) );
+	memset( &header_DXT10, 0, sizeof( DDS_header_DXT10 ) );
+	header.sPixelFormat.dwFlags = DDPF_FOURCC;
+	switch( internal_format )
+	{
+	case SOIL_RGB_S3TC_DXT1:
+	case SOIL_RGBA_S3TC_DXT1:
+		header.sPixelFormat.dwFourCC = SOIL_FOURCC( 'D', 'X', 'T', '1' );
+		block_size = 8;
+		break;
+	case SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		DXGI_format = DXGI_FORMAT_BC1_UNORM_SRGB;
+		block_size = 8;
+		break;
+	case SOIL_RGBA_S3TC_DXT5:
+		header.sPixelFormat.dwFourCC = SOIL_FOURCC( 'D', 'X', 'T', '5' );
+		block_size = 16;
+		break;
+	case SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		DXGI_format = DXGI_FORMAT_BC3_UNORM_SRGB;
+		block_size = 16;
+		break;
+	case SOIL_COMPRESSED_RED_RGTC1:
+		header.sPixelFormat.dwFourCC = SOIL_FOURCC( 'A', 'T', 'I', '1' );
+		block_size = 8;
+		break;
+	case SOIL_COMPRESSED_RG_RGTC2:
+		header.sPixelFormat.dwFourCC = SOIL_FOURCC( 'A', 'T', 'I', '2' );
+		block_size = 16;
+		break;
+	case SOIL_COMPRESSED_RGBA_BPTC_UNORM:
+		DXGI_format = DXGI_FORMAT_BC7_UNORM;
+		block_size = 16;
+		break;
+	case SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		DXGI_format = DXGI_FORMAT_BC7_UNORM_SRGB;
+		block_size = 16;
+		break;
+	case GL_LUMINANCE:
+	case GL_LUMINANCE8:
+		pixel_format = GL_LUMINANCE;
+		block_size = 1;
+		header.sPixelFormat.dwFlags = DDPF_LUMINANCE;
+		break;
+	case GL_RGB:
+	case GL_RGB8:
+		pixel_format = GL_RGB;
+		block_size = 3;
+		header.sPixelFormat.dwFlags = DDPF_RGB;
+		break;
+	case GL_RGBA:
+	case GL_RGBA8:
+		pixel_format = GL_RGBA;
+		block_size = 4;
+		header.sPixelFormat.dwFlags = DDPF_RGB | DDPF_ALPHAPIXELS;
+		header.sPixelFormat.dwAlphaBitMask = 0xff000000;
+		break;
+	default:
+		/*	the DDS loader would not give this one back as it is	*/
+		return;
+	}
+	if( DXGI_format )
+	{
+		header.sPixelFormat.dwFourCC = SOIL_FOURCC( 'D', 'X', '1', '0' );
+		header_DXT10.dxgiFormat = DXGI_format;
+		header_DXT10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+		header_DXT10.arraySize = 1;
+		header_size += sizeof( DDS_header_DXT10 );
+	}
+	if( pixel_format )
+	{
+		/*	R in the lowest byte, so the loader does not swap it	*/
+		header.sPixelFormat.dwRGBBitCount = 8 * block_size;
+		header.sPixelFormat.dwRBitMask = 0x000000ff;
+		header.sPixelFormat.dwGBitMask = (block_size > 1) ? 0x0000ff00 : 0;
+		header.sPixelFormat.dwBBitMask = (block_size > 1) ? 0x00ff0000 : 0;
+	} else
+	{
+		/*	compressed levels need the glGetCompressedTexImage of GL 1.3	*/
+		if( NULL == soilGlGetCompressedTexImage )
+		{
+			soilGlGetCompressedTexImage = (P_SOIL_GLGETCOMPRESSEDTEXIMAGEPROC)SOIL_GL_GetProcAddress( "glGetCompressedTexImage" );
+		}
+		if( NULL == soilGlGetCompressedTexImage )
+		{
+			return;
+		}
+	}
+	/*	the full chain, down to 1x1, as createMipmaps makes it	*/
+	if( flags & (SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS) )
+	{
+		for( level = (width > height) ? width : height; level > 1; level >>= 1 )
+		{
+			++levels;
+		}
+	}
+	/*	the level sizes, the same way the DDS loader computes them	*/
+	for( level = 0; level < levels; ++level )
+	{
+		int w = (width >> level) > 0 ? (width >> level) : 1;
+		int h = (height >> level) > 0 ? (height >> level) : 1;
+		DDS_size += pixel_format ? w*h*block_size : ((w+3)/4)*((h+3)/4)*block_size;
+	}
+	DDS_data = (unsigned char*)malloc( header_size + DDS_size );
+	if( NULL == DDS_data )
+	{
+		return;
+	}
+	header.dwMagic = SOIL_FOURCC( 'D', 'D', 'S', ' ' );
+	header.dwSize = 124;
+	header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+	header.dwFlags |= pixel_format ? DDSD_PITCH : DDSD_LINEARSIZE;
+	header.dwWidth = width;
+	header.dwHeight = height;
+	header.dwPitchOrLinearSize = pixel_format ? width*block_size : ((width+3)/4)*((height+3)/4)*block_size;
+	header.sPixelFormat.dwSize = 32;
+	header.sCaps.dwCaps1 = DDSCAPS_TEXTURE;
+	if( levels > 1 )
+	{
+		header.dwFlags |= DDSD_MIPMAPCOUNT;
+		header.dwMipMapCount = levels;
+		header.sCaps.dwCaps1 |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+	}
+	memcpy( DDS_data, &header, sizeof( DDS_header ) );
+	if( DXGI_format )
+	{
+		memcpy( DDS_data + sizeof( DDS_header ), &header_DXT10, sizeof( DDS_header_DXT10 ) );
+	}
+	/*	read back each level	*/
+	glGetIntegerv( GL_PACK_ALIGNMENT, &pack_aligment );
+	if ( 1 != pack_aligment )
+	{
+		glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	}
+	offset = header_size;
+	for( level = 0; level < levels; ++level )
+	{
+		int w = (width >> level) > 0 ? (width >> level) : 1;
+		int h = (height >> level) > 0 ? (height >> level) : 1;
+		if( pixel_format )
+		{
+			glGetTexImage( GL_TEXTURE_2D, level, pixel_format, GL_UNSIGNED_BYTE, DDS_data + offset );
+			offset += w*h*block_size;
+		} else
+		{
+			soilGlGetCompressedTexImage( GL_TEXTURE_2D, level, DDS_data + offset );
+			offset += ((w+3)/4)*((h+3)/4)*block_size;
+		}
+	}
+	if ( 1 != pack_aligment )
+	{
+		glPixelStorei( GL_PACK_ALIGNMENT, pack_aligment );
+	}
+	/*	a missing level or a failed read back is not worth keeping	*/
+	if( glGetError() == GL_NO_ERROR )
+	{
+		texture_cache_write( key, DDS_data, header_size + DDS_size );
+	}
+	SOIL_free_image_data( DDS_data );
+#endif
+}
+
 unsigned int
 	SOIL_load_OGL_cubemap
 	(
@@ -1045,6 +1542,16 @@ unsigned int
 		}
 	}
 
+	if ( flags & SOIL_FLAG_KTX_LOAD_DIRECT )
+	{
+		tex_id = SOIL_direct_load_KTX( filename, reuse_texture_ID, flags, 1 );
+		if( tex_id )
+		{
+			/*	hey, it worked!!	*/
+			return tex_id;
+		}
+	}
+
 	if ( flags & SOIL_FLAG_ETC1_LOAD_DIRECT )
 	{
 		return 0;
@@ -1151,6 +1658,18 @@ unsigned int
 		}
 	}
 
+	if ( flags & SOIL_FLAG_KTX_LOAD_DIRECT )
+	{
+		tex_id = SOIL_direct_load_KTX_from_memory(
+				buffer, buffer_length,
+				reuse_texture_ID, flags, 1 );
+		if ( tex_id )
+		{
+			/*	hey, it worked!!	*/
+			return tex_id;
+		}
+	}
+
 	if ( flags & SOIL_FLAG_ETC1_LOAD_DIRECT )
 	{
 		return 0;
@@ -1362,7 +1881,8 @@ static void createMipmaps(const unsigned char *const img,
 		unsigned int opengl_texture_target,
 		unsigned int internal_texture_format,
 		unsigned int original_texture_format,
-		int DXT_mode)
+		int DXT_mode,
+		int compression)
 {
 	if ( ( flags & SOIL_FLAG_GL_MIPMAPS ) && query_gen_mipmap_capability() == SOIL_CAPABILITY_PRESENT )
 	{
@@ -1370,36 +1890,40 @@ static void createMipmaps(const unsigned char *const img,
 	}
 	else
 	{
+		/*	each level is halved from the previous one instead of
+			the full image, the levels take turns in the two
+			parts of one scratch buffer	*/
 		int MIPlevel = 1;
-		int MIPwidth = (width+1) / 2;
-		int MIPheight = (height+1) / 2;
-		unsigned char *resampled = (unsigned char*)malloc( channels*MIPwidth*MIPheight );
-
-		while( ((1<<MIPlevel) <= width) || ((1<<MIPlevel) <= height) )
+		int MIPwidth = width;
+		int MIPheight = height;
+		int level1_width = (width > 1) ? width / 2 : 1;
+		int level1_height = (height > 1) ? height / 2 : 1;
+		int level1_size = channels*level1_width*level1_height;
+		int level2_size = channels*((level1_width > 1) ? level1_width / 2 : 1)*((level1_height > 1) ? level1_height / 2 : 1);
+		unsigned char *scratch = (unsigned char*)malloc( level1_size + level2_size );
+		const unsigned char *source = img;
+		unsigned char *resampled = scratch;
+
+		if( NULL == scratch )
+		{
+			return;
+		}
+		while( (MIPwidth > 1) || (MIPheight > 1) )
 		{
 			/*	do this MIPmap level	*/
-			mipmap_image(
-					img, width, height, channels,
-					resampled,
-					(1 << MIPlevel), (1 << MIPlevel) );
+			mipmap_image_half(
+					source, MIPwidth, MIPheight, channels,
+					resampled );
+			MIPwidth = (MIPwidth > 1) ? MIPwidth / 2 : 1;
+			MIPheight = (MIPheight > 1) ? MIPheight / 2 : 1;
 
 			/*  upload the MIPmaps	*/
 			if( DXT_mode == SOIL_CAPABILITY_PRESENT )
 			{
-				/*	user wants me to do the DXT conversion!	*/
+				/*	user wants me to do the DXT (or BC4 / BC5 / BC7) conversion!	*/
 				int DDS_size;
-				unsigned char *DDS_data = NULL;
-				if( (channels & 1) == 1 )
-				{
-					/*	RGB, use DXT1	*/
-					DDS_data = convert_image_to_DXT1(
-							resampled, MIPwidth, MIPheight, channels, &DDS_size );
-				} else
-				{
-					/*	RGBA, use DXT5	*/
-					DDS_data = convert_image_to_DXT5(
-							resampled, MIPwidth, MIPheight, channels, &DDS_size );
-				}
+				unsigned char *DDS_data = convert_image_to_DDS_compression(
+						resampled, MIPwidth, MIPheight, channels, compression, &DDS_size );
 				if( DDS_data )
 				{
 					soilGlCompressedTexImage2D(
@@ -1428,11 +1952,11 @@ static void createMipmaps(const unsigned char *const img,
 			}
 			/*	prep for the next level	*/
 			++MIPlevel;
-			MIPwidth = (MIPwidth + 1) / 2;
-			MIPheight = (MIPheight + 1) / 2;
+			source = resampled;
+			resampled = (resampled == scratch) ? scratch + level1_size : scratch;
 		}
 
-		SOIL_free_image_data( resampled );
+		SOIL_free_image_data( scratch );
 	}
 }
 
@@ -1453,6 +1977,7 @@ unsigned int
 	unsigned int tex_id;
 	unsigned int internal_texture_format = 0, original_texture_format = 0;
 	int DXT_mode = SOIL_CAPABILITY_UNKNOWN;
+	int compression = DDS_COMPRESSION_DXT;
 	int sRGB_texture = query_sRGB_capability() == SOIL_CAPABILITY_PRESENT && ( flags & SOIL_FLAG_SRGB_COLOR_SPACE );;
 	int max_supported_size;
 	int iwidth = *width;
@@ -1667,8 +2192,30 @@ unsigned int
 			break;
 		}
 		internal_texture_format = original_texture_format;
+		/*	does the user want me to, and can I, save as BC7, BC5 or BC4?	*/
+		if( (flags & SOIL_FLAG_COMPRESS_TO_BC7) &&
+			(query_BPTC_capability() == SOIL_CAPABILITY_PRESENT) )
+		{
+			DXT_mode = SOIL_CAPABILITY_PRESENT;
+			compression = DDS_COMPRESSION_BC7;
+			internal_texture_format = sRGB_texture ? SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : SOIL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+		else if( (flags & SOIL_FLAG_COMPRESS_TO_BC5) &&
+			(query_RGTC_capability() == SOIL_CAPABILITY_PRESENT) )
+		{
+			DXT_mode = SOIL_CAPABILITY_PRESENT;
+			compression = DDS_COMPRESSION_BC5;
+			internal_texture_format = SOIL_COMPRESSED_RG_RGTC2;
+		}
+		else if( (flags & SOIL_FLAG_COMPRESS_TO_BC4) &&
+			(query_RGTC_capability() == SOIL_CAPABILITY_PRESENT) )
+		{
+			DXT_mode = SOIL_CAPABILITY_PRESENT;
+			compression = DDS_COMPRESSION_BC4;
+			internal_texture_format = SOIL_COMPRESSED_RED_RGTC1;
+		}
 		/*	does the user want me to, and can I, save as DXT?	*/
-		if( flags & SOIL_FLAG_COMPRESS_TO_DXT )
+		else if( flags & SOIL_FLAG_COMPRESS_TO_DXT )
 		{
 			DXT_mode = query_DXT_capability();
 			if( DXT_mode == SOIL_CAPABILITY_PRESENT )
@@ -1712,18 +2259,10 @@ unsigned int
 		/*  upload the main image	*/
 		if( DXT_mode == SOIL_CAPABILITY_PRESENT )
 		{
-			/*	user wants me to do the DXT conversion!	*/
+			/*	user wants me to do the DXT (or BC4 / BC5 / BC7) conversion!	*/
 			int DDS_size;
-			unsigned char *DDS_data = NULL;
-			if( (channels & 1) == 1 )
-			{
-				/*	RGB, use DXT1	*/
-				DDS_data = convert_image_to_DXT1( NULL != img ? img : data, iwidth, iheight, channels, &DDS_size );
-			} else
-			{
-				/*	RGBA, use DXT5	*/
-				DDS_data = convert_image_to_DXT5( NULL != img ? img : data, iwidth, iheight, channels, &DDS_size );
-			}
+			unsigned char *DDS_data = convert_image_to_DDS_compression(
+					NULL != img ? img : data, iwidth, iheight, channels, compression, &DDS_size );
 			if( DDS_data )
 			{
 				soilGlCompressedTexImage2D(
@@ -1758,7 +2297,7 @@ unsigned int
 		/*	are any MIPmaps desired?	*/
 		if( flags & SOIL_FLAG_MIPMAPS || flags & SOIL_FLAG_GL_MIPMAPS )
 		{
-			createMipmaps( NULL != img ? img : data, iwidth, iheight, channels, flags, opengl_texture_target, internal_texture_format, original_texture_format, DXT_mode );
+			createMipmaps( NULL != img ? img : data, iwidth, iheight, channels, flags, opengl_texture_target, internal_texture_format, original_texture_format, DXT_mode, compression );
 
 			/*	instruct OpenGL to use the MIPmaps	*/
 			glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
@@ -1975,6 +2514,21 @@ int
 		save_result = save_image_as_DDS( filename,
 				width, height, channels, (const unsigned char *const)data );
 	} else
+	if( image_type == SOIL_SAVE_TYPE_DDS_BC4 )
+	{
+		save_result = save_image_as_DDS_compressed( filename,
+				width, height, channels, (const unsigned char *const)data, DDS_COMPRESSION_BC4 );
+	} else
+	if( image_type == SOIL_SAVE_TYPE_DDS_BC5 )
+	{
+		save_result = save_image_as_DDS_compressed( filename,
+				width, height, channels, (const unsigned char *const)data, DDS_COMPRESSION_BC5 );
+	} else
+	if( image_type == SOIL_SAVE_TYPE_DDS_BC7 )
+	{
+		save_result = save_image_as_DDS_compressed( filename,
+				width, height, channels, (const unsigned char *const)data, DDS_COMPRESSION_BC7 );
+	} else
 	if( image_type == SOIL_SAVE_TYPE_PNG )
 	{
 		save_result = stbi_write_png( filename,
@@ -1983,6 +2537,11 @@ int
 	if ( image_type == SOIL_SAVE_TYPE_JPG )
 	{
 		save_result = jo_write_jpg( filename, (const void*)data, width, height, channels, quality );
+	} else
+	if( image_type == SOIL_SAVE_TYPE_QOI )
+	{
+		save_result = save_image_as_QOI( filename,
+				width, height, channels, (const unsigned char *const)data );
 	}
 	else
 	{
@@ -2018,6 +2577,26 @@ const char*
 	return result_string_pointer;
 }
 
+/*	a writable copy of the image data of a DDS face, reusing copy	*/
+static unsigned char*
+	SOIL_internal_copy_DDS_data
+	(
+		unsigned char *copy,
+		const unsigned char *const data,
+		unsigned int size
+	)
+{
+	if( NULL == copy )
+	{
+		copy = (unsigned char*)malloc( size );
+	}
+	if( NULL != copy )
+	{
+		memcpy( (void*)copy, (const void*)data, size );
+	}
+	return copy;
+}
+
 unsigned int SOIL_direct_load_DDS_from_memory(
 		const unsigned char *const buffer,
 		int buffer_length,
@@ -2031,7 +2610,8 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	unsigned int tex_ID = 0;
 	/*	file reading variables	*/
 	unsigned int S3TC_type = 0;
-	unsigned char *DDS_data;
+	const unsigned char *DDS_data;
+	unsigned char *DDS_converted = NULL;
 	unsigned int DDS_main_size;
 	unsigned int DDS_full_size;
 	unsigned int width, height;
@@ -2040,6 +2620,10 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	unsigned int cf_target, ogl_target_start, ogl_target_end;
 	unsigned int opengl_texture_type;
 	unsigned int format_type = GL_UNSIGNED_BYTE;
+	DDS_header_DXT10 header_DXT10;
+	unsigned int fourCC;
+	int sRGB_format = 0;
+	GLint unpack_aligment;
 	int i;
 	/*	1st off, does the filename even exist?	*/
 	if( NULL == buffer )
@@ -2075,12 +2659,63 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	if( (header.sPixelFormat.dwFlags & flag) == 0 ) {goto quick_exit;}
 	if( header.sPixelFormat.dwSize != 32 ) {goto quick_exit;}
 	if( (header.sCaps.dwCaps1 & DDSCAPS_TEXTURE) == 0 ) {goto quick_exit;}
+	/*	the DX10 extension header names the format instead of the FourCC,
+		map it to the FourCC of the same blocks	*/
+	fourCC = header.sPixelFormat.dwFourCC;
+	if( (header.sPixelFormat.dwFlags & DDPF_FOURCC) && (fourCC == SOIL_FOURCC( 'D', 'X', '1', '0' )) )
+	{
+		if( buffer_length < (int)(sizeof( DDS_header ) + sizeof( DDS_header_DXT10 )) ) {goto quick_exit;}
+		memcpy ( (void*)(&header_DXT10), (const void *)(&buffer[buffer_index]), sizeof( DDS_header_DXT10 ) );
+		buffer_index += sizeof( DDS_header_DXT10 );
+		if( header_DXT10.arraySize > 1 ) {goto quick_exit;}
+		switch( header_DXT10.dxgiFormat )
+		{
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			sRGB_format = 1;
+			/*	fall through	*/
+		case DXGI_FORMAT_BC1_UNORM:
+			fourCC = SOIL_FOURCC( 'D', 'X', 'T', '1' );
+			break;
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+			sRGB_format = 1;
+			/*	fall through	*/
+		case DXGI_FORMAT_BC2_UNORM:
+			fourCC = SOIL_FOURCC( 'D', 'X', 'T', '3' );
+			break;
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+			sRGB_format = 1;
+			/*	fall through	*/
+		case DXGI_FORMAT_BC3_UNORM:
+			fourCC = SOIL_FOURCC( 'D', 'X', 'T', '5' );
+			break;
+		case DXGI_FORMAT_BC4_UNORM:
+			fourCC = SOIL_FOURCC( 'A', 'T', 'I', '1' );
+			break;
+		case DXGI_FORMAT_BC5_UNORM:
+			fourCC = SOIL_FOURCC( 'A', 'T', 'I', '2' );
+			break;
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			sRGB_format = 1;
+			/*	fall through	*/
+		case DXGI_FORMAT_BC7_UNORM:
+			/*	not a real FourCC, BC7 has none	*/
+			fourCC = SOIL_FOURCC( 'B', 'C', '7', ' ' );
+			break;
+		default:
+			goto quick_exit;
+		}
+	}
 	/*	make sure it is a type we can upload	*/
 	if( (header.sPixelFormat.dwFlags & DDPF_FOURCC) &&
 		!(
-		(header.sPixelFormat.dwFourCC == (('D'<<0)|('X'<<8)|('T'<<16)|('1'<<24))) ||
-		(header.sPixelFormat.dwFourCC == (('D'<<0)|('X'<<8)|('T'<<16)|('3'<<24))) ||
-		(header.sPixelFormat.dwFourCC == (('D'<<0)|('X'<<8)|('T'<<16)|('5'<<24)))
+		(fourCC == SOIL_FOURCC( 'D', 'X', 'T', '1' )) ||
+		(fourCC == SOIL_FOURCC( 'D', 'X', 'T', '3' )) ||
+		(fourCC == SOIL_FOURCC( 'D', 'X', 'T', '5' )) ||
+		(fourCC == SOIL_FOURCC( 'A', 'T', 'I', '1' )) ||
+		(fourCC == SOIL_FOURCC( 'B', 'C', '4', 'U' )) ||
+		(fourCC == SOIL_FOURCC( 'A', 'T', 'I', '2' )) ||
+		(fourCC == SOIL_FOURCC( 'B', 'C', '5', 'U' )) ||
+		(fourCC == SOIL_FOURCC( 'B', 'C', '7', ' ' ))
 		) )
 	{
 		goto quick_exit;
@@ -2150,6 +2785,37 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 			}
 		}
 		DDS_main_size = width * height * block_size;
+	} else if( (fourCC == SOIL_FOURCC( 'A', 'T', 'I', '1' )) || (fourCC == SOIL_FOURCC( 'B', 'C', '4', 'U' )) ||
+			   (fourCC == SOIL_FOURCC( 'A', 'T', 'I', '2' )) || (fourCC == SOIL_FOURCC( 'B', 'C', '5', 'U' )) )
+	{
+		/*	BC4 / BC5 are the RGTC formats	*/
+		if( query_RGTC_capability() != SOIL_CAPABILITY_PRESENT )
+		{
+			/*	we can't do it!	*/
+			result_string_pointer = "Direct upload of RGTC images not supported by the OpenGL driver";
+			return 0;
+		}
+		if( (fourCC == SOIL_FOURCC( 'A', 'T', 'I', '1' )) || (fourCC == SOIL_FOURCC( 'B', 'C', '4', 'U' )) )
+		{
+			S3TC_type = SOIL_COMPRESSED_RED_RGTC1;
+			block_size = 8;
+		} else
+		{
+			S3TC_type = SOIL_COMPRESSED_RG_RGTC2;
+			block_size = 16;
+		}
+		DDS_main_size = ((width+3)>>2)*((height+3)>>2)*block_size;
+	} else if( fourCC == SOIL_FOURCC( 'B', 'C', '7', ' ' ) )
+	{
+		if( query_BPTC_capability() != SOIL_CAPABILITY_PRESENT )
+		{
+			/*	we can't do it!	*/
+			result_string_pointer = "Direct upload of BPTC images not supported by the OpenGL driver";
+			return 0;
+		}
+		S3TC_type = sRGB_format ? SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : SOIL_COMPRESSED_RGBA_BPTC_UNORM;
+		block_size = 16;
+		DDS_main_size = ((width+3)>>2)*((height+3)>>2)*block_size;
 	} else
 	{
 		/*	can we even handle direct uploading to OpenGL DXT compressed images?	*/
@@ -2159,19 +2825,24 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 			result_string_pointer = "Direct upload of S3TC images not supported by the OpenGL driver";
 			return 0;
 		}
+		/*	sRGB only comes from a DX10 header	*/
+		if( sRGB_format && (query_sRGB_capability() != SOIL_CAPABILITY_PRESENT) )
+		{
+			sRGB_format = 0;
+		}
 		/*	well, we know it is DXT1/3/5, because we checked above	*/
-		switch( (header.sPixelFormat.dwFourCC >> 24) - '0' )
+		switch( (fourCC >> 24) - '0' )
 		{
 		case 1:
-			S3TC_type = SOIL_RGBA_S3TC_DXT1;
+			S3TC_type = sRGB_format ? SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : SOIL_RGBA_S3TC_DXT1;
 			block_size = 8;
 			break;
 		case 3:
-			S3TC_type = SOIL_RGBA_S3TC_DXT3;
+			S3TC_type = sRGB_format ? SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT : SOIL_RGBA_S3TC_DXT3;
 			block_size = 16;
 			break;
 		case 5:
-			S3TC_type = SOIL_RGBA_S3TC_DXT5;
+			S3TC_type = sRGB_format ? SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : SOIL_RGBA_S3TC_DXT5;
 			block_size = 16;
 			break;
 		}
@@ -2241,8 +2912,7 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		mipmaps = 0;
 		DDS_full_size = DDS_main_size;
 	}
-	DDS_data = (unsigned char*)malloc( DDS_full_size );
-	/*	got the image data RAM, create or use an existing OpenGL texture handle	*/
+	/*	create or use an existing OpenGL texture handle	*/
 	tex_ID = reuse_texture_ID;
 	if( tex_ID == 0 )
 	{
@@ -2250,32 +2920,44 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	}
 	/*  bind an OpenGL texture ID	*/
 	glBindTexture( opengl_texture_type, tex_ID );
+	/*	uncompressed rows are tightly packed	*/
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpack_aligment );
+	if ( 1 != unpack_aligment )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	}
 	/*	do this for each face of the cubemap!	*/
 	for( cf_target = ogl_target_start; cf_target <= ogl_target_end; ++cf_target )
 	{
 		if( buffer_index + DDS_full_size <= (unsigned int)buffer_length )
 		{
 			unsigned int byte_offset = DDS_main_size;
-			memcpy( (void*)DDS_data, (const void*)(&buffer[buffer_index]), DDS_full_size );
+			/*	the levels go to OpenGL straight from the buffer (which may be
+				a mapped file), only the pixel formats GL can't take as they
+				are get converted, in a copy	*/
+			DDS_data = &buffer[buffer_index];
 			buffer_index += DDS_full_size;
 			/*	upload the main chunk	*/
 			if( uncompressed )
 			{
 				if ( (header.sPixelFormat.dwRBitMask == 0xff0000) && ( ( block_size == 3 && S3TC_type == GL_RGB ) || ( block_size == 4 && S3TC_type == GL_RGBA ) ) )
 				{
+					DDS_converted = SOIL_internal_copy_DDS_data( DDS_converted, DDS_data, DDS_full_size );
 					for( i = 0; i < (int)DDS_full_size; i += block_size )
 					{
-						unsigned char temp = DDS_data[i];
-						DDS_data[i] = DDS_data[i+2];
-						DDS_data[i+2] = temp;
+						unsigned char temp = DDS_converted[i];
+						DDS_converted[i] = DDS_converted[i+2];
+						DDS_converted[i+2] = temp;
 					}
+					DDS_data = DDS_converted;
 				} else if ( block_size == 2 &&
 							(header.sPixelFormat.dwRBitMask == 0xf800 || header.sPixelFormat.dwRBitMask == 0x7c00) )
 				{
 					// convert to R5G5B5A1
+					DDS_converted = SOIL_internal_copy_DDS_data( DDS_converted, DDS_data, DDS_full_size );
 					for( i = 0; i < (int)DDS_full_size; i += block_size )
 					{
-						unsigned short pixel = DDS_data[i] << 0 | DDS_data[i+1] << 8;
+						unsigned short pixel = DDS_converted[i] << 0 | DDS_converted[i+1] << 8;
 						char r = ((pixel & header.sPixelFormat.dwRBitMask) >> 10);
 						char g = ((pixel & header.sPixelFormat.dwGBitMask) >> 5);
 						char b = ((pixel & header.sPixelFormat.dwBBitMask) >> 0);
@@ -2284,26 +2966,29 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 							a = (pixel & header.sPixelFormat.dwAlphaBitMask) >> 15;
 						}
 						unsigned short pixel_new = (r << 11) | (g << 6) | (b << 1) | a;
-						DDS_data[i] = (pixel_new >> 0) & 0xff;
-						DDS_data[i+1] = (pixel_new >> 8) & 0xff;
+						DDS_converted[i] = (pixel_new >> 0) & 0xff;
+						DDS_converted[i+1] = (pixel_new >> 8) & 0xff;
 					}
+					DDS_data = DDS_converted;
 				} else if ( block_size == 2 &&
 							(header.sPixelFormat.dwRBitMask == 0xf00) &&
 							(header.sPixelFormat.dwGBitMask == 0xf0) &&
 							(header.sPixelFormat.dwBBitMask == 0xf) &&
 							(header.sPixelFormat.dwAlphaBitMask == 0xf000))
 				{
+					DDS_converted = SOIL_internal_copy_DDS_data( DDS_converted, DDS_data, DDS_full_size );
 					for( i = 0; i < (int)DDS_full_size; i += block_size )
 					{
-						unsigned short pixel = DDS_data[i] << 0 | DDS_data[i+1] << 8;
+						unsigned short pixel = DDS_converted[i] << 0 | DDS_converted[i+1] << 8;
 						char r = ((pixel & header.sPixelFormat.dwRBitMask) >> 8);
 						char g = ((pixel & header.sPixelFormat.dwGBitMask) >> 4);
 						char b = ((pixel & header.sPixelFormat.dwBBitMask) >> 0);
 						char a = ((pixel & header.sPixelFormat.dwAlphaBitMask) >> 12);
 						unsigned short pixel_new = (r << 12) | (g << 8) | (b << 4) | a;
-						DDS_data[i] = (pixel_new >> 0) & 0xff;
-						DDS_data[i+1] = (pixel_new >> 8) & 0xff;
+						DDS_converted[i] = (pixel_new >> 0) & 0xff;
+						DDS_converted[i+1] = (pixel_new >> 8) & 0xff;
 					}
+					DDS_data = DDS_converted;
 				}
 				glTexImage2D(
 					cf_target, 0,
@@ -2359,7 +3044,11 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 			result_string_pointer = "DDS file was too small for expected image data";
 		}
 	}/* end reading each face */
-	SOIL_free_image_data( DDS_data );
+	if ( 1 != unpack_aligment )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, unpack_aligment );
+	}
+	SOIL_free_image_data( DDS_converted );
 	if( tex_ID )
 	{
 		/*	did I have MIPmaps?	*/
@@ -2401,9 +3090,7 @@ unsigned int SOIL_direct_load_DDS(
 		int flags,
 		int loading_as_cubemap )
 {
-	FILE *f;
-	unsigned char *buffer;
-	size_t buffer_length, bytes_read;
+	file_map map;
 	unsigned int tex_ID = 0;
 	/*	error checks	*/
 	if( NULL == filename )
@@ -2411,35 +3098,18 @@ unsigned int SOIL_direct_load_DDS(
 		result_string_pointer = "NULL filename";
 		return 0;
 	}
-	f = fopen( filename, "rb" );
-	if( NULL == f )
+	/*	the file is mapped, the levels go to OpenGL straight from it	*/
+	if( !SOIL_internal_map_file( filename, &map ) )
 	{
 		/*	the file doesn't seem to exist (or be open-able)	*/
 		result_string_pointer = "Can not find DDS file";
 		return 0;
 	}
-	fseek( f, 0, SEEK_END );
-	buffer_length = ftell( f );
-	fseek( f, 0, SEEK_SET );
-	buffer = (unsigned char *) malloc( buffer_length );
-	if( NULL == buffer )
-	{
-		result_string_pointer = "malloc failed";
-		fclose( f );
-		return 0;
-	}
-	bytes_read = fread( (void*)buffer, 1, buffer_length, f );
-	fclose( f );
-	if( bytes_read < buffer_length )
-	{
-		/*	huh?	*/
-		buffer_length = bytes_read;
-	}
 	/*	now try to do the loading	*/
 	tex_ID = SOIL_direct_load_DDS_from_memory(
-		(const unsigned char *const)buffer, (int)buffer_length,
+		map.data, (int)map.length,
 		reuse_texture_ID, flags, loading_as_cubemap );
-	SOIL_free_image_data( buffer );
+	file_map_close( &map );
 	return tex_ID;
 }
 
@@ -2718,9 +3388,7 @@ unsigned int SOIL_direct_load_PVR(
 		int flags,
 		int loading_as_cubemap )
 {
-	FILE *f;
-	unsigned char *buffer;
-	size_t buffer_length, bytes_read;
+	file_map map;
 	unsigned int tex_ID = 0;
 	/*	error checks	*/
 	if( NULL == filename )
@@ -2728,35 +3396,18 @@ unsigned int SOIL_direct_load_PVR(
 		result_string_pointer = "NULL filename";
 		return 0;
 	}
-	f = fopen( filename, "rb" );
-	if( NULL == f )
+	/*	the file is mapped, the levels go to OpenGL straight from it	*/
+	if( !SOIL_internal_map_file( filename, &map ) )
 	{
 		/*	the file doesn't seem to exist (or be open-able)	*/
 		result_string_pointer = "Can not find PVR file";
 		return 0;
 	}
-	fseek( f, 0, SEEK_END );
-	buffer_length = ftell( f );
-	fseek( f, 0, SEEK_SET );
-	buffer = (unsigned char *) malloc( buffer_length );
-	if( NULL == buffer )
-	{
-		result_string_pointer = "malloc failed";
-		fclose( f );
-		return 0;
-	}
-	bytes_read = fread( (void*)buffer, 1, buffer_length, f );
-	fclose( f );
-	if( bytes_read < buffer_length )
-	{
-		/*	huh?	*/
-		buffer_length = bytes_read;
-	}
 	/*	now try to do the loading	*/
 	tex_ID = SOIL_direct_load_PVR_from_memory(
-		(const unsigned char *const)buffer, (int)buffer_length,
+		map.data, (int)map.length,
 		reuse_texture_ID, flags, loading_as_cubemap );
-	SOIL_free_image_data( buffer );
+	file_map_close( &map );
 	return tex_ID;
 }
 
@@ -2855,9 +3506,7 @@ unsigned int SOIL_direct_load_ETC1(const char *filename,
 		unsigned int reuse_texture_ID,
 		int flags )
 {
-	FILE *f;
-	unsigned char *buffer;
-	size_t buffer_length, bytes_read;
+	file_map map;
 	unsigned int tex_ID = 0;
 	/*	error checks	*/
 	if( NULL == filename )
@@ -2865,35 +3514,328 @@ unsigned int SOIL_direct_load_ETC1(const char *filename,
 		result_string_pointer = "NULL filename";
 		return 0;
 	}
-	f = fopen( filename, "rb" );
-	if( NULL == f )
+	/*	the file is mapped, the levels go to OpenGL straight from it	*/
+	if( !SOIL_internal_map_file( filename, &map ) )
 	{
 		/*	the file doesn't seem to exist (or be open-able)	*/
 		result_string_pointer = "Can not find PVR file";
 		return 0;
 	}
-	fseek( f, 0, SEEK_END );
-	buffer_length = ftell( f );
-	fseek( f, 0, SEEK_SET );
-	buffer = (unsigned char *) malloc( buffer_length );
+	/*	now try to do the loading	*/
+	tex_ID = SOIL_direct_load_ETC1_from_memory(
+		map.data, (int)map.length,
+		reuse_texture_ID, flags );
+	file_map_close( &map );
+	return tex_ID;
+}
+
+/*	reads a little endian 32 bit value of a KTX file	*/
+static unsigned int
+	SOIL_internal_KTX_uint
+	(
+		const unsigned char *const data
+	)
+{
+	return (unsigned int)data[0] | ((unsigned int)data[1] << 8) |
+		((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+}
+
+unsigned int SOIL_direct_load_KTX_from_memory(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap )
+{
+	KTX_Info info;
+	unsigned int tex_ID = 0;
+	unsigned int opengl_texture_type;
+	unsigned int length, offset, data, span, face_size, face_stride;
+	unsigned int width, height, depth, level, levels, full_levels, face;
+	int is_compressed, is_cubemap, is_3D, generate_mipmaps;
+	GLint unpack_aligment;
 	if( NULL == buffer )
 	{
-		result_string_pointer = "malloc failed";
-		fclose( f );
+		/*	we can't do it!	*/
+		result_string_pointer = "NULL buffer";
+		return 0;
+	}
+	length = (buffer_length > 0) ? (unsigned int)buffer_length : 0;
+	if( !ktx_read_header( buffer, length, &info ) )
+	{
+		result_string_pointer = "Failed to read a known KTX header";
 		return 0;
 	}
-	bytes_read = fread( (void*)buffer, 1, buffer_length, f );
-	fclose( f );
-	if( bytes_read < buffer_length )
+	is_compressed = (0 == info.glType);
+	/*	can the driver take the blocks as they are?	*/
+	if( is_compressed )
+	{
+		int capability = SOIL_CAPABILITY_NONE;
+		switch( info.format->family )
+		{
+		case KTX_S3TC:
+			capability = query_DXT_capability();
+			if( info.format->sRGB && (query_sRGB_capability() != SOIL_CAPABILITY_PRESENT) )
+			{
+				capability = SOIL_CAPABILITY_NONE;
+			}
+			break;
+		case KTX_RGTC:
+			capability = query_RGTC_capability();
+			break;
+		case KTX_BPTC:
+			capability = query_BPTC_capability();
+			break;
+		case KTX_ETC1:
+			capability = query_ETC1_capability();
+			break;
+		}
+		if( (capability != SOIL_CAPABILITY_PRESENT) || (NULL == soilGlCompressedTexImage2D) )
+		{
+			/*	we can't do it!	*/
+			result_string_pointer = "Direct upload of the KTX compressed format not supported by the OpenGL driver";
+			return 0;
+		}
+	}
+	/*	cubemaps, arrays (of 2D textures or of cubemaps) and 3D textures	*/
+	is_cubemap = (6 == info.faces) && (0 == info.layers);
+	is_3D = 0;
+	if( is_cubemap )
 	{
-		/*	huh?	*/
-		buffer_length = bytes_read;
+		if( !loading_as_cubemap )
+		{
+			result_string_pointer = "KTX image was a cubemap";
+			return 0;
+		}
+		if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
+		{
+			result_string_pointer = "Direct upload of cubemap images not supported by the OpenGL driver";
+			return 0;
+		}
+		opengl_texture_type = SOIL_TEXTURE_CUBE_MAP;
+	} else
+	{
+		if( loading_as_cubemap )
+		{
+			result_string_pointer = "KTX image was not a cubemap";
+			return 0;
+		}
+		opengl_texture_type = GL_TEXTURE_2D;
+		if( info.layers > 0 )
+		{
+			opengl_texture_type = (6 == info.faces) ? SOIL_TEXTURE_CUBE_MAP_ARRAY : SOIL_TEXTURE_2D_ARRAY;
+			is_3D = 1;
+		} else if( info.depth > 0 )
+		{
+			opengl_texture_type = SOIL_TEXTURE_3D;
+			is_3D = 1;
+		}
+	}
+	if( is_3D )
+	{
+		if( NULL == soilGlTexImage3D )
+		{
+			soilGlTexImage3D = (P_SOIL_GLTEXIMAGE3DPROC)SOIL_GL_GetProcAddress( "glTexImage3D" );
+			soilGlCompressedTexImage3D = (P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC)SOIL_GL_GetProcAddress( "glCompressedTexImage3D" );
+		}
+		if( (NULL == soilGlTexImage3D) || (is_compressed && (NULL == soilGlCompressedTexImage3D)) )
+		{
+			result_string_pointer = "Direct upload of array and 3D textures not supported by the OpenGL driver";
+			return 0;
+		}
+	}
+	/*	no levels in the file means the loader makes them	*/
+	levels = (info.levels > 0) ? info.levels : 1;
+	generate_mipmaps = (0 == info.levels) && (query_gen_mipmap_capability() == SOIL_CAPABILITY_PRESENT);
+	if( (2 == info.version) && ((info.dataOffset > length) || (levels > (length - info.dataOffset) / KTX2_LEVEL_SIZE)) )
+	{
+		result_string_pointer = "KTX file was too small for expected image data";
+		return 0;
+	}
+	/*	create or use an existing OpenGL texture handle	*/
+	tex_ID = reuse_texture_ID;
+	if( tex_ID == 0 )
+	{
+		glGenTextures( 1, &tex_ID );
+	}
+	glBindTexture( opengl_texture_type, tex_ID );
+	/*	KTX1 rows are 4 byte aligned, KTX2 rows are tightly packed	*/
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpack_aligment );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, (1 == info.version) ? 4 : 1 );
+	result_string_pointer = "KTX file loaded";
+	offset = info.dataOffset;
+	for( level = 0; level < levels; ++level )
+	{
+		width = info.width >> level;
+		height = info.height >> level;
+		depth = info.depth >> level;
+		if( width < 1 )
+		{
+			width = 1;
+		}
+		if( height < 1 )
+		{
+			height = 1;
+		}
+		if( depth < 1 )
+		{
+			depth = 1;
+		}
+		if( info.layers > 0 )
+		{
+			/*	the layers of a cubemap array are its faces	*/
+			depth = info.layers * info.faces;
+		}
+		/*	find the level: KTX1 has a size before each level, and each
+			face of a (non-array) cubemap is padded to 4 bytes, KTX2 has
+			an index of the levels after the header	*/
+		if( 1 == info.version )
+		{
+			if( (offset > length) || (length - offset < 4) )
+			{
+				result_string_pointer = "KTX file was too small for expected image data";
+				break;
+			}
+			face_size = SOIL_internal_KTX_uint( &buffer[offset] );
+			data = offset + 4;
+			face_stride = (face_size + 3) & ~3u;
+			span = is_cubemap ? face_stride * 6 : face_stride;
+			offset = data + span;
+		} else
+		{
+			const unsigned char *index = &buffer[info.dataOffset + level * KTX2_LEVEL_SIZE];
+			if( (SOIL_internal_KTX_uint( index + 4 ) != 0) || (SOIL_internal_KTX_uint( index + 12 ) != 0) )
+			{
+				result_string_pointer = "KTX file is too large";
+				break;
+			}
+			data = SOIL_internal_KTX_uint( index );
+			span = SOIL_internal_KTX_uint( index + 8 );
+			face_size = is_cubemap ? span / 6 : span;
+			face_stride = face_size;
+		}
+		if( (data > length) || (span > length - data) || (face_size > span) )
+		{
+			result_string_pointer = "KTX file was too small for expected image data";
+			break;
+		}
+		/*	OpenGL reads the size of the level from the pixels, not from the file	*/
+		if( !ktx_level_fits( &info, width, height, depth, face_size ) )
+		{
+			result_string_pointer = "KTX level was smaller than its size, or its pixel format is unknown";
+			break;
+		}
+		/*	the level goes to OpenGL straight from the buffer	*/
+		for( face = 0; face < (is_cubemap ? 6u : 1u); ++face )
+		{
+			unsigned int target = is_cubemap ? SOIL_TEXTURE_CUBE_MAP_POSITIVE_X + face : opengl_texture_type;
+			const unsigned char *pixels = &buffer[data + face * face_stride];
+			if( is_3D && is_compressed )
+			{
+				soilGlCompressedTexImage3D(
+					target, level, info.glInternalFormat,
+					width, height, depth, 0, face_size, pixels );
+			} else if( is_3D )
+			{
+				soilGlTexImage3D(
+					target, level, info.glInternalFormat,
+					width, height, depth, 0,
+					info.glFormat, info.glType, pixels );
+			} else if( is_compressed )
+			{
+				soilGlCompressedTexImage2D(
+					target, level, info.glInternalFormat,
+					width, height, 0, face_size, pixels );
+			} else
+			{
+				glTexImage2D(
+					target, level, info.glInternalFormat,
+					width, height, 0,
+					info.glFormat, info.glType, pixels );
+			}
+		}
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, unpack_aligment );
+	/*	a format the driver doesn't know fails here, and is decoded on the CPU	*/
+	if( (level < levels) || (glGetError() != GL_NO_ERROR) )
+	{
+		if( level == levels )
+		{
+			result_string_pointer = "failed: the OpenGL driver refused the KTX image";
+		}
+		glDeleteTextures( 1, &tex_ID );
+		return 0;
+	}
+	if( generate_mipmaps )
+	{
+		soilGlGenerateMipmap( opengl_texture_type );
+	} else
+	{
+		/*	a shorter chain than down to 1x1 must not make the texture incomplete	*/
+		full_levels = 1;
+		while( ((info.width | info.height | (SOIL_TEXTURE_3D == opengl_texture_type ? info.depth : 0)) >> full_levels) > 0 )
+		{
+			++full_levels;
+		}
+		if( (levels > 1) && (levels < full_levels) )
+		{
+			glTexParameteri( opengl_texture_type, SOIL_TEXTURE_MAX_LEVEL, levels - 1 );
+		}
+	}
+	/*	did I have MIPmaps?	*/
+	if( (levels > 1) || generate_mipmaps )
+	{
+		/*	instruct OpenGL to use the MIPmaps	*/
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+	} else
+	{
+		/*	instruct OpenGL _NOT_ to use the MIPmaps	*/
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+	}
+	/*	does the user want clamping, or wrapping?	*/
+	if( flags & SOIL_FLAG_TEXTURE_REPEATS )
+	{
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, GL_REPEAT );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, GL_REPEAT );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, GL_REPEAT );
+	} else
+	{
+		unsigned int clamp_mode = SOIL_CLAMP_TO_EDGE;
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, clamp_mode );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, clamp_mode );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode );
+	}
+	return tex_ID;
+}
+
+unsigned int SOIL_direct_load_KTX(
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap )
+{
+	file_map map;
+	unsigned int tex_ID = 0;
+	/*	error checks	*/
+	if( NULL == filename )
+	{
+		result_string_pointer = "NULL filename";
+		return 0;
+	}
+	/*	the file is mapped, the levels go to OpenGL straight from it	*/
+	if( !SOIL_internal_map_file( filename, &map ) )
+	{
+		/*	the file doesn't seem to exist (or be open-able)	*/
+		result_string_pointer = "Can not find KTX file";
+		return 0;
 	}
 	/*	now try to do the loading	*/
-	tex_ID = SOIL_direct_load_ETC1_from_memory(
-		(const unsigned char *const)buffer, (int)buffer_length,
-		reuse_texture_ID, flags );
-	SOIL_free_image_data( buffer );
+	tex_ID = SOIL_direct_load_KTX_from_memory(
+		map.data, (int)map.length,
+		reuse_texture_ID, flags, loading_as_cubemap );
+	file_map_close( &map );
 	return tex_ID;
 }
 
@@ -3041,6 +3983,71 @@ int query_DXT_capability( void )
 	return has_DXT_capability;
 }
 
+int query_RGTC_capability( void )
+{
+	/*	check for the capability	*/
+	if( has_RGTC_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		/*	core since OpenGL 3.0, but the drivers list the extension too	*/
+		if (	0 == SOIL_GL_ExtensionSupported(
+					"GL_ARB_texture_compression_rgtc" ) &&
+				0 == SOIL_GL_ExtensionSupported(
+					"GL_EXT_texture_compression_rgtc" ) &&
+				0 == SOIL_GL_ExtensionSupported(
+					"EXT_texture_compression_rgtc" )
+			)
+		{
+			has_RGTC_capability = SOIL_CAPABILITY_NONE;
+		} else
+		{
+			/*	the upload needs glCompressedTexImage2D, as for DXT	*/
+			P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC ext_addr = get_glCompressedTexImage2D_addr();
+
+			if( NULL == ext_addr )
+			{
+				has_RGTC_capability = SOIL_CAPABILITY_NONE;
+			} else
+			{
+				soilGlCompressedTexImage2D = ext_addr;
+				has_RGTC_capability = SOIL_CAPABILITY_PRESENT;
+			}
+		}
+	}
+	return has_RGTC_capability;
+}
+
+int query_BPTC_capability( void )
+{
+	/*	check for the capability	*/
+	if( has_BPTC_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		/*	core since OpenGL 4.2	*/
+		if (	0 == SOIL_GL_ExtensionSupported(
+					"GL_ARB_texture_compression_bptc" ) &&
+				0 == SOIL_GL_ExtensionSupported(
+					"GL_EXT_texture_compression_bptc" ) &&
+				0 == SOIL_GL_ExtensionSupported(
+					"EXT_texture_compression_bptc" )
+			)
+		{
+			has_BPTC_capability = SOIL_CAPABILITY_NONE;
+		} else
+		{
+			P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC ext_addr = get_glCompressedTexImage2D_addr();
+
+			if( NULL == ext_addr )
+			{
+				has_BPTC_capability = SOIL_CAPABILITY_NONE;
+			} else
+			{
+				soilGlCompressedTexImage2D = ext_addr;
+				has_BPTC_capability = SOIL_CAPABILITY_PRESENT;
+			}
+		}
+	}
+	return has_BPTC_capability;
+}
+
 int query_PVR_capability( void )
 {
 	/*	check for the capability	*/
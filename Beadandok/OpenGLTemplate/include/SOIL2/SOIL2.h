@@ -28,6 +28,8 @@
 	- PSD		load
 	- HDR		load
 	- PIC		load
+	- KTX		load (KTX 1.1 and KTX2 without supercompression)
+	- QOI		load & save
 
 	OpenGL Texture Features:
 	- resample to power-of-two sizes
@@ -97,6 +99,12 @@ enum
 	SOIL_FLAG_CoCg_Y: Google YCoCg; RGB=>CoYCg, RGBA=>CoCgAY
 	SOIL_FLAG_TEXTURE_RECTANGE: uses ARB_texture_rectangle ; pixel indexed & no repeat or MIPmaps or cubemaps
 	SOIL_FLAG_PVR_LOAD_DIRECT: will load PVR files directly without _ANY_ additional processing ( if supported )
+	SOIL_FLAG_COMPRESS_TO_BC4: if the card can display them, will convert the first channel to BC4 (RGTC1), sample it as .r
+	SOIL_FLAG_COMPRESS_TO_BC5: if the card can display them, will convert RG (or luminance + alpha) to BC5 (RGTC2), sample it as .rg
+	SOIL_FLAG_COMPRESS_TO_BC7: if the card can display them, will convert to BC7 (BPTC) with the fast encoder
+	SOIL_FLAG_KTX_LOAD_DIRECT: will load KTX / KTX2 files directly, all their MIPmaps, array layers and faces ( if supported )
+	(if more of the compression flags are given, the first one the card supports
+	wins in the order BC7, BC5, BC4, DXT)
 **/
 enum
 {
@@ -113,7 +121,11 @@ enum
 	SOIL_FLAG_PVR_LOAD_DIRECT = 1024,
 	SOIL_FLAG_ETC1_LOAD_DIRECT = 2048,
 	SOIL_FLAG_GL_MIPMAPS = 4096,
-	SOIL_FLAG_SRGB_COLOR_SPACE = 8192
+	SOIL_FLAG_SRGB_COLOR_SPACE = 8192,
+	SOIL_FLAG_COMPRESS_TO_BC4 = 16384,
+	SOIL_FLAG_COMPRESS_TO_BC5 = 32768,
+	SOIL_FLAG_COMPRESS_TO_BC7 = 65536,
+	SOIL_FLAG_KTX_LOAD_DIRECT = 131072
 };
 
 /**
@@ -121,7 +133,10 @@ enum
 	(TGA supports uncompressed RGB / RGBA)
 	(BMP supports uncompressed RGB)
 	(DDS supports DXT1 and DXT5)
+	(DDS_BC4, DDS_BC5 and DDS_BC7 are DDS files in those formats,
+	with the channels as in SOIL_FLAG_COMPRESS_TO_BC4 / BC5 / BC7)
 	(PNG supports RGB / RGBA)
+	(QOI supports RGB / RGBA, lossless and much faster to encode than PNG)
 **/
 enum
 {
@@ -129,7 +144,11 @@ enum
 	SOIL_SAVE_TYPE_BMP = 1,
 	SOIL_SAVE_TYPE_PNG = 2,
 	SOIL_SAVE_TYPE_DDS = 3,
-	SOIL_SAVE_TYPE_JPG = 4
+	SOIL_SAVE_TYPE_JPG = 4,
+	SOIL_SAVE_TYPE_DDS_BC4 = 5,
+	SOIL_SAVE_TYPE_DDS_BC5 = 6,
+	SOIL_SAVE_TYPE_DDS_BC7 = 7,
+	SOIL_SAVE_TYPE_QOI = 8
 };
 
 /**
@@ -254,6 +273,58 @@ unsigned int
 		unsigned int flags
 	);
 
+/**
+	An archive of many image files in one file: a ZIP file whose
+	entries are "stored" (uncompressed, e.g. made with zip -0), as
+	compressed entries can not be uploaded in place, they are left out.
+	The archive is memory mapped once, and each texture is loaded
+	straight from its range of the mapping.
+**/
+typedef struct SOIL_archive SOIL_archive;
+
+/**
+	Opens (maps) an archive and reads its directory.
+	\param filename the name of the ZIP file
+	\return NULL if failed, otherwise the archive, close it with SOIL_close_archive
+**/
+SOIL_archive*
+	SOIL_open_archive
+	(
+		const char *filename
+	);
+
+/**
+	Loads an image of an archive into an OpenGL texture, the same way
+	as SOIL_load_OGL_texture_from_memory (so with SOIL_FLAG_DDS_LOAD_DIRECT,
+	SOIL_FLAG_PVR_LOAD_DIRECT or SOIL_FLAG_ETC1_LOAD_DIRECT the levels go to
+	OpenGL right from the mapped file).  The pages of the image are read
+	ahead before, and released after the upload.
+	\param archive the archive from SOIL_open_archive
+	\param name the path of the image inside the archive, e.g. "textures/wall.dds"
+	\param force_channels 0-image format, 1-luminous, 2-luminous/alpha, 3-RGB, 4-RGBA
+	\param reuse_texture_ID 0-generate a new texture ID, otherwise reuse the texture ID (overwriting the old texture)
+	\param flags can be any of SOIL_FLAG_POWER_OF_TWO | SOIL_FLAG_MIPMAPS | SOIL_FLAG_TEXTURE_REPEATS | SOIL_FLAG_MULTIPLY_ALPHA | SOIL_FLAG_INVERT_Y | SOIL_FLAG_COMPRESS_TO_DXT | SOIL_FLAG_DDS_LOAD_DIRECT
+	\return 0-failed, otherwise returns the OpenGL texture handle
+**/
+unsigned int
+	SOIL_load_OGL_texture_from_archive
+	(
+		const SOIL_archive *archive,
+		const char *name,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	);
+
+/**
+	Unmaps an archive and frees it.
+**/
+void
+	SOIL_close_archive
+	(
+		SOIL_archive *archive
+	);
+
 /**
 	Loads 6 images from memory into an OpenGL cubemap texture.
 	\param x_pos_buffer the image data in RAM to upload as the +x cube face
@@ -427,6 +498,28 @@ int
 		const unsigned char *const data
 	);
 
+/**
+	Turns on the on-disk texture cache of SOIL_load_OGL_texture and
+	SOIL_load_OGL_texture_from_memory.  The key of a texture is a hash
+	of the source file, the flags and force_channels; the value is the
+	finished texture with all of its MIPmaps as a DDS file in directory
+	(which must exist).  A later load of the same key skips decoding,
+	resizing, MIPmapping and DXT compression, and goes straight to
+	SOIL_direct_load_DDS_from_memory.  When the files grow over
+	max_megabytes the least recently used ones are deleted.
+	Textures the DDS path can not give back the same way (texture
+	rectangles, luminance + alpha and uncompressed sRGB) are not cached,
+	and OpenGL ES has no texture read back, so there it does nothing.
+	Pass NULL to turn it off, which also saves the order of the hits.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	SOIL_set_texture_cache
+	(
+		const char *directory,
+		unsigned int max_megabytes
+	);
+
 /**
 	Frees the image data (note, this is just C's "free()"...this function is
 	present mostly so C++ programmers don't forget to use "free()" and call
@@ -463,6 +556,19 @@ int
 		const char *extension
 	);
 
+/**
+	Tells if the current context takes textures compressed as
+	compress_flag asks (SOIL_FLAG_COMPRESS_TO_DXT, SOIL_FLAG_COMPRESS_TO_BC4,
+	SOIL_FLAG_COMPRESS_TO_BC5 or SOIL_FLAG_COMPRESS_TO_BC7), with the same
+	checks SOIL_load_OGL_texture makes before it compresses.
+	eturn 1 if it does, 0 otherwise
+**/
+int
+	SOIL_GL_compression_supported
+	(
+		unsigned int compress_flag
+	);
+
 /** Loads the DDS texture directly to the GPU memory ( if supported ) */
 unsigned int SOIL_direct_load_DDS(
 		const char *filename,
@@ -493,6 +599,27 @@ unsigned int SOIL_direct_load_PVR_from_memory(
 		int flags,
 		int loading_as_cubemap );
 
+/**
+	Loads the KTX / KTX2 texture directly to the GPU memory ( if supported ).
+	Arrays are loaded as GL_TEXTURE_2D_ARRAY (or GL_TEXTURE_CUBE_MAP_ARRAY),
+	3D textures as GL_TEXTURE_3D, bind the returned texture to that target.
+	Fails (so SOIL_load_OGL_texture decodes the first image on the CPU) if
+	the OpenGL context does not support the format.
+**/
+unsigned int SOIL_direct_load_KTX(
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+/** Loads the KTX / KTX2 texture directly to the GPU memory ( if supported ) */
+unsigned int SOIL_direct_load_KTX_from_memory(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
 /** Loads the PVR texture directly to the GPU memory ( if supported ) */
 unsigned int SOIL_direct_load_ETC1(const char *filename,
 		unsigned int reuse_texture_ID,
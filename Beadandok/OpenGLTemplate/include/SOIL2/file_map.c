@@ -0,0 +1,496 @@
+/*
+	File map
+
+	read only memory mapped files and stored ZIP archives
+
+	Public Domain
+*/
+
+#if defined( _WIN32 )
+	#define FILE_MAP_WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined( __unix__ ) || defined( __unix ) || defined( __APPLE__ )
+	#define FILE_MAP_POSIX
+	/*	madvise is not in POSIX proper, and files over 2 GB on 32 bit systems	*/
+	#ifndef _DEFAULT_SOURCE
+	#define _DEFAULT_SOURCE
+	#endif
+	#ifndef _FILE_OFFSET_BITS
+	#define _FILE_OFFSET_BITS 64
+	#endif
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "file_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/********* Mapped Files *********/
+/*	where there is no mapping the file is read into a buffer	*/
+static int
+	file_map_read
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	FILE *f = fopen( filename, "rb" );
+	long length;
+	unsigned char *buffer = NULL;
+	if( NULL == f )
+	{
+		return 0;
+	}
+	fseek( f, 0, SEEK_END );
+	length = ftell( f );
+	fseek( f, 0, SEEK_SET );
+	if( length > 0 )
+	{
+		buffer = (unsigned char*)malloc( length );
+	}
+	if( (NULL != buffer) && (fread( buffer, 1, length, f ) != (size_t)length) )
+	{
+		free( buffer );
+		buffer = NULL;
+	}
+	fclose( f );
+	if( NULL == buffer )
+	{
+		return 0;
+	}
+	map->data = buffer;
+	map->length = (size_t)length;
+	map->mapped = 0;
+	return 1;
+}
+
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	map->data = NULL;
+	map->length = 0;
+	map->mapped = 0;
+	map->handle = NULL;
+	if( NULL == filename )
+	{
+		return 0;
+	}
+#if defined( FILE_MAP_WIN32 )
+	{
+		/*	Windows has no madvise, the sequential hint goes to the file	*/
+		HANDLE file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+		HANDLE mapping = NULL;
+		LARGE_INTEGER size;
+		const void *view = NULL;
+		if( INVALID_HANDLE_VALUE == file )
+		{
+			return 0;
+		}
+		if( GetFileSizeEx( file, &size ) && (size.QuadPart > 0) &&
+			((unsigned __int64)size.QuadPart <= (size_t)-1) )
+		{
+			mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+		}
+		if( NULL != mapping )
+		{
+			view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		}
+		/*	the mapping keeps the file open	*/
+		CloseHandle( file );
+		if( NULL == view )
+		{
+			if( NULL != mapping )
+			{
+				CloseHandle( mapping );
+			}
+			return file_map_read( filename, map );
+		}
+		map->data = (const unsigned char*)view;
+		map->length = (size_t)size.QuadPart;
+		map->mapped = 1;
+		map->handle = mapping;
+		return 1;
+	}
+#elif defined( FILE_MAP_POSIX )
+	{
+		struct stat info;
+		void *view = MAP_FAILED;
+		int fd = open( filename, O_RDONLY );
+		if( fd < 0 )
+		{
+			return 0;
+		}
+		if( (0 == fstat( fd, &info )) && (info.st_size > 0) &&
+			((unsigned long)(info.st_size >> 16 >> 16) <= ((size_t)-1 >> 16 >> 16)) )
+		{
+			view = mmap( NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		}
+		/*	the mapping keeps the file open	*/
+		close( fd );
+		if( MAP_FAILED == view )
+		{
+			return file_map_read( filename, map );
+		}
+		map->data = (const unsigned char*)view;
+		map->length = (size_t)info.st_size;
+		map->mapped = 1;
+		file_map_advise( map, 0, map->length, FILE_MAP_SEQUENTIAL );
+		return 1;
+	}
+#else
+	return file_map_read( filename, map );
+#endif
+}
+
+void
+	file_map_advise
+	(
+		const file_map *map,
+		size_t offset,
+		size_t length,
+		int advice
+	)
+{
+#if defined( FILE_MAP_POSIX )
+	/*	madvise wants a page aligned start	*/
+	size_t page = (size_t)sysconf( _SC_PAGESIZE );
+	size_t start = offset - (offset % page);
+	if( !map->mapped || (offset >= map->length) )
+	{
+		return;
+	}
+	if( length > map->length - offset )
+	{
+		length = map->length - offset;
+	}
+	switch( advice )
+	{
+	case FILE_MAP_SEQUENTIAL:
+		madvise( (void*)(map->data + start), length + (offset - start), MADV_SEQUENTIAL );
+		break;
+	case FILE_MAP_WILLNEED:
+		madvise( (void*)(map->data + start), length + (offset - start), MADV_WILLNEED );
+		break;
+	case FILE_MAP_DONTNEED:
+		/*	only whole pages of the range, a neighbour may still be in use	*/
+		{
+			size_t end = offset + length;
+			start = offset + (page - offset % page) % page;
+			if( end != map->length )
+			{
+				end -= end % page;
+			}
+			if( end > start )
+			{
+				madvise( (void*)(map->data + start), end - start, MADV_DONTNEED );
+			}
+		}
+		break;
+	}
+#else
+	(void)map;
+	(void)offset;
+	(void)length;
+	(void)advice;
+#endif
+}
+
+void
+	file_map_close
+	(
+		file_map *map
+	)
+{
+	if( NULL == map->data )
+	{
+		return;
+	}
+	if( !map->mapped )
+	{
+		free( (void*)map->data );
+	}
+#if defined( FILE_MAP_WIN32 )
+	else
+	{
+		UnmapViewOfFile( map->data );
+		CloseHandle( (HANDLE)map->handle );
+	}
+#elif defined( FILE_MAP_POSIX )
+	else
+	{
+		munmap( (void*)map->data, map->length );
+	}
+#endif
+	map->data = NULL;
+	map->length = 0;
+	map->mapped = 0;
+	map->handle = NULL;
+}
+
+/********* Archives *********/
+#define ZIP_LOCAL_HEADER		0x04034b50u
+#define ZIP_CENTRAL_HEADER		0x02014b50u
+#define ZIP_END_OF_DIRECTORY	0x06054b50u
+#define ZIP64_END_OF_DIRECTORY	0x06064b50u
+#define ZIP64_END_LOCATOR		0x07064b50u
+#define ZIP64_EXTRA_FIELD		0x0001u
+#define ZIP_METHOD_STORED		0
+
+static unsigned int
+	read_u16
+	(
+		const unsigned char *p
+	)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned long
+	read_u32
+	(
+		const unsigned char *p
+	)
+{
+	return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+		((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+/*	a 64 bit field, 0 if failed (does not fit a size_t)	*/
+static int
+	read_u64
+	(
+		const unsigned char *p,
+		size_t *value
+	)
+{
+	unsigned long high = read_u32( p + 4 );
+	if( (high != 0) && (sizeof( size_t ) <= 4) )
+	{
+		return 0;
+	}
+	*value = (size_t)read_u32( p ) | ((size_t)high << 16 << 16);
+	return 1;
+}
+
+static int
+	compare_entries
+	(
+		const void *a,
+		const void *b
+	)
+{
+	return strcmp( ((const file_archive_entry*)a)->name, ((const file_archive_entry*)b)->name );
+}
+
+/*	finds the central directory, from the (ZIP64) end of central directory record	*/
+static int
+	find_central_directory
+	(
+		const file_map *map,
+		size_t *offset,
+		size_t *count
+	)
+{
+	const unsigned char *data = map->data;
+	size_t end;
+	size_t lowest = (map->length > 22 + 65535) ? map->length - (22 + 65535) : 0;
+	if( map->length < 22 )
+	{
+		return 0;
+	}
+	/*	the record is the last thing in the file, before a comment of up to 64 KB	*/
+	for( end = map->length - 22; ; --end )
+	{
+		if( read_u32( data + end ) == ZIP_END_OF_DIRECTORY )
+		{
+			break;
+		}
+		if( end == lowest )
+		{
+			return 0;
+		}
+	}
+	*count = read_u16( data + end + 10 );
+	*offset = read_u32( data + end + 16 );
+	if( ((*count == 0xffff) || (*offset == 0xffffffffu)) && (end >= 20) &&
+		(read_u32( data + end - 20 ) == ZIP64_END_LOCATOR) )
+	{
+		size_t end64;
+		if( (map->length < 56) || !read_u64( data + end - 20 + 8, &end64 ) || (end64 > map->length - 56) ||
+			(read_u32( data + end64 ) != ZIP64_END_OF_DIRECTORY) ||
+			!read_u64( data + end64 + 32, count ) || !read_u64( data + end64 + 48, offset ) )
+		{
+			return 0;
+		}
+	}
+	return *offset < map->length;
+}
+
+int
+	file_archive_open
+	(
+		const char *filename,
+		file_archive *archive
+	)
+{
+	const unsigned char *data;
+	size_t length, position, count, i;
+	archive->entries = NULL;
+	archive->entry_count = 0;
+	if( !file_map_open( filename, &archive->map ) )
+	{
+		return 0;
+	}
+	data = archive->map.data;
+	length = archive->map.length;
+	if( !find_central_directory( &archive->map, &position, &count ) ||
+		(count > (length - position) / 46) )
+	{
+		file_archive_close( archive );
+		return 0;
+	}
+	file_map_advise( &archive->map, position, length - position, FILE_MAP_WILLNEED );
+	archive->entries = (file_archive_entry*)calloc( count + 1, sizeof( file_archive_entry ) );
+	if( NULL == archive->entries )
+	{
+		file_archive_close( archive );
+		return 0;
+	}
+	for( i = 0; i < count; ++i )
+	{
+		const unsigned char *header = data + position;
+		size_t name_length, extra_length, comment_length;
+		size_t size, stored_size, local;
+		if( (position + 46 > length) || (read_u32( header ) != ZIP_CENTRAL_HEADER) )
+		{
+			break;
+		}
+		name_length = read_u16( header + 28 );
+		extra_length = read_u16( header + 30 );
+		comment_length = read_u16( header + 32 );
+		if( position + 46 + name_length + extra_length + comment_length > length )
+		{
+			break;
+		}
+		size = read_u32( header + 24 );
+		stored_size = read_u32( header + 20 );
+		local = read_u32( header + 42 );
+		/*	the ZIP64 extra field has the 64 bit values of the fields that are all ones	*/
+		if( (size == 0xffffffffu) || (stored_size == 0xffffffffu) || (local == 0xffffffffu) )
+		{
+			const unsigned char *extra = header + 46 + name_length;
+			const unsigned char *extra_end = extra + extra_length;
+			while( extra + 4 <= extra_end )
+			{
+				const unsigned char *field = extra + 4;
+				const unsigned char *field_end = field + read_u16( extra + 2 );
+				if( field_end > extra_end )
+				{
+					break;
+				}
+				if( read_u16( extra ) == ZIP64_EXTRA_FIELD )
+				{
+					if( size == 0xffffffffu )
+					{
+						if( (field + 8 > field_end) || !read_u64( field, &size ) )
+						{
+							break;
+						}
+						field += 8;
+					}
+					if( stored_size == 0xffffffffu )
+					{
+						if( (field + 8 > field_end) || !read_u64( field, &stored_size ) )
+						{
+							break;
+						}
+						field += 8;
+					}
+					if( (local == 0xffffffffu) && ((field + 8 > field_end) || !read_u64( field, &local )) )
+					{
+						break;
+					}
+				}
+				extra = field_end;
+			}
+		}
+		/*	compressed entries and directories can't be used in place, they are left out	*/
+		if( (read_u16( header + 10 ) == ZIP_METHOD_STORED) && (size == stored_size) &&
+			(name_length > 0) && (header[46 + name_length - 1] != '/') &&
+			(length >= 30) && (local <= length - 30) && (read_u32( data + local ) == ZIP_LOCAL_HEADER) )
+		{
+			/*	the local header has its own name and extra field lengths	*/
+			size_t start = local + 30 + read_u16( data + local + 26 ) + read_u16( data + local + 28 );
+			file_archive_entry *entry = &archive->entries[archive->entry_count];
+			if( (start <= length) && (size <= length - start) )
+			{
+				entry->name = (char*)malloc( name_length + 1 );
+				if( NULL == entry->name )
+				{
+					break;
+				}
+				memcpy( entry->name, header + 46, name_length );
+				entry->name[name_length] = '\0';
+				entry->offset = start;
+				entry->length = size;
+				++archive->entry_count;
+			}
+		}
+		position += 46 + name_length + extra_length + comment_length;
+	}
+	if( i < count )
+	{
+		/*	a broken directory	*/
+		file_archive_close( archive );
+		return 0;
+	}
+	qsort( archive->entries, archive->entry_count, sizeof( file_archive_entry ), compare_entries );
+	return 1;
+}
+
+const file_archive_entry*
+	file_archive_find
+	(
+		const file_archive *archive,
+		const char *name
+	)
+{
+	file_archive_entry key;
+	if( (NULL == name) || (archive->entry_count < 1) )
+	{
+		return NULL;
+	}
+	key.name = (char*)name;
+	return (const file_archive_entry*)bsearch( &key, archive->entries,
+			archive->entry_count, sizeof( file_archive_entry ), compare_entries );
+}
+
+void
+	file_archive_close
+	(
+		file_archive *archive
+	)
+{
+	int i;
+	if( NULL != archive->entries )
+	{
+		for( i = 0; i < archive->entry_count; ++i )
+		{
+			free( archive->entries[i].name );
+		}
+		free( archive->entries );
+	}
+	archive->entries = NULL;
+	archive->entry_count = 0;
+	file_map_close( &archive->map );
+}
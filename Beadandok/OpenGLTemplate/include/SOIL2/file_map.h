@@ -0,0 +1,140 @@
+/*
+	File map
+
+	read only memory mapped files, so the direct loaders can
+	hand pointers into the file straight to OpenGL, and
+	archives: many files packed into one mapped file
+
+	Public Domain
+*/
+
+#ifndef HEADER_FILE_MAP
+#define HEADER_FILE_MAP
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	A file mapped into memory, or read into a buffer where
+	mapping is not available.
+**/
+typedef struct
+{
+	const unsigned char *data;
+	size_t length;
+	int mapped;
+	void *handle;
+}
+file_map;
+
+/**
+	The access hints of file_map_advise.
+	FILE_MAP_SEQUENTIAL: the range will be read once, front to back
+	FILE_MAP_WILLNEED: the range will be read soon, start reading it ahead
+	FILE_MAP_DONTNEED: the range was read, its pages can leave the process
+**/
+enum
+{
+	FILE_MAP_SEQUENTIAL = 0,
+	FILE_MAP_WILLNEED = 1,
+	FILE_MAP_DONTNEED = 2
+};
+
+/**
+	Maps the whole file read only, and hints that it will be
+	read sequentially.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	);
+
+/**
+	Passes an access hint for a range of the file to the OS
+	(madvise), it does nothing where mapping is not available.
+**/
+void
+	file_map_advise
+	(
+		const file_map *map,
+		size_t offset,
+		size_t length,
+		int advice
+	);
+
+/**
+	Unmaps the file (or frees its buffer).
+**/
+void
+	file_map_close
+	(
+		file_map *map
+	);
+
+/**
+	One file in an archive.
+**/
+typedef struct
+{
+	char *name;
+	size_t offset;
+	size_t length;
+}
+file_archive_entry;
+
+/**
+	An archive is a ZIP file whose entries are "stored"
+	(uncompressed, e.g. zip -0), so each one is a range of the
+	mapped file.  ZIP64 archives (over 4 GB) are read as well.
+**/
+typedef struct
+{
+	file_map map;
+	file_archive_entry *entries;
+	int entry_count;
+}
+file_archive;
+
+/**
+	Maps the archive and reads its central directory, compressed
+	entries and directories are left out.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	file_archive_open
+	(
+		const char *filename,
+		file_archive *archive
+	);
+
+/**
+	Finds an entry by its path inside the archive.
+	\return the entry, or NULL if there is none with that name
+**/
+const file_archive_entry*
+	file_archive_find
+	(
+		const file_archive *archive,
+		const char *name
+	);
+
+/**
+	Frees the entries and unmaps the archive.
+**/
+void
+	file_archive_close
+	(
+		file_archive *archive
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_FILE_MAP	*/
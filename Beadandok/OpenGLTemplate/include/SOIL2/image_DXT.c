@@ -12,6 +12,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*	SSE4.1 and AVX2 kernels for the colour line fit: they are compiled
+	for their own instruction set and picked at runtime by set_DXT_kernel	*/
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define DXT_SIMD
+#define DXT_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define DXT_SIMD
+#define DXT_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
 
 /*	set this =1 if you want to use the covarince matrix method...
 	which is better than my method of using standard deviations
@@ -37,6 +54,82 @@ void compress_DDS_color_block(
 void compress_DDS_alpha_block(
 				const unsigned char *const uncompressed,
 				unsigned char compressed[8] );
+/*
+	Hands the rows of blocks of an image to compress_rows in
+	chunks of DXT_ROWS_PER_CHUNK, on as many threads as
+	set_DXT_thread_count allows (if built with OpenMP).
+*/
+typedef void (*DXT_block_rows_function)(
+				const unsigned char *const uncompressed,
+				int width, int height, int channels,
+				int first_row, int last_row,
+				unsigned char *compressed );
+static void compress_block_rows_in_chunks(
+				DXT_block_rows_function compress_rows,
+				const unsigned char *const uncompressed,
+				int width, int height, int channels,
+				unsigned char *compressed );
+/*
+	Gets the RAM for block_size bytes per 4x4 block of the image
+	and fills it with compress_rows, through the function above.
+*/
+static unsigned char* convert_image_in_block_rows(
+				DXT_block_rows_function compress_rows,
+				int block_size,
+				const unsigned char *const uncompressed,
+				int width, int height, int channels,
+				int *out_size );
+/*
+	Copies the 4x4 block at (x, y) as 16 RGBA pixels, the same way
+	the DXT5 rows do: 1 or 2 channels are grey, no alpha is 255, and
+	the pixels outside the image repeat the first one.
+*/
+static void get_RGBA_block(
+				const unsigned char *const uncompressed,
+				int width, int height, int channels,
+				int x, int y,
+				unsigned char ublock[16*4] );
+/*
+	One channel of 16 RGBA pixels as a BC4 block (8 bytes), and
+	16 RGBA pixels as a mode 6 BC7 block (16 bytes).
+*/
+static void compress_BC4_block(
+				const unsigned char *const uncompressed,
+				int channel,
+				unsigned char compressed[8] );
+static void compress_BC7_block(
+				const unsigned char *const uncompressed,
+				unsigned char compressed[16] );
+
+/*
+	The per block kernels of the colour line fit: the sums of the
+	covariance matrix (r, g, b, rr, gg, bb, rg, rb, gb) and the range
+	of the colours projected onto a direction.  All SIMD versions give
+	the same result as the scalar one, the sums are exact integers.
+*/
+typedef void (*DXT_moments_function)(
+				const unsigned char *const uncompressed,
+				int channels, int moments[9] );
+typedef void (*DXT_projection_function)(
+				const unsigned char *const uncompressed,
+				int channels, const float direction[3],
+				float *dot_min, float *dot_max );
+static void select_DXT_kernel_once( void );
+static void refine_DXT_endpoints(
+				int *cmax, int *cmin,
+				int channels,
+				const unsigned char *const uncompressed );
+
+/*	rows of 4x4 blocks handed to a thread at once	*/
+#define DXT_ROWS_PER_CHUNK	4
+/*	0 = let the OpenMP runtime decide	*/
+static int DXT_thread_count = 0;
+/*	the kernels in use, NULL until the first compression	*/
+static int DXT_kernel_in_use = DXT_KERNEL_AUTO;
+static DXT_moments_function DXT_block_moments = NULL;
+static DXT_projection_function DXT_block_projection = NULL;
+/*	0 = single pass, the output of the original encoder	*/
+static int DXT_refine_iterations = 0;
 
 /********* Actual Exposed Functions *********/
 int
@@ -46,11 +139,24 @@ int
 		int width, int height, int channels,
 		const unsigned char *const data
 	)
+{
+	return save_image_as_DDS_compressed( filename, width, height, channels, data, DDS_COMPRESSION_DXT );
+}
+
+int
+	save_image_as_DDS_compressed
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		int compression
+	)
 {
 	/*	variables	*/
 	FILE *fout;
 	unsigned char *DDS_data;
 	DDS_header header;
+	DDS_header_DXT10 header_DXT10;
 	int DDS_size;
 	/*	error check	*/
 	if( (NULL == filename) ||
@@ -61,14 +167,10 @@ int
 		return 0;
 	}
 	/*	Convert the image	*/
-	if( (channels & 1) == 1 )
-	{
-		/*	no alpha, just use DXT1	*/
-		DDS_data = convert_image_to_DXT1( data, width, height, channels, &DDS_size );
-	} else
+	DDS_data = convert_image_to_DDS_compression( data, width, height, channels, compression, &DDS_size );
+	if( NULL == DDS_data )
 	{
-		/*	has alpha, so use DXT5	*/
-		DDS_data = convert_image_to_DXT5( data, width, height, channels, &DDS_size );
+		return 0;
 	}
 	/*	save it	*/
 	memset( &header, 0, sizeof( DDS_header ) );
@@ -80,17 +182,45 @@ int
 	header.dwPitchOrLinearSize = DDS_size;
 	header.sPixelFormat.dwSize = 32;
 	header.sPixelFormat.dwFlags = DDPF_FOURCC;
-	if( (channels & 1) == 1 )
-	{
-		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('1' << 24);
-	} else
+	switch( compression )
 	{
-		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('5' << 24);
+	case DDS_COMPRESSION_BC4:
+		header.sPixelFormat.dwFourCC = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('1' << 24);
+		break;
+	case DDS_COMPRESSION_BC5:
+		header.sPixelFormat.dwFourCC = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('2' << 24);
+		break;
+	case DDS_COMPRESSION_BC7:
+		/*	there is no FourCC for BC7, only the DX10 extension	*/
+		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('1' << 16) | ('0' << 24);
+		memset( &header_DXT10, 0, sizeof( DDS_header_DXT10 ) );
+		header_DXT10.dxgiFormat = DXGI_FORMAT_BC7_UNORM;
+		header_DXT10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+		header_DXT10.arraySize = 1;
+		break;
+	default:
+		if( (channels & 1) == 1 )
+		{
+			header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('1' << 24);
+		} else
+		{
+			header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('5' << 24);
+		}
+		break;
 	}
 	header.sCaps.dwCaps1 = DDSCAPS_TEXTURE;
 	/*	write it out	*/
 	fout = fopen( filename, "wb");
+	if( NULL == fout )
+	{
+		free( DDS_data );
+		return 0;
+	}
 	fwrite( &header, sizeof( DDS_header ), 1, fout );
+	if( compression == DDS_COMPRESSION_BC7 )
+	{
+		fwrite( &header_DXT10, sizeof( DDS_header_DXT10 ), 1, fout );
+	}
 	fwrite( DDS_data, 1, DDS_size, fout );
 	fclose( fout );
 	/*	done	*/
@@ -98,36 +228,125 @@ int
 	return 1;
 }
 
+unsigned char* convert_image_to_DDS_compression(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int compression,
+		int *out_size )
+{
+	switch( compression )
+	{
+	case DDS_COMPRESSION_BC4:
+		return convert_image_to_BC4( uncompressed, width, height, channels, out_size );
+	case DDS_COMPRESSION_BC5:
+		return convert_image_to_BC5( uncompressed, width, height, channels, out_size );
+	case DDS_COMPRESSION_BC7:
+		return convert_image_to_BC7( uncompressed, width, height, channels, out_size );
+	default:
+		if( (channels & 1) == 1 )
+		{
+			/*	no alpha, just use DXT1	*/
+			return convert_image_to_DXT1( uncompressed, width, height, channels, out_size );
+		}
+		/*	has alpha, so use DXT5	*/
+		return convert_image_to_DXT5( uncompressed, width, height, channels, out_size );
+	}
+}
+
 unsigned char* convert_image_to_DXT1(
 		const unsigned char *const uncompressed,
 		int width, int height, int channels,
 		int *out_size )
 {
-	unsigned char *compressed;
+	/*	8 bytes per 4x4 pixel block	*/
+	return convert_image_in_block_rows(
+			compress_DXT1_block_rows, 8,
+			uncompressed, width, height, channels,
+			out_size );
+}
+
+unsigned char* convert_image_to_DXT5(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size )
+{
+	/*	16 bytes per 4x4 pixel block	*/
+	return convert_image_in_block_rows(
+			compress_DXT5_block_rows, 16,
+			uncompressed, width, height, channels,
+			out_size );
+}
+
+unsigned char* convert_image_to_BC4(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size )
+{
+	return convert_image_in_block_rows(
+			compress_BC4_block_rows, 8,
+			uncompressed, width, height, channels,
+			out_size );
+}
+
+unsigned char* convert_image_to_BC5(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size )
+{
+	return convert_image_in_block_rows(
+			compress_BC5_block_rows, 16,
+			uncompressed, width, height, channels,
+			out_size );
+}
+
+unsigned char* convert_image_to_BC7(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size )
+{
+	return convert_image_in_block_rows(
+			compress_BC7_block_rows, 16,
+			uncompressed, width, height, channels,
+			out_size );
+}
+
+void set_DXT_thread_count( int thread_count )
+{
+	DXT_thread_count = (thread_count > 0) ? thread_count : 0;
+}
+
+void set_DXT_refinement( int iterations )
+{
+	DXT_refine_iterations = (iterations > 0) ? iterations : 0;
+}
+
+unsigned int get_DXT_encoder_settings( void )
+{
+	select_DXT_kernel_once();
+	return ((unsigned int)DXT_refine_iterations << 4) | (unsigned int)DXT_kernel_in_use;
+}
+
+void
+	compress_DXT1_block_rows
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int first_row, int last_row,
+		unsigned char *compressed
+	)
+{
 	int i, j, x, y;
 	unsigned char ublock[16*3];
-	unsigned char cblock[8];
-	int index = 0, chan_step = 1;
-	int block_count = 0;
-	/*	error check	*/
-	*out_size = 0;
-	if( (width < 1) || (height < 1) ||
-		(NULL == uncompressed) ||
-		(channels < 1) || (channels > 4) )
-	{
-		return NULL;
-	}
+	int chan_step = 1;
+	/*	the blocks of a row are stored one after the other	*/
+	int index = first_row * ((width+3) >> 2) * 8;
 	/*	for channels == 1 or 2, I do not step forward for R,G,B values	*/
 	if( channels < 3 )
 	{
 		chan_step = 0;
 	}
-	/*	get the RAM for the compressed image
-		(8 bytes per 4x4 pixel block)	*/
-	*out_size = ((width+3) >> 2) * ((height+3) >> 2) * 8;
-	compressed = (unsigned char*)malloc( *out_size );
 	/*	go through each block	*/
-	for( j = 0; j < height; j += 4 )
+	for( j = first_row*4; j < last_row*4; j += 4 )
 	{
 		for( i = 0; i < width; i += 4 )
 		{
@@ -166,38 +385,28 @@ unsigned char* convert_image_to_DXT1(
 					ublock[idx++] = ublock[2];
 				}
 			}
-			/*	compress the block	*/
-			++block_count;
-			compress_DDS_color_block( 3, ublock, cblock );
-			/*	copy the data from the block into the main block	*/
-			for( x = 0; x < 8; ++x )
-			{
-				compressed[index++] = cblock[x];
-			}
+			/*	compress the block straight into the main block	*/
+			compress_DDS_color_block( 3, ublock, compressed + index );
+			index += 8;
 		}
 	}
-	return compressed;
 }
 
-unsigned char* convert_image_to_DXT5(
+void
+	compress_DXT5_block_rows
+	(
 		const unsigned char *const uncompressed,
 		int width, int height, int channels,
-		int *out_size )
+		int first_row, int last_row,
+		unsigned char *compressed
+	)
 {
-	unsigned char *compressed;
 	int i, j, x, y;
 	unsigned char ublock[16*4];
-	unsigned char cblock[8];
-	int index = 0, chan_step = 1;
-	int block_count = 0, has_alpha;
-	/*	error check	*/
-	*out_size = 0;
-	if( (width < 1) || (height < 1) ||
-		(NULL == uncompressed) ||
-		(channels < 1) || ( channels > 4) )
-	{
-		return NULL;
-	}
+	int chan_step = 1;
+	int has_alpha;
+	/*	the blocks of a row are stored one after the other	*/
+	int index = first_row * ((width+3) >> 2) * 16;
 	/*	for channels == 1 or 2, I do not step forward for R,G,B vales	*/
 	if( channels < 3 )
 	{
@@ -205,16 +414,12 @@ unsigned char* convert_image_to_DXT5(
 	}
 	/*	# channels = 1 or 3 have no alpha, 2 & 4 do have alpha	*/
 	has_alpha = 1 - (channels & 1);
-	/*	get the RAM for the compressed image
-		(16 bytes per 4x4 pixel block)	*/
-	*out_size = ((width+3) >> 2) * ((height+3) >> 2) * 16;
-	compressed = (unsigned char*)malloc( *out_size );
 	/*	go through each block	*/
-	for( j = 0; j < height; j += 4 )
+	for( j = first_row*4; j < last_row*4; j += 4 )
 	{
 		for( i = 0; i < width; i += 4 )
 		{
-			/*	local variables, and my block counter	*/
+			/*	local variables	*/
 			int idx = 0;
 			int mx = 4, my = 4;
 			if( j+4 >= height )
@@ -254,74 +459,596 @@ unsigned char* convert_image_to_DXT5(
 					ublock[idx++] = ublock[3];
 				}
 			}
-			/*	now compress the alpha block	*/
-			compress_DDS_alpha_block( ublock, cblock );
-			/*	copy the data from the compressed alpha block into the main buffer	*/
-			for( x = 0; x < 8; ++x )
+			/*	now compress the alpha block, then the color block,
+				straight into the main buffer	*/
+			compress_DDS_alpha_block( ublock, compressed + index );
+			compress_DDS_color_block( 4, ublock, compressed + index + 8 );
+			index += 16;
+		}
+	}
+}
+
+void
+	compress_BC4_block_rows
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int first_row, int last_row,
+		unsigned char *compressed
+	)
+{
+	int i, j;
+	unsigned char ublock[16*4];
+	int index = first_row * ((width+3) >> 2) * 8;
+	for( j = first_row*4; j < last_row*4; j += 4 )
+	{
+		for( i = 0; i < width; i += 4 )
+		{
+			get_RGBA_block( uncompressed, width, height, channels, i, j, ublock );
+			/*	red, or the luminance	*/
+			compress_BC4_block( ublock, 0, compressed + index );
+			index += 8;
+		}
+	}
+}
+
+void
+	compress_BC5_block_rows
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int first_row, int last_row,
+		unsigned char *compressed
+	)
+{
+	int i, j;
+	unsigned char ublock[16*4];
+	int index = first_row * ((width+3) >> 2) * 16;
+	/*	the second channel is green, but alpha for luminance + alpha	*/
+	int second = (channels == 2) ? 3 : 1;
+	for( j = first_row*4; j < last_row*4; j += 4 )
+	{
+		for( i = 0; i < width; i += 4 )
+		{
+			get_RGBA_block( uncompressed, width, height, channels, i, j, ublock );
+			compress_BC4_block( ublock, 0, compressed + index );
+			compress_BC4_block( ublock, second, compressed + index + 8 );
+			index += 16;
+		}
+	}
+}
+
+void
+	compress_BC7_block_rows
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int first_row, int last_row,
+		unsigned char *compressed
+	)
+{
+	int i, j;
+	unsigned char ublock[16*4];
+	int index = first_row * ((width+3) >> 2) * 16;
+	for( j = first_row*4; j < last_row*4; j += 4 )
+	{
+		for( i = 0; i < width; i += 4 )
+		{
+			get_RGBA_block( uncompressed, width, height, channels, i, j, ublock );
+			compress_BC7_block( ublock, compressed + index );
+			index += 16;
+		}
+	}
+}
+
+static void
+	get_RGBA_block
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int x, int y,
+		unsigned char ublock[16*4]
+	)
+{
+	int bx, by, c;
+	int idx = 0;
+	int mx = (x+4 >= width) ? width - x : 4;
+	int my = (y+4 >= height) ? height - y : 4;
+	int chan_step = (channels < 3) ? 0 : 1;
+	int has_alpha = 1 - (channels & 1);
+	for( by = 0; by < 4; ++by )
+	{
+		for( bx = 0; bx < 4; ++bx )
+		{
+			if( (bx < mx) && (by < my) )
 			{
-				compressed[index++] = cblock[x];
-			}
-			/*	then compress the color block	*/
-			++block_count;
-			compress_DDS_color_block( 4, ublock, cblock );
-			/*	copy the data from the compressed color block into the main buffer	*/
-			for( x = 0; x < 8; ++x )
+				const unsigned char *pixel = uncompressed + ((y+by)*width + (x+bx))*channels;
+				ublock[idx++] = pixel[0];
+				ublock[idx++] = pixel[chan_step];
+				ublock[idx++] = pixel[chan_step+chan_step];
+				ublock[idx++] = has_alpha ? pixel[channels-1] : 255;
+			} else
 			{
-				compressed[index++] = cblock[x];
+				for( c = 0; c < 4; ++c )
+				{
+					ublock[idx] = ublock[c];
+					++idx;
+				}
 			}
 		}
 	}
-	return compressed;
 }
 
-/********* Helper Functions *********/
-int convert_bit_range( int c, int from_bits, int to_bits )
+static unsigned char*
+	convert_image_in_block_rows
+	(
+		DXT_block_rows_function compress_rows,
+		int block_size,
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size
+	)
 {
-	int b = (1 << (from_bits - 1)) + c * ((1 << to_bits) - 1);
-	return (b + (b >> from_bits)) >> from_bits;
+	unsigned char *compressed;
+	/*	error check	*/
+	*out_size = 0;
+	if( (width < 1) || (height < 1) ||
+		(NULL == uncompressed) ||
+		(channels < 1) || (channels > 4) )
+	{
+		return NULL;
+	}
+	/*	get the RAM for the compressed image	*/
+	*out_size = ((width+3) >> 2) * ((height+3) >> 2) * block_size;
+	compressed = (unsigned char*)malloc( *out_size );
+	if( NULL == compressed )
+	{
+		*out_size = 0;
+		return NULL;
+	}
+	/*	go through each row of blocks	*/
+	select_DXT_kernel_once();
+	compress_block_rows_in_chunks(
+			compress_rows,
+			uncompressed, width, height, channels,
+			compressed );
+	return compressed;
 }
 
-int rgb_to_565( int r, int g, int b )
+/*	Rows of blocks are independent and every row has a fixed place in
+	the output, so chunks of rows can be handed out to threads in any
+	order and the result is the same as the serial one.	*/
+static void
+	compress_block_rows_in_chunks
+	(
+		DXT_block_rows_function compress_rows,
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		unsigned char *compressed
+	)
 {
-	return
-		(convert_bit_range( r, 8, 5 ) << 11) |
-		(convert_bit_range( g, 8, 6 ) << 05) |
-		(convert_bit_range( b, 8, 5 ) << 00);
+	const int block_rows = (height+3) >> 2;
+	const int chunk_count = (block_rows + DXT_ROWS_PER_CHUNK - 1) / DXT_ROWS_PER_CHUNK;
+	int chunk;
+#ifdef _OPENMP
+	const int thread_count = (DXT_thread_count > 0) ? DXT_thread_count : omp_get_max_threads();
+	#pragma omp parallel for num_threads( thread_count ) if( (thread_count > 1) && (chunk_count > 1) ) schedule( dynamic, 1 )
+#endif
+	for( chunk = 0; chunk < chunk_count; ++chunk )
+	{
+		int first_row = chunk * DXT_ROWS_PER_CHUNK;
+		int last_row = first_row + DXT_ROWS_PER_CHUNK;
+		if( last_row > block_rows )
+		{
+			last_row = block_rows;
+		}
+		compress_rows( uncompressed, width, height, channels, first_row, last_row, compressed );
+	}
 }
 
-void rgb_888_from_565( unsigned int c, int *r, int *g, int *b )
+/********* Colour Line Kernels *********/
+static void
+	block_moments_scalar
+	(
+		const unsigned char *const uncompressed,
+		int channels, int moments[9]
+	)
 {
-	*r = convert_bit_range( (c >> 11) & 31, 5, 8 );
-	*g = convert_bit_range( (c >> 05) & 63, 6, 8 );
-	*b = convert_bit_range( (c >> 00) & 31, 5, 8 );
+	int i;
+	for( i = 0; i < 9; ++i )
+	{
+		moments[i] = 0;
+	}
+	for( i = 0; i < 16*channels; i += channels )
+	{
+		moments[0] += uncompressed[i+0];
+		moments[1] += uncompressed[i+1];
+		moments[2] += uncompressed[i+2];
+		moments[3] += uncompressed[i+0] * uncompressed[i+0];
+		moments[4] += uncompressed[i+1] * uncompressed[i+1];
+		moments[5] += uncompressed[i+2] * uncompressed[i+2];
+		moments[6] += uncompressed[i+0] * uncompressed[i+1];
+		moments[7] += uncompressed[i+0] * uncompressed[i+2];
+		moments[8] += uncompressed[i+1] * uncompressed[i+2];
+	}
 }
 
-void compute_color_line_STDEV(
+static void
+	block_projection_scalar
+	(
 		const unsigned char *const uncompressed,
-		int channels,
-		float point[3], float direction[3] )
+		int channels, const float direction[3],
+		float *dot_min, float *dot_max
+	)
 {
-	const float inv_16 = 1.0f / 16.0f;
 	int i;
-	float sum_r = 0.0f, sum_g = 0.0f, sum_b = 0.0f;
-	float sum_rr = 0.0f, sum_gg = 0.0f, sum_bb = 0.0f;
-	float sum_rg = 0.0f, sum_rb = 0.0f, sum_gb = 0.0f;
-	/*	calculate all data needed for the covariance matrix
-		( to compare with _rygdxt code)	*/
-	for( i = 0; i < 16*channels; i += channels )
+	float dot;
+	*dot_max =
+			(
+				direction[0] * uncompressed[0] +
+				direction[1] * uncompressed[1] +
+				direction[2] * uncompressed[2]
+			);
+	*dot_min = *dot_max;
+	for( i = 1; i < 16; ++i )
 	{
-		sum_r += uncompressed[i+0];
-		sum_rr += uncompressed[i+0] * uncompressed[i+0];
-		sum_g += uncompressed[i+1];
-		sum_gg += uncompressed[i+1] * uncompressed[i+1];
-		sum_b += uncompressed[i+2];
-		sum_bb += uncompressed[i+2] * uncompressed[i+2];
-		sum_rg += uncompressed[i+0] * uncompressed[i+1];
-		sum_rb += uncompressed[i+0] * uncompressed[i+2];
-		sum_gb += uncompressed[i+1] * uncompressed[i+2];
+		dot =
+			(
+				direction[0] * uncompressed[i*channels+0] +
+				direction[1] * uncompressed[i*channels+1] +
+				direction[2] * uncompressed[i*channels+2]
+			);
+		if( dot < *dot_min )
+		{
+			*dot_min = dot;
+		} else if( dot > *dot_max )
+		{
+			*dot_max = dot;
+		}
 	}
-	/*	convert the sums to averages	*/
-	sum_r *= inv_16;
+}
+
+#ifdef DXT_SIMD
+/*	the 16 pixels as 32 bit lanes of R, G and B, 4 pixels per register	*/
+DXT_TARGET("sse4.1") static void
+	load_block_sse41
+	(
+		const unsigned char *const uncompressed,
+		int channels,
+		__m128i r[4], __m128i g[4], __m128i b[4]
+	)
+{
+	const __m128i mask = _mm_set1_epi32( 0xFF );
+	__m128i p[4];
+	int k;
+	if( channels == 4 )
+	{
+		for( k = 0; k < 4; ++k )
+		{
+			p[k] = _mm_loadu_si128( (const __m128i*)(uncompressed + 16*k) );
+		}
+	} else
+	{
+		/*	RGB: 3 loads, then each group of 4 pixels is spread to RGBx	*/
+		const __m128i spread = _mm_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+		__m128i v0 = _mm_loadu_si128( (const __m128i*)(uncompressed +  0) );
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)(uncompressed + 16) );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)(uncompressed + 32) );
+		p[0] = _mm_shuffle_epi8( v0, spread );
+		p[1] = _mm_shuffle_epi8( _mm_alignr_epi8( v1, v0, 12 ), spread );
+		p[2] = _mm_shuffle_epi8( _mm_alignr_epi8( v2, v1, 8 ), spread );
+		p[3] = _mm_shuffle_epi8( _mm_srli_si128( v2, 4 ), spread );
+	}
+	for( k = 0; k < 4; ++k )
+	{
+		r[k] = _mm_and_si128( p[k], mask );
+		g[k] = _mm_and_si128( _mm_srli_epi32( p[k], 8 ), mask );
+		b[k] = _mm_and_si128( _mm_srli_epi32( p[k], 16 ), mask );
+	}
+}
+
+DXT_TARGET("sse4.1") static int
+	horizontal_sum_sse41( __m128i x )
+{
+	x = _mm_add_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	x = _mm_add_epi32( x, _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	return _mm_cvtsi128_si32( x );
+}
+
+/*	the values fit in 16 bits, so _mm_madd_epi16 gives the 32 bit products	*/
+DXT_TARGET("sse4.1") static void
+	block_moments_sse41
+	(
+		const unsigned char *const uncompressed,
+		int channels, int moments[9]
+	)
+{
+	__m128i r[4], g[4], b[4];
+	__m128i sum[9];
+	int k;
+	load_block_sse41( uncompressed, channels, r, g, b );
+	for( k = 0; k < 9; ++k )
+	{
+		sum[k] = _mm_setzero_si128();
+	}
+	for( k = 0; k < 4; ++k )
+	{
+		sum[0] = _mm_add_epi32( sum[0], r[k] );
+		sum[1] = _mm_add_epi32( sum[1], g[k] );
+		sum[2] = _mm_add_epi32( sum[2], b[k] );
+		sum[3] = _mm_add_epi32( sum[3], _mm_madd_epi16( r[k], r[k] ) );
+		sum[4] = _mm_add_epi32( sum[4], _mm_madd_epi16( g[k], g[k] ) );
+		sum[5] = _mm_add_epi32( sum[5], _mm_madd_epi16( b[k], b[k] ) );
+		sum[6] = _mm_add_epi32( sum[6], _mm_madd_epi16( r[k], g[k] ) );
+		sum[7] = _mm_add_epi32( sum[7], _mm_madd_epi16( r[k], b[k] ) );
+		sum[8] = _mm_add_epi32( sum[8], _mm_madd_epi16( g[k], b[k] ) );
+	}
+	for( k = 0; k < 9; ++k )
+	{
+		moments[k] = horizontal_sum_sse41( sum[k] );
+	}
+}
+
+/*	same operation order as the scalar code, so the floats match exactly	*/
+DXT_TARGET("sse4.1") static void
+	block_projection_sse41
+	(
+		const unsigned char *const uncompressed,
+		int channels, const float direction[3],
+		float *dot_min, float *dot_max
+	)
+{
+	__m128i r[4], g[4], b[4];
+	const __m128 dx = _mm_set1_ps( direction[0] );
+	const __m128 dy = _mm_set1_ps( direction[1] );
+	const __m128 dz = _mm_set1_ps( direction[2] );
+	__m128 dot[4], low, high;
+	int k;
+	load_block_sse41( uncompressed, channels, r, g, b );
+	for( k = 0; k < 4; ++k )
+	{
+		dot[k] = _mm_add_ps(
+				_mm_add_ps( _mm_mul_ps( dx, _mm_cvtepi32_ps( r[k] ) ), _mm_mul_ps( dy, _mm_cvtepi32_ps( g[k] ) ) ),
+				_mm_mul_ps( dz, _mm_cvtepi32_ps( b[k] ) ) );
+	}
+	low = _mm_min_ps( _mm_min_ps( dot[0], dot[1] ), _mm_min_ps( dot[2], dot[3] ) );
+	high = _mm_max_ps( _mm_max_ps( dot[0], dot[1] ), _mm_max_ps( dot[2], dot[3] ) );
+	low = _mm_min_ps( low, _mm_shuffle_ps( low, low, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	low = _mm_min_ps( low, _mm_shuffle_ps( low, low, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	high = _mm_max_ps( high, _mm_shuffle_ps( high, high, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	high = _mm_max_ps( high, _mm_shuffle_ps( high, high, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	*dot_min = _mm_cvtss_f32( low );
+	*dot_max = _mm_cvtss_f32( high );
+}
+
+/*	AVX2: 8 pixels per register	*/
+DXT_TARGET("avx2") static void
+	load_block_avx2
+	(
+		const unsigned char *const uncompressed,
+		int channels,
+		__m256i r[2], __m256i g[2], __m256i b[2]
+	)
+{
+	const __m256i mask = _mm256_set1_epi32( 0xFF );
+	__m256i p[2];
+	int k;
+	if( channels == 4 )
+	{
+		p[0] = _mm256_loadu_si256( (const __m256i*)(uncompressed +  0) );
+		p[1] = _mm256_loadu_si256( (const __m256i*)(uncompressed + 32) );
+	} else
+	{
+		/*	RGB: spread with the SSE shuffle, then pair up the halves	*/
+		const __m128i spread = _mm_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+		__m128i v0 = _mm_loadu_si128( (const __m128i*)(uncompressed +  0) );
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)(uncompressed + 16) );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)(uncompressed + 32) );
+		p[0] = _mm256_inserti128_si256( _mm256_castsi128_si256(
+				_mm_shuffle_epi8( v0, spread ) ),
+				_mm_shuffle_epi8( _mm_alignr_epi8( v1, v0, 12 ), spread ), 1 );
+		p[1] = _mm256_inserti128_si256( _mm256_castsi128_si256(
+				_mm_shuffle_epi8( _mm_alignr_epi8( v2, v1, 8 ), spread ) ),
+				_mm_shuffle_epi8( _mm_srli_si128( v2, 4 ), spread ), 1 );
+	}
+	for( k = 0; k < 2; ++k )
+	{
+		r[k] = _mm256_and_si256( p[k], mask );
+		g[k] = _mm256_and_si256( _mm256_srli_epi32( p[k], 8 ), mask );
+		b[k] = _mm256_and_si256( _mm256_srli_epi32( p[k], 16 ), mask );
+	}
+}
+
+DXT_TARGET("avx2") static void
+	block_moments_avx2
+	(
+		const unsigned char *const uncompressed,
+		int channels, int moments[9]
+	)
+{
+	__m256i r[2], g[2], b[2];
+	__m256i sum[9];
+	int k;
+	load_block_avx2( uncompressed, channels, r, g, b );
+	sum[0] = _mm256_add_epi32( r[0], r[1] );
+	sum[1] = _mm256_add_epi32( g[0], g[1] );
+	sum[2] = _mm256_add_epi32( b[0], b[1] );
+	sum[3] = _mm256_add_epi32( _mm256_madd_epi16( r[0], r[0] ), _mm256_madd_epi16( r[1], r[1] ) );
+	sum[4] = _mm256_add_epi32( _mm256_madd_epi16( g[0], g[0] ), _mm256_madd_epi16( g[1], g[1] ) );
+	sum[5] = _mm256_add_epi32( _mm256_madd_epi16( b[0], b[0] ), _mm256_madd_epi16( b[1], b[1] ) );
+	sum[6] = _mm256_add_epi32( _mm256_madd_epi16( r[0], g[0] ), _mm256_madd_epi16( r[1], g[1] ) );
+	sum[7] = _mm256_add_epi32( _mm256_madd_epi16( r[0], b[0] ), _mm256_madd_epi16( r[1], b[1] ) );
+	sum[8] = _mm256_add_epi32( _mm256_madd_epi16( g[0], b[0] ), _mm256_madd_epi16( g[1], b[1] ) );
+	for( k = 0; k < 9; ++k )
+	{
+		moments[k] = horizontal_sum_sse41( _mm_add_epi32(
+				_mm256_castsi256_si128( sum[k] ), _mm256_extracti128_si256( sum[k], 1 ) ) );
+	}
+}
+
+DXT_TARGET("avx2") static void
+	block_projection_avx2
+	(
+		const unsigned char *const uncompressed,
+		int channels, const float direction[3],
+		float *dot_min, float *dot_max
+	)
+{
+	__m256i r[2], g[2], b[2];
+	const __m256 dx = _mm256_set1_ps( direction[0] );
+	const __m256 dy = _mm256_set1_ps( direction[1] );
+	const __m256 dz = _mm256_set1_ps( direction[2] );
+	__m256 dot[2], low8, high8;
+	__m128 low, high;
+	int k;
+	load_block_avx2( uncompressed, channels, r, g, b );
+	for( k = 0; k < 2; ++k )
+	{
+		dot[k] = _mm256_add_ps(
+				_mm256_add_ps( _mm256_mul_ps( dx, _mm256_cvtepi32_ps( r[k] ) ), _mm256_mul_ps( dy, _mm256_cvtepi32_ps( g[k] ) ) ),
+				_mm256_mul_ps( dz, _mm256_cvtepi32_ps( b[k] ) ) );
+	}
+	low8 = _mm256_min_ps( dot[0], dot[1] );
+	high8 = _mm256_max_ps( dot[0], dot[1] );
+	low = _mm_min_ps( _mm256_castps256_ps128( low8 ), _mm256_extractf128_ps( low8, 1 ) );
+	high = _mm_max_ps( _mm256_castps256_ps128( high8 ), _mm256_extractf128_ps( high8, 1 ) );
+	low = _mm_min_ps( low, _mm_shuffle_ps( low, low, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	low = _mm_min_ps( low, _mm_shuffle_ps( low, low, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	high = _mm_max_ps( high, _mm_shuffle_ps( high, high, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	high = _mm_max_ps( high, _mm_shuffle_ps( high, high, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	*dot_min = _mm_cvtss_f32( low );
+	*dot_max = _mm_cvtss_f32( high );
+}
+#endif
+
+/*	the best kernel this CPU (and OS, for the AVX registers) supports	*/
+static int
+	best_DXT_kernel( void )
+{
+#if defined(DXT_SIMD) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		return DXT_KERNEL_AVX2;
+	}
+	if( __builtin_cpu_supports( "sse4.1" ) )
+	{
+		return DXT_KERNEL_SSE41;
+	}
+#elif defined(DXT_SIMD)
+	int info[4];
+	int avx2 = 0;
+	__cpuid( info, 0 );
+	if( info[0] >= 7 )
+	{
+		__cpuidex( info, 7, 0 );
+		avx2 = (info[1] >> 5) & 1;
+	}
+	__cpuid( info, 1 );
+	/*	OSXSAVE and AVX, and the OS saves the YMM registers	*/
+	if( avx2 && ((info[2] >> 27) & 3) == 3 && (_xgetbv( 0 ) & 6) == 6 )
+	{
+		return DXT_KERNEL_AVX2;
+	}
+	if( (info[2] >> 19) & 1 )
+	{
+		return DXT_KERNEL_SSE41;
+	}
+#endif
+	return DXT_KERNEL_SCALAR;
+}
+
+int set_DXT_kernel( int kernel )
+{
+	int best = best_DXT_kernel();
+	if( (kernel <= DXT_KERNEL_AUTO) || (kernel > best) )
+	{
+		kernel = best;
+	}
+	switch( kernel )
+	{
+#ifdef DXT_SIMD
+	case DXT_KERNEL_AVX2:
+		DXT_block_moments = block_moments_avx2;
+		DXT_block_projection = block_projection_avx2;
+		break;
+	case DXT_KERNEL_SSE41:
+		DXT_block_moments = block_moments_sse41;
+		DXT_block_projection = block_projection_sse41;
+		break;
+#endif
+	default:
+		kernel = DXT_KERNEL_SCALAR;
+		DXT_block_moments = block_moments_scalar;
+		DXT_block_projection = block_projection_scalar;
+		break;
+	}
+	DXT_kernel_in_use = kernel;
+	return kernel;
+}
+
+/*	called before the threads start, so the pointers are set only once	*/
+static void
+	select_DXT_kernel_once( void )
+{
+	if( NULL == DXT_block_moments )
+	{
+		set_DXT_kernel( DXT_KERNEL_AUTO );
+	}
+}
+
+void init_DXT_kernel( void )
+{
+	select_DXT_kernel_once();
+}
+
+/********* Helper Functions *********/
+int convert_bit_range( int c, int from_bits, int to_bits )
+{
+	int b = (1 << (from_bits - 1)) + c * ((1 << to_bits) - 1);
+	return (b + (b >> from_bits)) >> from_bits;
+}
+
+int rgb_to_565( int r, int g, int b )
+{
+	return
+		(convert_bit_range( r, 8, 5 ) << 11) |
+		(convert_bit_range( g, 8, 6 ) << 05) |
+		(convert_bit_range( b, 8, 5 ) << 00);
+}
+
+void rgb_888_from_565( unsigned int c, int *r, int *g, int *b )
+{
+	*r = convert_bit_range( (c >> 11) & 31, 5, 8 );
+	*g = convert_bit_range( (c >> 05) & 63, 6, 8 );
+	*b = convert_bit_range( (c >> 00) & 31, 5, 8 );
+}
+
+void compute_color_line_STDEV(
+		const unsigned char *const uncompressed,
+		int channels,
+		float point[3], float direction[3] )
+{
+	const float inv_16 = 1.0f / 16.0f;
+	int moments[9];
+	float sum_r, sum_g, sum_b;
+	float sum_rr, sum_gg, sum_bb;
+	float sum_rg, sum_rb, sum_gb;
+	/*	calculate all data needed for the covariance matrix
+		( to compare with _rygdxt code)	*/
+	select_DXT_kernel_once();
+	DXT_block_moments( uncompressed, channels, moments );
+	sum_r = (float)moments[0];
+	sum_g = (float)moments[1];
+	sum_b = (float)moments[2];
+	sum_rr = (float)moments[3];
+	sum_gg = (float)moments[4];
+	sum_bb = (float)moments[5];
+	sum_rg = (float)moments[6];
+	sum_rb = (float)moments[7];
+	sum_gb = (float)moments[8];
+	/*	convert the sums to averages	*/
+	sum_r *= inv_16;
 	sum_g *= inv_16;
 	sum_b *= inv_16;
 	/*	and convert the squares to the squares of the value - avg_value	*/
@@ -431,29 +1158,7 @@ void LSE_master_colors_max_min(
 	vec_len2 = 1.0f / ( 0.00001f +
 			sum_x2[0]*sum_x2[0] + sum_x2[1]*sum_x2[1] + sum_x2[2]*sum_x2[2] );
 	/*	finding the max and min vector values	*/
-	dot_max =
-			(
-				sum_x2[0] * uncompressed[0] +
-				sum_x2[1] * uncompressed[1] +
-				sum_x2[2] * uncompressed[2]
-			);
-	dot_min = dot_max;
-	for( i = 1; i < 16; ++i )
-	{
-		dot =
-			(
-				sum_x2[0] * uncompressed[i*channels+0] +
-				sum_x2[1] * uncompressed[i*channels+1] +
-				sum_x2[2] * uncompressed[i*channels+2]
-			);
-		if( dot < dot_min )
-		{
-			dot_min = dot;
-		} else if( dot > dot_max )
-		{
-			dot_max = dot;
-		}
-	}
+	DXT_block_projection( uncompressed, channels, sum_x2, &dot_min, &dot_max );
 	/*	and the offset (from the average location)	*/
 	dot = sum_x2[0]*sum_x[0] + sum_x2[1]*sum_x[1] + sum_x2[2]*sum_x[2];
 	dot_min -= dot;
@@ -497,35 +1202,20 @@ void LSE_master_colors_max_min(
 	}
 }
 
-void
-	compress_DDS_color_block
+/*	the index of each pixel along the c0 -> c1 line (0 = c0, 3 = c1)	*/
+static void
+	color_line_indices
 	(
+		int enc_c0, int enc_c1,
 		int channels,
 		const unsigned char *const uncompressed,
-		unsigned char compressed[8]
+		int indices[16]
 	)
 {
-	/*	variables	*/
 	int i;
-	int next_bit;
-	int enc_c0, enc_c1;
 	int c0[4], c1[4];
 	float color_line[] = { 0.0f, 0.0f, 0.0f, 0.0f };
 	float vec_len2 = 0.0f, dot_offset = 0.0f;
-	/*	stupid order	*/
-	int swizzle4[] = { 0, 2, 3, 1 };
-	/*	get the master colors	*/
-	LSE_master_colors_max_min( &enc_c0, &enc_c1, channels, uncompressed );
-	/*	store the 565 color 0 and color 1	*/
-	compressed[0] = (enc_c0 >> 0) & 255;
-	compressed[1] = (enc_c0 >> 8) & 255;
-	compressed[2] = (enc_c1 >> 0) & 255;
-	compressed[3] = (enc_c1 >> 8) & 255;
-	/*	zero out the compressed data	*/
-	compressed[4] = 0;
-	compressed[5] = 0;
-	compressed[6] = 0;
-	compressed[7] = 0;
 	/*	reconstitute the master color vectors	*/
 	rgb_888_from_565( enc_c0, &c0[0], &c0[1], &c0[2] );
 	rgb_888_from_565( enc_c1, &c1[0], &c1[1], &c1[2] );
@@ -546,8 +1236,6 @@ void
 	color_line[2] *= vec_len2;
 	/*	compute the offset (constant) portion of the dot product	*/
 	dot_offset = color_line[0]*c0[0] + color_line[1]*c0[1] + color_line[2]*c0[2];
-	/*	store the rest of the bits	*/
-	next_bit = 8*4;
 	for( i = 0; i < 16; ++i )
 	{
 		/*	find the dot product of this color, to place it on the line
@@ -567,13 +1255,158 @@ void
 		{
 			next_value = 0;
 		}
+		indices[i] = next_value;
+	}
+}
+
+void
+	compress_DDS_color_block
+	(
+		int channels,
+		const unsigned char *const uncompressed,
+		unsigned char compressed[8]
+	)
+{
+	/*	variables	*/
+	int i;
+	int next_bit;
+	int enc_c0, enc_c1;
+	int indices[16];
+	/*	stupid order	*/
+	int swizzle4[] = { 0, 2, 3, 1 };
+	/*	get the master colors	*/
+	LSE_master_colors_max_min( &enc_c0, &enc_c1, channels, uncompressed );
+	/*	quality mode: move them closer to the pixels	*/
+	if( DXT_refine_iterations > 0 )
+	{
+		refine_DXT_endpoints( &enc_c0, &enc_c1, channels, uncompressed );
+	}
+	/*	store the 565 color 0 and color 1	*/
+	compressed[0] = (enc_c0 >> 0) & 255;
+	compressed[1] = (enc_c0 >> 8) & 255;
+	compressed[2] = (enc_c1 >> 0) & 255;
+	compressed[3] = (enc_c1 >> 8) & 255;
+	/*	zero out the compressed data	*/
+	compressed[4] = 0;
+	compressed[5] = 0;
+	compressed[6] = 0;
+	compressed[7] = 0;
+	/*	store the rest of the bits	*/
+	color_line_indices( enc_c0, enc_c1, channels, uncompressed, indices );
+	next_bit = 8*4;
+	for( i = 0; i < 16; ++i )
+	{
 		/*	OK, store this value	*/
-		compressed[next_bit >> 3] |= swizzle4[ next_value ] << (next_bit & 7);
+		compressed[next_bit >> 3] |= swizzle4[ indices[i] ] << (next_bit & 7);
 		next_bit += 2;
 	}
 	/*	done compressing to DXT1	*/
 }
 
+/*	squared RGB error of the block when it is encoded with these
+	master colors, as a 4 color DXT1 decoder sees it	*/
+static int
+	color_block_error
+	(
+		int enc_c0, int enc_c1,
+		int channels,
+		const unsigned char *const uncompressed
+	)
+{
+	int i, k;
+	int error = 0;
+	int c0[3], c1[3];
+	int indices[16];
+	color_line_indices( enc_c0, enc_c1, channels, uncompressed, indices );
+	rgb_888_from_565( enc_c0, &c0[0], &c0[1], &c0[2] );
+	rgb_888_from_565( enc_c1, &c1[0], &c1[1], &c1[2] );
+	for( i = 0; i < 16; ++i )
+	{
+		for( k = 0; k < 3; ++k )
+		{
+			int diff = uncompressed[i*channels+k] -
+				(c0[k] * (3 - indices[i]) + c1[k] * indices[i]) / 3;
+			error += diff * diff;
+		}
+	}
+	return error;
+}
+
+/*
+	Iterative endpoint refinement: with the current indices fixed, the
+	least squares master colors are solved per channel, quantized to 565
+	and kept only if the block error goes down.  Then the indices are
+	recomputed, up to DXT_refine_iterations times.
+*/
+static void
+	refine_DXT_endpoints
+	(
+		int *cmax, int *cmin,
+		int channels,
+		const unsigned char *const uncompressed
+	)
+{
+	int iteration, i, k;
+	int best_error = color_block_error( *cmax, *cmin, channels, uncompressed );
+	for( iteration = 0; (iteration < DXT_refine_iterations) && (best_error > 0); ++iteration )
+	{
+		int indices[16];
+		int a[3], b[3];
+		int enc_a, enc_b, error;
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f, det;
+		float ax[] = { 0.0f, 0.0f, 0.0f };
+		float bx[] = { 0.0f, 0.0f, 0.0f };
+		color_line_indices( *cmax, *cmin, channels, uncompressed, indices );
+		/*	normal equations of sum | (1-w) a + w b - x |^2	*/
+		for( i = 0; i < 16; ++i )
+		{
+			float w = indices[i] * (1.0f / 3.0f);
+			aa += (1.0f - w) * (1.0f - w);
+			ab += (1.0f - w) * w;
+			bb += w * w;
+			for( k = 0; k < 3; ++k )
+			{
+				ax[k] += (1.0f - w) * uncompressed[i*channels+k];
+				bx[k] += w * uncompressed[i*channels+k];
+			}
+		}
+		det = aa * bb - ab * ab;
+		if( det < 0.0001f )
+		{
+			/*	every pixel has the same index, there is no line to fit	*/
+			break;
+		}
+		for( k = 0; k < 3; ++k )
+		{
+			a[k] = (int)((ax[k] * bb - bx[k] * ab) / det + 0.5f);
+			b[k] = (int)((bx[k] * aa - ax[k] * ab) / det + 0.5f);
+			a[k] = (a[k] < 0) ? 0 : ((a[k] > 255) ? 255 : a[k]);
+			b[k] = (b[k] < 0) ? 0 : ((b[k] > 255) ? 255 : b[k]);
+		}
+		enc_a = rgb_to_565( a[0], a[1], a[2] );
+		enc_b = rgb_to_565( b[0], b[1], b[2] );
+		if( enc_a == enc_b )
+		{
+			break;
+		}
+		/*	color 0 has to stay the larger one for the 4 color mode	*/
+		if( enc_a < enc_b )
+		{
+			int swap = enc_a;
+			enc_a = enc_b;
+			enc_b = swap;
+		}
+		error = color_block_error( enc_a, enc_b, channels, uncompressed );
+		if( error >= best_error )
+		{
+			break;
+		}
+		best_error = error;
+		*cmax = enc_a;
+		*cmin = enc_b;
+	}
+}
+
 void
 	compress_DDS_alpha_block
 	(
@@ -630,3 +1463,463 @@ void
 	}
 	/*	done compressing to DXT1	*/
 }
+
+/********* BC4 and BC7 Blocks *********/
+static void
+	compress_BC4_block
+	(
+		const unsigned char *const uncompressed,
+		int channel,
+		unsigned char compressed[8]
+	)
+{
+	int i, k;
+	int next_bit;
+	int a0, a1;
+	int palette[8];
+	/*	the limits, as for the DXT5 alpha (a0 > a1 = 8 value mode,
+		a0 == a1 only needs index 0)	*/
+	a0 = a1 = uncompressed[channel];
+	for( i = 1; i < 16; ++i )
+	{
+		int value = uncompressed[i*4+channel];
+		if( value > a0 )
+		{
+			a0 = value;
+		} else if( value < a1 )
+		{
+			a1 = value;
+		}
+	}
+	compressed[0] = a0;
+	compressed[1] = a1;
+	memset( compressed + 2, 0, 6 );
+	/*	the 8 values the decoder builds from them	*/
+	palette[0] = a0;
+	palette[1] = a1;
+	for( k = 1; k < 7; ++k )
+	{
+		palette[k+1] = ((7-k)*a0 + k*a1) / 7;
+	}
+	/*	unlike the DXT5 alpha, each value gets its nearest index,
+		not the one below it, BC4 is the whole texture here	*/
+	next_bit = 8*2;
+	for( i = 0; i < 16; ++i )
+	{
+		int value = uncompressed[i*4+channel];
+		int best = 0;
+		int best_error = abs( palette[0] - value );
+		for( k = 1; k < 8; ++k )
+		{
+			int error = abs( palette[k] - value );
+			if( error < best_error )
+			{
+				best = k;
+				best_error = error;
+			}
+		}
+		compressed[next_bit >> 3] |= best << (next_bit & 7);
+		if( (next_bit & 7) > 5 )
+		{
+			/*	spans 2 bytes	*/
+			compressed[1 + (next_bit >> 3)] |= best >> (8 - (next_bit & 7));
+		}
+		next_bit += 3;
+	}
+}
+
+/*	the bits of a BC7 block are stored from the lowest one up	*/
+static void
+	put_BC7_bits
+	(
+		unsigned char compressed[16],
+		int *next_bit,
+		int value, int bit_count
+	)
+{
+	int i;
+	for( i = 0; i < bit_count; ++i )
+	{
+		compressed[*next_bit >> 3] |= ((value >> i) & 1) << (*next_bit & 7);
+		++*next_bit;
+	}
+}
+
+/*	Mode 6: one RGBA line, 7 bit endpoints with a p-bit each (the
+	lowest of the 8 bits), and a 4 bit index per pixel.	*/
+static void
+	compress_BC7_block
+	(
+		const unsigned char *const uncompressed,
+		unsigned char compressed[16]
+	)
+{
+	static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float covariance[4][4];
+	float axis[4];
+	float dot_min = 0.0f, dot_max = 0.0f;
+	float ends[2][4];
+	int lowest[4], highest[4];
+	int quantized[2][4], p_bits[2];
+	int endpoints[2][4];
+	int palette[16][4];
+	int indices[16];
+	int direction[4], length = 0;
+	int opaque = 1;
+	int i, c, d, e, k, p, iteration;
+	int next_bit = 0;
+	/*	mean and range of the block	*/
+	for( c = 0; c < 4; ++c )
+	{
+		lowest[c] = highest[c] = uncompressed[c];
+	}
+	for( i = 0; i < 16; ++i )
+	{
+		for( c = 0; c < 4; ++c )
+		{
+			int value = uncompressed[i*4+c];
+			mean[c] += value;
+			if( value < lowest[c] )
+			{
+				lowest[c] = value;
+			} else if( value > highest[c] )
+			{
+				highest[c] = value;
+			}
+		}
+		opaque &= (uncompressed[i*4+3] == 255);
+	}
+	for( c = 0; c < 4; ++c )
+	{
+		mean[c] /= 16.0f;
+		axis[c] = (float)(highest[c] - lowest[c]);
+	}
+	/*	the main axis of the colours by power iteration on the covariance
+		matrix, starting from the diagonal of the bounding box	*/
+	for( c = 0; c < 4; ++c )
+	{
+		for( d = 0; d < 4; ++d )
+		{
+			covariance[c][d] = 0.0f;
+		}
+	}
+	for( i = 0; i < 16; ++i )
+	{
+		for( c = 0; c < 4; ++c )
+		{
+			for( d = c; d < 4; ++d )
+			{
+				covariance[c][d] += (uncompressed[i*4+c] - mean[c]) * (uncompressed[i*4+d] - mean[d]);
+			}
+		}
+	}
+	for( c = 0; c < 4; ++c )
+	{
+		for( d = 0; d < c; ++d )
+		{
+			covariance[c][d] = covariance[d][c];
+		}
+	}
+	for( iteration = 0; iteration < 4; ++iteration )
+	{
+		float next[4];
+		float length = 0.0f;
+		for( c = 0; c < 4; ++c )
+		{
+			next[c] = covariance[c][0]*axis[0] + covariance[c][1]*axis[1]
+					+ covariance[c][2]*axis[2] + covariance[c][3]*axis[3];
+			length += next[c] * next[c];
+		}
+		if( length <= 0.0f )
+		{
+			break;
+		}
+		length = 1.0f / (float)sqrt( length );
+		for( c = 0; c < 4; ++c )
+		{
+			axis[c] = next[c] * length;
+		}
+	}
+	{
+		float length = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2] + axis[3]*axis[3];
+		if( length > 0.0f )
+		{
+			length = 1.0f / (float)sqrt( length );
+		}
+		for( c = 0; c < 4; ++c )
+		{
+			axis[c] *= length;
+		}
+	}
+	/*	the ends of the line are the extreme projections	*/
+	for( i = 0; i < 16; ++i )
+	{
+		float dot = 0.0f;
+		for( c = 0; c < 4; ++c )
+		{
+			dot += (uncompressed[i*4+c] - mean[c]) * axis[c];
+		}
+		if( (i == 0) || (dot < dot_min) )
+		{
+			dot_min = dot;
+		}
+		if( (i == 0) || (dot > dot_max) )
+		{
+			dot_max = dot;
+		}
+	}
+	for( c = 0; c < 4; ++c )
+	{
+		ends[0][c] = mean[c] + dot_min * axis[c];
+		ends[1][c] = mean[c] + dot_max * axis[c];
+	}
+	/*	quantize each end with the p-bit that fits it best; opaque
+		blocks keep p = 1, so the alpha stays exactly 255	*/
+	for( e = 0; e < 2; ++e )
+	{
+		float best_error = -1.0f;
+		for( p = opaque; p < 2; ++p )
+		{
+			int q[4];
+			float error = 0.0f;
+			for( c = 0; c < 4; ++c )
+			{
+				float delta;
+				q[c] = (int)floor( (ends[e][c] - p) * 0.5f + 0.5f );
+				q[c] = (q[c] < 0) ? 0 : ((q[c] > 127) ? 127 : q[c]);
+				delta = ((q[c] << 1) | p) - ends[e][c];
+				error += delta * delta;
+			}
+			if( (best_error < 0.0f) || (error < best_error) )
+			{
+				best_error = error;
+				p_bits[e] = p;
+				for( c = 0; c < 4; ++c )
+				{
+					quantized[e][c] = q[c];
+				}
+			}
+		}
+		for( c = 0; c < 4; ++c )
+		{
+			endpoints[e][c] = (quantized[e][c] << 1) | p_bits[e];
+		}
+	}
+	/*	the 16 colours of the line, and the nearest one to each pixel	*/
+	for( k = 0; k < 16; ++k )
+	{
+		for( c = 0; c < 4; ++c )
+		{
+			palette[k][c] = ((64 - weights[k]) * endpoints[0][c] + weights[k] * endpoints[1][c] + 32) >> 6;
+		}
+	}
+	for( c = 0; c < 4; ++c )
+	{
+		direction[c] = endpoints[1][c] - endpoints[0][c];
+		length += direction[c] * direction[c];
+	}
+	for( i = 0; i < 16; ++i )
+	{
+		/*	the weights are nearly uniform, so the projection onto the
+			line is at most one index off, only its neighbours are tried	*/
+		int best_error = -1;
+		int first, last, dot = 0;
+		for( c = 0; c < 4; ++c )
+		{
+			dot += (uncompressed[i*4+c] - endpoints[0][c]) * direction[c];
+		}
+		k = (length > 0) ? (dot * 30 + length) / (2 * length) : 0;
+		k = (k < 0) ? 0 : ((k > 15) ? 15 : k);
+		first = (k > 0) ? k - 1 : 0;
+		last = (k < 15) ? k + 1 : 15;
+		for( k = first; k <= last; ++k )
+		{
+			int error = 0;
+			for( c = 0; c < 4; ++c )
+			{
+				int delta = palette[k][c] - uncompressed[i*4+c];
+				error += delta * delta;
+			}
+			if( (best_error < 0) || (error < best_error) )
+			{
+				best_error = error;
+				indices[i] = k;
+			}
+		}
+	}
+	/*	the first index is stored on 3 bits, its top bit must be 0:
+		if it is not, swap the ends and mirror the indices	*/
+	if( indices[0] & 8 )
+	{
+		for( c = 0; c < 4; ++c )
+		{
+			k = quantized[0][c];
+			quantized[0][c] = quantized[1][c];
+			quantized[1][c] = k;
+		}
+		k = p_bits[0];
+		p_bits[0] = p_bits[1];
+		p_bits[1] = k;
+		for( i = 0; i < 16; ++i )
+		{
+			indices[i] = 15 - indices[i];
+		}
+	}
+	/*	mode 6 is a 1 after 6 zeros, then R0 R1 G0 G1 B0 B1 A0 A1,
+		P0 P1 and the indices	*/
+	memset( compressed, 0, 16 );
+	put_BC7_bits( compressed, &next_bit, 1 << 6, 7 );
+	for( c = 0; c < 4; ++c )
+	{
+		put_BC7_bits( compressed, &next_bit, quantized[0][c], 7 );
+		put_BC7_bits( compressed, &next_bit, quantized[1][c], 7 );
+	}
+	put_BC7_bits( compressed, &next_bit, p_bits[0], 1 );
+	put_BC7_bits( compressed, &next_bit, p_bits[1], 1 );
+	put_BC7_bits( compressed, &next_bit, indices[0], 3 );
+	for( i = 1; i < 16; ++i )
+	{
+		put_BC7_bits( compressed, &next_bit, indices[i], 4 );
+	}
+}
+
+/********* Benchmark *********/
+/*	decodes the colour part of a DXT1/DXT5 block to 16 RGB pixels	*/
+static void
+	decode_DDS_color_block
+	(
+		const unsigned char compressed[8],
+		unsigned char rgb[16*3]
+	)
+{
+	int i, k;
+	int palette[4][3];
+	unsigned int enc_c0 = compressed[0] | (compressed[1] << 8);
+	unsigned int enc_c1 = compressed[2] | (compressed[3] << 8);
+	unsigned int bits = compressed[4] | (compressed[5] << 8) |
+			(compressed[6] << 16) | ((unsigned int)compressed[7] << 24);
+	rgb_888_from_565( enc_c0, &palette[0][0], &palette[0][1], &palette[0][2] );
+	rgb_888_from_565( enc_c1, &palette[1][0], &palette[1][1], &palette[1][2] );
+	for( k = 0; k < 3; ++k )
+	{
+		if( enc_c0 > enc_c1 )
+		{
+			palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+			palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+		} else
+		{
+			palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+			palette[3][k] = 0;
+		}
+	}
+	for( i = 0; i < 16; ++i )
+	{
+		for( k = 0; k < 3; ++k )
+		{
+			rgb[i*3+k] = (unsigned char)palette[(bits >> (2*i)) & 3][k];
+		}
+	}
+}
+
+static void
+	benchmark_DXT_pass
+	(
+		const char *name,
+		const unsigned char *const uncompressed,
+		int width, int height, int channels
+	)
+{
+	unsigned char *DDS_data = NULL;
+	unsigned char rgb[16*3];
+	int DDS_size, rounds = 0;
+	int block_size = ((channels & 1) == 1) ? 8 : 16;
+	int chan_step = (channels < 3) ? 0 : 1;
+	int i, j, x, y, k, index = 0;
+	double error = 0.0, seconds;
+	clock_t start = clock();
+	/*	repeat until the time is measurable	*/
+	do
+	{
+		free( DDS_data );
+		DDS_data = ((channels & 1) == 1) ?
+				convert_image_to_DXT1( uncompressed, width, height, channels, &DDS_size ) :
+				convert_image_to_DXT5( uncompressed, width, height, channels, &DDS_size );
+		++rounds;
+	} while( (NULL != DDS_data) && (clock() - start < CLOCKS_PER_SEC / 4) );
+	seconds = (double)(clock() - start) / CLOCKS_PER_SEC / rounds;
+	if( NULL == DDS_data )
+	{
+		return;
+	}
+	for( j = 0; j < height; j += 4 )
+	{
+		for( i = 0; i < width; i += 4 )
+		{
+			decode_DDS_color_block( DDS_data + index + block_size - 8, rgb );
+			index += block_size;
+			for( y = 0; (y < 4) && (j+y < height); ++y )
+			{
+				for( x = 0; (x < 4) && (i+x < width); ++x )
+				{
+					for( k = 0; k < 3; ++k )
+					{
+						double diff = (double)uncompressed[(j+y)*width*channels+(i+x)*channels+k*chan_step] - rgb[(y*4+x)*3+k];
+						error += diff * diff;
+					}
+				}
+			}
+		}
+	}
+	error /= 3.0 * width * height;
+	printf( "  %-16s %8.2f MPix/s  PSNR %6.2f dB\n", name,
+			width * (double)height / (seconds > 0.0 ? seconds : 1e-9) * 1e-6,
+			(error > 0.0) ? 10.0 * log10( 255.0 * 255.0 / error ) : 99.99 );
+	free( DDS_data );
+}
+
+void
+	benchmark_DXT_compression
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels
+	)
+{
+	static const char *const names[] = { "auto", "scalar", "SSE4.1", "AVX2" };
+	const int refinement = 4;
+	int saved_threads = DXT_thread_count;
+	int saved_refinement = DXT_refine_iterations;
+	int saved_kernel = DXT_kernel_in_use;
+	int best = best_DXT_kernel();
+	int kernel;
+	if( (width < 1) || (height < 1) ||
+		(NULL == uncompressed) ||
+		(channels < 1) || (channels > 4) )
+	{
+		return;
+	}
+	/*	one thread: clock() adds up all threads on some platforms	*/
+	DXT_thread_count = 1;
+	printf( "DXT%c compression, %dx%d, %d channels:\n",
+			((channels & 1) == 1) ? '1' : '5', width, height, channels );
+	DXT_refine_iterations = 0;
+	for( kernel = DXT_KERNEL_SCALAR; kernel <= best; ++kernel )
+	{
+		set_DXT_kernel( kernel );
+		benchmark_DXT_pass( names[kernel], uncompressed, width, height, channels );
+	}
+	DXT_refine_iterations = refinement;
+	benchmark_DXT_pass( "+ refinement x4", uncompressed, width, height, channels );
+	/*	put the settings back	*/
+	DXT_thread_count = saved_threads;
+	DXT_refine_iterations = saved_refinement;
+	if( saved_kernel != DXT_KERNEL_AUTO )
+	{
+		set_DXT_kernel( saved_kernel );
+	} else
+	{
+		DXT_block_moments = NULL;
+		DXT_block_projection = NULL;
+		DXT_kernel_in_use = DXT_KERNEL_AUTO;
+	}
+}
@@ -10,6 +10,10 @@
 #ifndef HEADER_IMAGE_DXT
 #define HEADER_IMAGE_DXT
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
 	Converts an image from an array of unsigned chars (RGB or RGBA) to
 	DXT1 or DXT5, then saves the converted image to disk.
@@ -23,6 +27,44 @@ save_image_as_DDS
     const unsigned char *const data
 );
 
+/**	the block formats save_image_as_DDS_compressed can write	**/
+enum
+{
+	DDS_COMPRESSION_DXT = 0,
+	DDS_COMPRESSION_BC4 = 1,
+	DDS_COMPRESSION_BC5 = 2,
+	DDS_COMPRESSION_BC7 = 3
+};
+
+/**
+	Converts an image from an array of unsigned chars (1 to 4 channels)
+	to one of the DDS_COMPRESSION_* block formats, then saves it to disk.
+	DDS_COMPRESSION_DXT is the same as save_image_as_DDS, BC4 and BC5
+	are written with the ATI1 and ATI2 FourCC, BC7 with a DX10 header.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+save_image_as_DDS_compressed
+(
+    const char *filename,
+    int width, int height, int channels,
+    const unsigned char *const data,
+    int compression
+);
+
+/**
+	take an image and convert it to one of the DDS_COMPRESSION_* formats
+	(DDS_COMPRESSION_DXT = DXT1 for 1 or 3 channels, DXT5 for 2 or 4)
+**/
+unsigned char*
+convert_image_to_DDS_compression
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int compression,
+    int *out_size
+);
+
 /**
 	take an image and convert it to DXT1 (no alpha)
 **/
@@ -45,6 +87,184 @@ convert_image_to_DXT5
     int *out_size
 );
 
+/**
+	take an image and convert it to BC4 (RGTC1, 8 bytes per block):
+	the first channel only, red or luminance, for single channel masks
+**/
+unsigned char*
+convert_image_to_BC4
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size
+);
+
+/**
+	take an image and convert it to BC5 (RGTC2, 16 bytes per block):
+	red and green, or luminance and alpha for 2 channels, for normal
+	maps that keep X and Y and rebuild Z in the shader
+**/
+unsigned char*
+convert_image_to_BC5
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size
+);
+
+/**
+	take an image and convert it to BC7 (BPTC, 16 bytes per block).
+	This is the fast encoder: every block is mode 6, a single RGBA colour
+	line with 16 steps.  It is a few times slower than DXT5, but the
+	RGB comes out better than DXT1 at the size of DXT5.
+**/
+unsigned char*
+convert_image_to_BC7
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size
+);
+
+/**
+	sets how many threads convert_image_to_DXT1 and convert_image_to_DXT5
+	may use (only when built with OpenMP, otherwise they stay serial).
+	0 lets the OpenMP runtime decide, 1 forces the serial path.
+	The output is the same for every thread count.
+**/
+void
+set_DXT_thread_count
+(
+    int thread_count
+);
+
+/**	the colour line fit kernels, see set_DXT_kernel	**/
+enum
+{
+	DXT_KERNEL_AUTO = 0,
+	DXT_KERNEL_SCALAR = 1,
+	DXT_KERNEL_SSE41 = 2,
+	DXT_KERNEL_AVX2 = 3
+};
+
+/**
+	selects the kernel of the colour line fit (DXT_KERNEL_*).
+	DXT_KERNEL_AUTO, or one the CPU does not support, picks the best
+	supported one.  Every kernel gives the same output.
+	Call it before compressing, not while another thread compresses.
+	\return the kernel in use
+**/
+int
+set_DXT_kernel
+(
+    int kernel
+);
+
+/**
+	selects the best supported kernel, unless one is selected already.
+	The compressors otherwise do it on their first use, without a lock,
+	so call this (or set_DXT_kernel) before several threads of your own
+	compress at the same time.
+**/
+void
+init_DXT_kernel
+(
+    void
+);
+
+/**
+	quality mode: after the colour line fit, the master colors get up
+	to this many least squares refinement passes (each one kept only
+	if the block error goes down).  0, the default, is the single pass
+	encoder with its original output.
+**/
+void
+set_DXT_refinement
+(
+    int iterations
+);
+
+/**
+	the encoder settings packed into one number: the refinement passes
+	and the kernel in use (selecting it if it is not yet), so files
+	compressed with different settings can be told apart, e.g. by a
+	cache of compressed textures
+**/
+unsigned int
+get_DXT_encoder_settings
+(
+    void
+);
+
+/**
+	compresses the image with each kernel the CPU supports, and with
+	the best one in quality mode, on one thread, then prints the speed
+	(MPix/s) and the RGB PSNR of each to stdout.
+	The kernel, refinement and thread settings are restored afterwards.
+**/
+void
+benchmark_DXT_compression
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels
+);
+
+/**
+	compress the rows of 4x4 blocks [first_row, last_row) of an image
+	into a DXT1 buffer allocated for the whole image, at their final place.
+	Rows of blocks are independent, so they can run on different threads.
+**/
+void
+compress_DXT1_block_rows
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int first_row, int last_row,
+    unsigned char *compressed
+);
+
+/**
+	the same as compress_DXT1_block_rows, for a DXT5 buffer
+**/
+void
+compress_DXT5_block_rows
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int first_row, int last_row,
+    unsigned char *compressed
+);
+
+/**
+	the same as compress_DXT1_block_rows, for a BC4, BC5 or BC7 buffer
+**/
+void
+compress_BC4_block_rows
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int first_row, int last_row,
+    unsigned char *compressed
+);
+
+void
+compress_BC5_block_rows
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int first_row, int last_row,
+    unsigned char *compressed
+);
+
+void
+compress_BC7_block_rows
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int first_row, int last_row,
+    unsigned char *compressed
+);
+
 /**	A bunch of DirectDraw Surface structures and flags **/
 typedef struct
 {
@@ -85,6 +305,17 @@ typedef struct
 }
 DDS_header ;
 
+/**	follows the DDS_header when its FourCC is DX10	**/
+typedef struct
+{
+    unsigned int    dxgiFormat;
+    unsigned int    resourceDimension;
+    unsigned int    miscFlag;
+    unsigned int    arraySize;
+    unsigned int    miscFlags2;
+}
+DDS_header_DXT10 ;
+
 /*	the following constants were copied directly off the MSDN website	*/
 
 /*	The dwFlags member of the original DDSURFACEDESC2 structure
@@ -121,4 +352,21 @@ DDS_header ;
 #define DDSCAPS2_CUBEMAP_NEGATIVEZ	0x00008000
 #define DDSCAPS2_VOLUME	0x00200000
 
+/*	DDS_header_DXT10 values	*/
+#define DXGI_FORMAT_BC1_UNORM	71
+#define DXGI_FORMAT_BC1_UNORM_SRGB	72
+#define DXGI_FORMAT_BC2_UNORM	74
+#define DXGI_FORMAT_BC2_UNORM_SRGB	75
+#define DXGI_FORMAT_BC3_UNORM	77
+#define DXGI_FORMAT_BC3_UNORM_SRGB	78
+#define DXGI_FORMAT_BC4_UNORM	80
+#define DXGI_FORMAT_BC5_UNORM	83
+#define DXGI_FORMAT_BC7_UNORM	98
+#define DXGI_FORMAT_BC7_UNORM_SRGB	99
+#define DDS_DIMENSION_TEXTURE2D	3
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* HEADER_IMAGE_DXT	*/
@@ -0,0 +1,209 @@
+/*
+	QOI ( Quite OK Image ) encoding
+
+	lossless, and an order of magnitude faster to encode than PNG
+
+	public domain
+*/
+
+#include "image_QOI.h"
+#include "qoi_helper.h"
+#include <stdio.h>
+#include <string.h>
+
+/*	the chunks are collected here, then handed on when it is nearly full	*/
+#define QOI_WRITE_BUFFER_SIZE	65536
+/*	the longest chunk is QOI_OP_RGBA, with its 4 bytes	*/
+#define QOI_LONGEST_CHUNK		5
+
+#define QOI_PIXEL(r, g, b, a)	((unsigned int)(r) | ((unsigned int)(g) << 8) | ((unsigned int)(b) << 16) | ((unsigned int)(a) << 24))
+
+static void
+	QOI_write_big_endian
+	(
+		unsigned char *buffer,
+		unsigned int value
+	)
+{
+	buffer[0] = (unsigned char)(value >> 24);
+	buffer[1] = (unsigned char)(value >> 16);
+	buffer[2] = (unsigned char)(value >> 8);
+	buffer[3] = (unsigned char)value;
+}
+
+static void
+	QOI_write_to_file
+	(
+		void *context,
+		const void *data,
+		int size
+	)
+{
+	fwrite( data, 1, size, (FILE*)context );
+}
+
+/********* Actual Exposed Functions *********/
+int
+	save_image_as_QOI_to_function
+	(
+		QOI_write_function *write_function,
+		void *context,
+		int width, int height, int channels,
+		const unsigned char *const data
+	)
+{
+	/*	variables	*/
+	unsigned char buffer[QOI_WRITE_BUFFER_SIZE];
+	unsigned int index[64];
+	unsigned int pixel, previous;
+	int position, run;
+	size_t i, count;
+	const unsigned char *source;
+	/*	error check	*/
+	if( (NULL == write_function) ||
+		(width < 1) || (height < 1) ||
+		(channels < 1) || (channels > 4) ||
+		(data == NULL ) )
+	{
+		return 0;
+	}
+	/*	the header: QOI has only RGB and RGBA, grey is expanded to them	*/
+	memcpy( buffer, QOI_MAGIC, 4 );
+	QOI_write_big_endian( buffer + 4, width );
+	QOI_write_big_endian( buffer + 8, height );
+	buffer[12] = (channels & 1) ? 3 : 4;
+	buffer[13] = 0;
+	position = QOI_HEADER_SIZE;
+	/*	the chunks	*/
+	memset( index, 0, sizeof( index ) );
+	previous = QOI_PIXEL( 0, 0, 0, 255 );
+	run = 0;
+	count = (size_t)width * height;
+	source = data;
+	for( i = 0; i < count; ++i, source += channels )
+	{
+		switch( channels )
+		{
+		case 1:
+			pixel = QOI_PIXEL( source[0], source[0], source[0], 255 );
+			break;
+		case 2:
+			pixel = QOI_PIXEL( source[0], source[0], source[0], source[1] );
+			break;
+		case 3:
+			pixel = QOI_PIXEL( source[0], source[1], source[2], 255 );
+			break;
+		default:
+			pixel = QOI_PIXEL( source[0], source[1], source[2], source[3] );
+			break;
+		}
+		if( pixel == previous )
+		{
+			if( ++run == QOI_MAX_RUN )
+			{
+				buffer[position++] = QOI_OP_RUN | (run - 1);
+				run = 0;
+			}
+		} else
+		{
+			unsigned int r = pixel & 255, g = (pixel >> 8) & 255, b = (pixel >> 16) & 255, a = pixel >> 24;
+			int slot = QOI_HASH( r, g, b, a );
+			if( run > 0 )
+			{
+				buffer[position++] = QOI_OP_RUN | (run - 1);
+				run = 0;
+			}
+			if( index[slot] == pixel )
+			{
+				buffer[position++] = QOI_OP_INDEX | slot;
+			} else
+			{
+				index[slot] = pixel;
+				if( a == (previous >> 24) )
+				{
+					/*	the differences wrap around, as the decoder adds them modulo 256	*/
+					signed char dr = (signed char)(r - (previous & 255));
+					signed char dg = (signed char)(g - ((previous >> 8) & 255));
+					signed char db = (signed char)(b - ((previous >> 16) & 255));
+					signed char dr_dg = (signed char)(dr - dg);
+					signed char db_dg = (signed char)(db - dg);
+					if( (dr > -3) && (dr < 2) && (dg > -3) && (dg < 2) && (db > -3) && (db < 2) )
+					{
+						buffer[position++] = QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2);
+					} else
+					if( (dr_dg > -9) && (dr_dg < 8) && (dg > -33) && (dg < 32) && (db_dg > -9) && (db_dg < 8) )
+					{
+						buffer[position++] = QOI_OP_LUMA | (dg + 32);
+						buffer[position++] = ((dr_dg + 8) << 4) | (db_dg + 8);
+					} else
+					{
+						buffer[position++] = QOI_OP_RGB;
+						buffer[position++] = (unsigned char)r;
+						buffer[position++] = (unsigned char)g;
+						buffer[position++] = (unsigned char)b;
+					}
+				} else
+				{
+					buffer[position++] = QOI_OP_RGBA;
+					buffer[position++] = (unsigned char)r;
+					buffer[position++] = (unsigned char)g;
+					buffer[position++] = (unsigned char)b;
+					buffer[position++] = (unsigned char)a;
+				}
+			}
+			previous = pixel;
+		}
+		/*	hand on what we have before the next pixel could overflow the buffer	*/
+		if( position > QOI_WRITE_BUFFER_SIZE - 2 * QOI_LONGEST_CHUNK )
+		{
+			write_function( context, buffer, position );
+			position = 0;
+		}
+	}
+	if( run > 0 )
+	{
+		buffer[position++] = QOI_OP_RUN | (run - 1);
+	}
+	memcpy( buffer + position, QOI_END_MARKER, QOI_END_MARKER_SIZE );
+	position += QOI_END_MARKER_SIZE;
+	write_function( context, buffer, position );
+	/*	done	*/
+	return 1;
+}
+
+int
+	save_image_as_QOI
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data
+	)
+{
+	/*	variables	*/
+	FILE *fout;
+	int result;
+	/*	error check	*/
+	if( (NULL == filename) ||
+		(width < 1) || (height < 1) ||
+		(channels < 1) || (channels > 4) ||
+		(data == NULL ) )
+	{
+		return 0;
+	}
+	/*	write it out	*/
+	fout = fopen( filename, "wb" );
+	if( NULL == fout )
+	{
+		return 0;
+	}
+	result = save_image_as_QOI_to_function( QOI_write_to_file, fout, width, height, channels, data );
+	if( ferror( fout ) )
+	{
+		result = 0;
+	}
+	if( 0 != fclose( fout ) )
+	{
+		result = 0;
+	}
+	return result;
+}
@@ -0,0 +1,52 @@
+/*
+	QOI ( Quite OK Image ) encoding
+
+	lossless, and an order of magnitude faster to encode than PNG
+
+	public domain
+*/
+
+#ifndef HEADER_IMAGE_QOI
+#define HEADER_IMAGE_QOI
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**	receives the encoded file a piece at a time	**/
+typedef void QOI_write_function( void *context, const void *data, int size );
+
+/**
+	Encodes an image from an array of unsigned chars (1 to 4 channels)
+	to QOI, and hands it to write_function as it goes, through a small
+	fixed size buffer, so the encoded file is never in memory as a whole.
+	1 channel images are written as RGB, 2 channel ones as RGBA.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+save_image_as_QOI_to_function
+(
+    QOI_write_function *write_function,
+    void *context,
+    int width, int height, int channels,
+    const unsigned char *const data
+);
+
+/**
+	Encodes an image from an array of unsigned chars (1 to 4 channels)
+	to QOI, then saves it to disk.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+save_image_as_QOI
+(
+    const char *filename,
+    int width, int height, int channels,
+    const unsigned char *const data
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_IMAGE_QOI	*/
@@ -10,6 +10,12 @@
 #include <stdlib.h>
 #include <math.h>
 
+/*	SSE2 on x86/x64, scalar code elsewhere	*/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_HELPER_SSE2
+#include <emmintrin.h>
+#endif
+
 /*	Upscaling the image uses simple bilinear interpolation	*/
 int
 	up_scale_image
@@ -151,6 +157,100 @@ int
 	return 1;
 }
 
+/*	one output row of mipmap_image_half: row0 and row1 are the two
+	source rows, step is the byte distance of the horizontal pair	*/
+static void
+	mipmap_row_half
+	(
+		const unsigned char* row0, const unsigned char* row1,
+		int step, int channels,
+		unsigned char* out, int mip_width
+	)
+{
+	int i = 0, c;
+#ifdef IMAGE_HELPER_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16( 2 );
+	if( (step != 0) && (channels == 4) )
+	{
+		/*	4 source pixels per row -> 2 output pixels, summed in 16 bits	*/
+		for( ; i + 2 <= mip_width; i += 2 )
+		{
+			__m128i a = _mm_loadu_si128( (const __m128i*)(row0 + i*8) );
+			__m128i b = _mm_loadu_si128( (const __m128i*)(row1 + i*8) );
+			__m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+			__m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+			__m128i sum = _mm_add_epi16( _mm_unpacklo_epi64( lo, hi ), _mm_unpackhi_epi64( lo, hi ) );
+			sum = _mm_srli_epi16( _mm_add_epi16( sum, round ), 2 );
+			_mm_storel_epi64( (__m128i*)(out + i*4), _mm_packus_epi16( sum, sum ) );
+		}
+	} else if( (step != 0) && (channels == 1) )
+	{
+		/*	16 source pixels per row -> 8 output pixels: even and odd bytes as 16 bit lanes	*/
+		const __m128i mask = _mm_set1_epi16( 0x00FF );
+		for( ; i + 8 <= mip_width; i += 8 )
+		{
+			__m128i a = _mm_loadu_si128( (const __m128i*)(row0 + i*2) );
+			__m128i b = _mm_loadu_si128( (const __m128i*)(row1 + i*2) );
+			__m128i sum = _mm_add_epi16(
+					_mm_add_epi16( _mm_and_si128( a, mask ), _mm_srli_epi16( a, 8 ) ),
+					_mm_add_epi16( _mm_and_si128( b, mask ), _mm_srli_epi16( b, 8 ) ) );
+			sum = _mm_srli_epi16( _mm_add_epi16( sum, round ), 2 );
+			_mm_storel_epi64( (__m128i*)(out + i), _mm_packus_epi16( sum, sum ) );
+		}
+	}
+#endif
+	/*	the rest (and every other channel count) one byte at a time	*/
+	for( ; i < mip_width; ++i )
+	{
+		for( c = 0; c < channels; ++c )
+		{
+			const int x0 = 2*i*channels + c;
+			const int x1 = x0 + step;
+			out[i*channels + c] = (unsigned char)
+				((row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) >> 2);
+		}
+	}
+}
+
+int
+	mipmap_image_half
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled
+	)
+{
+	int mip_width, mip_height;
+	int j;
+
+	/*	error check	*/
+	if( (width < 1) || (height < 1) ||
+		(channels < 1) || (orig == NULL) ||
+		(resampled == NULL) )
+	{
+		/*	nothing to do	*/
+		return 0;
+	}
+	mip_width = (width > 1) ? width / 2 : 1;
+	mip_height = (height > 1) ? height / 2 : 1;
+	/*	rows are independent, so they are split between threads
+		when built with OpenMP (small levels are not worth it)	*/
+#ifdef _OPENMP
+	#pragma omp parallel for if( mip_height >= 64 ) schedule( static )
+#endif
+	for( j = 0; j < mip_height; ++j )
+	{
+		/*	a 1 texel wide or high source pairs its only column or row with itself	*/
+		const unsigned char* row0 = orig + (2*j)*width*channels;
+		const unsigned char* row1 = (height > 1) ? row0 + width*channels : row0;
+		mipmap_row_half( row0, row1,
+				(width > 1) ? channels : 0, channels,
+				resampled + j*mip_width*channels, mip_width );
+	}
+	return 1;
+}
+
 int
 	scale_image_RGB_to_NTSC_safe
 	(
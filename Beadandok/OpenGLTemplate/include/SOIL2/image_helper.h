@@ -43,6 +43,21 @@ int
 		int block_size_x, int block_size_y
 	);
 
+/**
+	This function halves an image with a 2x2 box
+	filter, so each MIPmap level can be made from
+	the previous one.  The result is max(1, width/2)
+	by max(1, height/2), an odd last row or column
+	is dropped, following the OpenGL MIPmap sizes.
+**/
+int
+	mipmap_image_half
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled
+	);
+
 /**
 	This function takes the RGB components of the image
 	and scales each channel from [0,255] to [16,235].
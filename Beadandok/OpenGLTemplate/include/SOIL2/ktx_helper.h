@@ -0,0 +1,369 @@
+#ifndef KTX_HELPER_H
+#define KTX_HELPER_H
+
+/*	KTX 1.1 and KTX 2.0 (Khronos texture containers)
+	only KTX2 files without supercompression are read	*/
+
+#define KTX_IDENTIFIER_SIZE		12
+#define KTX_HEADER_SIZE			64
+#define KTX2_HEADER_SIZE		80
+#define KTX2_LEVEL_SIZE			24
+#define KTX_ENDIANNESS			0x04030201
+
+static const unsigned char KTX_IDENTIFIER[KTX_IDENTIFIER_SIZE] =
+	{ 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const unsigned char KTX2_IDENTIFIER[KTX_IDENTIFIER_SIZE] =
+	{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+/*	the KTX 1.1 header, after the identifier	*/
+typedef struct
+{
+	unsigned int endianness;
+	unsigned int glType;				/* 0 for compressed formats */
+	unsigned int glTypeSize;
+	unsigned int glFormat;				/* 0 for compressed formats */
+	unsigned int glInternalFormat;
+	unsigned int glBaseInternalFormat;
+	unsigned int pixelWidth;
+	unsigned int pixelHeight;			/* 0 for 1D textures */
+	unsigned int pixelDepth;			/* 0 unless 3D */
+	unsigned int numberOfArrayElements;	/* 0 unless an array */
+	unsigned int numberOfFaces;			/* 1, or 6 for cubemaps */
+	unsigned int numberOfMipmapLevels;	/* 0: generate them */
+	unsigned int bytesOfKeyValueData;
+} KTX_Header;
+
+/*	the KTX 2.0 header, after the identifier (the level index follows it)	*/
+typedef struct
+{
+	unsigned int vkFormat;
+	unsigned int typeSize;
+	unsigned int pixelWidth;
+	unsigned int pixelHeight;
+	unsigned int pixelDepth;
+	unsigned int layerCount;
+	unsigned int faceCount;
+	unsigned int levelCount;
+	unsigned int supercompressionScheme;
+	unsigned int dfdByteOffset;
+	unsigned int dfdByteLength;
+	unsigned int kvdByteOffset;
+	unsigned int kvdByteLength;
+	unsigned int sgdByteOffset[2];
+	unsigned int sgdByteLength[2];
+} KTX2_Header;
+
+/*	the families of formats, by the OpenGL capability they need	*/
+enum KTX_Family
+{
+	KTX_UNCOMPRESSED = 0,
+	KTX_S3TC,
+	KTX_RGTC,
+	KTX_BPTC,
+	KTX_ETC1
+};
+
+/*	a format both loaders know: its names in Vulkan (KTX2) and
+	OpenGL (KTX1), and the size of its blocks	*/
+typedef struct
+{
+	unsigned int vkFormat;
+	unsigned int glInternalFormat;
+	unsigned int glFormat;
+	unsigned int glType;
+	unsigned int blockSize;				/* 1 for pixels, 4 for 4x4 blocks */
+	unsigned int blockBytes;
+	int channels;
+	int family;
+	int sRGB;
+} KTX_Format;
+
+static const KTX_Format KTX_FORMATS[] =
+{
+	/*	R8, RG8, RGB8, BGR8, RGBA8 and BGRA8, UNORM and SRGB	*/
+	{   9, 0x8229, 0x1903, 0x1401, 1,  1, 1, KTX_UNCOMPRESSED, 0 },
+	{  16, 0x822B, 0x8227, 0x1401, 1,  2, 2, KTX_UNCOMPRESSED, 0 },
+	{  23, 0x8051, 0x1907, 0x1401, 1,  3, 3, KTX_UNCOMPRESSED, 0 },
+	{  29, 0x8C41, 0x1907, 0x1401, 1,  3, 3, KTX_UNCOMPRESSED, 1 },
+	{  30, 0x8051, 0x80E0, 0x1401, 1,  3, 3, KTX_UNCOMPRESSED, 0 },
+	{  36, 0x8C41, 0x80E0, 0x1401, 1,  3, 3, KTX_UNCOMPRESSED, 1 },
+	{  37, 0x8058, 0x1908, 0x1401, 1,  4, 4, KTX_UNCOMPRESSED, 0 },
+	{  43, 0x8C43, 0x1908, 0x1401, 1,  4, 4, KTX_UNCOMPRESSED, 1 },
+	{  44, 0x8058, 0x80E1, 0x1401, 1,  4, 4, KTX_UNCOMPRESSED, 0 },
+	{  50, 0x8C43, 0x80E1, 0x1401, 1,  4, 4, KTX_UNCOMPRESSED, 1 },
+	/*	BC1 (DXT1) RGB and RGBA, BC2 (DXT3), BC3 (DXT5)	*/
+	{ 131, 0x83F0, 0, 0, 4,  8, 3, KTX_S3TC, 0 },
+	{ 132, 0x8C4C, 0, 0, 4,  8, 3, KTX_S3TC, 1 },
+	{ 133, 0x83F1, 0, 0, 4,  8, 4, KTX_S3TC, 0 },
+	{ 134, 0x8C4D, 0, 0, 4,  8, 4, KTX_S3TC, 1 },
+	{ 135, 0x83F2, 0, 0, 4, 16, 4, KTX_S3TC, 0 },
+	{ 136, 0x8C4E, 0, 0, 4, 16, 4, KTX_S3TC, 1 },
+	{ 137, 0x83F3, 0, 0, 4, 16, 4, KTX_S3TC, 0 },
+	{ 138, 0x8C4F, 0, 0, 4, 16, 4, KTX_S3TC, 1 },
+	/*	BC4 and BC5 (RGTC)	*/
+	{ 139, 0x8DBB, 0, 0, 4,  8, 1, KTX_RGTC, 0 },
+	{ 141, 0x8DBD, 0, 0, 4, 16, 2, KTX_RGTC, 0 },
+	/*	BC7 (BPTC)	*/
+	{ 145, 0x8E8C, 0, 0, 4, 16, 4, KTX_BPTC, 0 },
+	{ 146, 0x8E8D, 0, 0, 4, 16, 4, KTX_BPTC, 1 },
+	/*	ETC1 has no Vulkan format, it is KTX1 only	*/
+	{   0, 0x8D64, 0, 0, 4,  8, 3, KTX_ETC1, 0 }
+};
+
+/*	what a KTX or KTX2 header says, in one form for both	*/
+typedef struct
+{
+	int version;						/* 1 or 2 */
+	unsigned int width;
+	unsigned int height;
+	unsigned int depth;					/* 0 unless 3D */
+	unsigned int layers;				/* 0 unless an array */
+	unsigned int faces;
+	unsigned int levels;				/* 0: generate them */
+	unsigned int glInternalFormat;
+	unsigned int glFormat;
+	unsigned int glType;
+	/*	KTX1: the offset of the first level, KTX2: of the level index	*/
+	unsigned int dataOffset;
+	const KTX_Format *format;			/* NULL for other uncompressed KTX1 formats */
+} KTX_Info;
+
+/*	finds the format by its Vulkan (KTX2) or OpenGL (KTX1) name	*/
+static const KTX_Format *
+	ktx_find_format
+	(
+		unsigned int vkFormat,
+		unsigned int glInternalFormat,
+		unsigned int glFormat
+	)
+{
+	unsigned int i;
+	for( i = 0; i < sizeof( KTX_FORMATS ) / sizeof( KTX_FORMATS[0] ); ++i )
+	{
+		const KTX_Format *format = &KTX_FORMATS[i];
+		if( vkFormat ?
+			(format->vkFormat == vkFormat) :
+			((format->glInternalFormat == glInternalFormat) && (format->glFormat == glFormat)) )
+		{
+			return format;
+		}
+	}
+	return NULL;
+}
+
+/*	reads the fixed size header (KTX_HEADER_SIZE bytes for KTX1, KTX2_HEADER_SIZE for KTX2)
+	return 0 if it is not a KTX file we can read, 1 or 2 if it is */
+static int
+	ktx_read_header
+	(
+		const unsigned char *buffer,
+		unsigned int length,
+		KTX_Info *info
+	)
+{
+	unsigned int max_levels;
+	if( (length >= KTX_HEADER_SIZE) &&
+		(0 == memcmp( buffer, KTX_IDENTIFIER, KTX_IDENTIFIER_SIZE )) )
+	{
+		KTX_Header header;
+		memcpy( &header, buffer + KTX_IDENTIFIER_SIZE, sizeof( KTX_Header ) );
+		/*	only files written in our (little endian) byte order	*/
+		if( header.endianness != KTX_ENDIANNESS )
+		{
+			return 0;
+		}
+		info->version = 1;
+		info->width = header.pixelWidth;
+		info->height = header.pixelHeight;
+		info->depth = header.pixelDepth;
+		info->layers = header.numberOfArrayElements;
+		info->faces = header.numberOfFaces;
+		info->levels = header.numberOfMipmapLevels;
+		info->glInternalFormat = header.glInternalFormat;
+		info->glFormat = header.glFormat;
+		info->glType = header.glType;
+		info->dataOffset = KTX_HEADER_SIZE + header.bytesOfKeyValueData;
+		info->format = ktx_find_format( 0, header.glInternalFormat, header.glFormat );
+		/*	the compressed ones need a known format	*/
+		if( (0 == header.glType) && (NULL == info->format) )
+		{
+			return 0;
+		}
+	} else
+	if( (length >= KTX2_HEADER_SIZE) &&
+		(0 == memcmp( buffer, KTX2_IDENTIFIER, KTX_IDENTIFIER_SIZE )) )
+	{
+		KTX2_Header header;
+		memcpy( &header, buffer + KTX_IDENTIFIER_SIZE, sizeof( KTX2_Header ) );
+		if( header.supercompressionScheme != 0 )
+		{
+			return 0;
+		}
+		info->version = 2;
+		info->width = header.pixelWidth;
+		info->height = header.pixelHeight;
+		info->depth = header.pixelDepth;
+		info->layers = header.layerCount;
+		info->faces = header.faceCount;
+		info->levels = header.levelCount;
+		info->format = ktx_find_format( header.vkFormat, 0, 0 );
+		if( NULL == info->format )
+		{
+			return 0;
+		}
+		info->glInternalFormat = info->format->glInternalFormat;
+		info->glFormat = info->format->glFormat;
+		info->glType = info->format->glType;
+		info->dataOffset = KTX2_HEADER_SIZE;
+	} else
+	{
+		return 0;
+	}
+	/*	1D textures are loaded as 1 pixel high 2D ones	*/
+	if( 0 == info->height )
+	{
+		info->height = 1;
+	}
+	if( (0 == info->width) || ((info->faces != 1) && (info->faces != 6)) )
+	{
+		return 0;
+	}
+	/*	no level may be smaller than 1x1x1, so there are at most 32,
+		and the size of each one is a shift by less than 32 (the loop
+		stops there too, a shift by 32 is undefined)	*/
+	max_levels = 1;
+	while( (max_levels < 32) && ((info->width | info->height | info->depth) >> max_levels) )
+	{
+		++max_levels;
+	}
+	if( info->levels > max_levels )
+	{
+		return 0;
+	}
+	return info->version;
+}
+
+/*	the bytes of one pixel of an uncompressed format, 0 if unknown	*/
+static unsigned int
+	ktx_pixel_bytes
+	(
+		unsigned int glFormat,
+		unsigned int glType
+	)
+{
+	unsigned int components, component_bytes;
+	switch( glType )
+	{
+	case 0x8032:	/* GL_UNSIGNED_BYTE_3_3_2 */
+	case 0x8362:	/* GL_UNSIGNED_BYTE_2_3_3_REV */
+		return 1;
+	case 0x8363:	/* GL_UNSIGNED_SHORT_5_6_5 */
+	case 0x8364:	/* GL_UNSIGNED_SHORT_5_6_5_REV */
+	case 0x8033:	/* GL_UNSIGNED_SHORT_4_4_4_4 */
+	case 0x8365:	/* GL_UNSIGNED_SHORT_4_4_4_4_REV */
+	case 0x8034:	/* GL_UNSIGNED_SHORT_5_5_5_1 */
+	case 0x8366:	/* GL_UNSIGNED_SHORT_1_5_5_5_REV */
+		return 2;
+	case 0x8035:	/* GL_UNSIGNED_INT_8_8_8_8 */
+	case 0x8367:	/* GL_UNSIGNED_INT_8_8_8_8_REV */
+	case 0x8036:	/* GL_UNSIGNED_INT_10_10_10_2 */
+	case 0x8368:	/* GL_UNSIGNED_INT_2_10_10_10_REV */
+	case 0x8C3B:	/* GL_UNSIGNED_INT_10F_11F_11F_REV */
+	case 0x8C3E:	/* GL_UNSIGNED_INT_5_9_9_9_REV */
+	case 0x84FA:	/* GL_UNSIGNED_INT_24_8 */
+		return 4;
+	case 0x1400:	/* GL_BYTE */
+	case 0x1401:	/* GL_UNSIGNED_BYTE */
+		component_bytes = 1;
+		break;
+	case 0x1402:	/* GL_SHORT */
+	case 0x1403:	/* GL_UNSIGNED_SHORT */
+	case 0x140B:	/* GL_HALF_FLOAT */
+		component_bytes = 2;
+		break;
+	case 0x1404:	/* GL_INT */
+	case 0x1405:	/* GL_UNSIGNED_INT */
+	case 0x1406:	/* GL_FLOAT */
+		component_bytes = 4;
+		break;
+	default:
+		return 0;
+	}
+	switch( glFormat )
+	{
+	case 0x1902:	/* GL_DEPTH_COMPONENT */
+	case 0x1903:	/* GL_RED */
+	case 0x1906:	/* GL_ALPHA */
+	case 0x1909:	/* GL_LUMINANCE */
+	case 0x8D94:	/* GL_RED_INTEGER */
+		components = 1;
+		break;
+	case 0x8227:	/* GL_RG */
+	case 0x190A:	/* GL_LUMINANCE_ALPHA */
+	case 0x8228:	/* GL_RG_INTEGER */
+		components = 2;
+		break;
+	case 0x1907:	/* GL_RGB */
+	case 0x80E0:	/* GL_BGR */
+	case 0x8D98:	/* GL_RGB_INTEGER */
+	case 0x8D9A:	/* GL_BGR_INTEGER */
+		components = 3;
+		break;
+	case 0x1908:	/* GL_RGBA */
+	case 0x80E1:	/* GL_BGRA */
+	case 0x8D99:	/* GL_RGBA_INTEGER */
+	case 0x8D9B:	/* GL_BGRA_INTEGER */
+		components = 4;
+		break;
+	default:
+		return 0;
+	}
+	return components * component_bytes;
+}
+
+/*	does size (the bytes of one face of a level, or of all its layers)
+	hold the whole width x height x depth image: OpenGL reads that much
+	from it, whatever the file says, KTX1 rows are padded to 4 bytes
+	(size is below 2 GB, the loaders get it from an int length)	*/
+static int
+	ktx_level_fits
+	(
+		const KTX_Info *info,
+		unsigned int width,
+		unsigned int height,
+		unsigned int depth,
+		unsigned int size
+	)
+{
+	unsigned int unit_bytes, row_bytes;
+	if( 0 == info->glType )
+	{
+		/*	compressed: whole blocks	*/
+		width = (width + info->format->blockSize - 1) / info->format->blockSize;
+		height = (height + info->format->blockSize - 1) / info->format->blockSize;
+		unit_bytes = info->format->blockBytes;
+	} else
+	{
+		unit_bytes = ktx_pixel_bytes( info->glFormat, info->glType );
+		if( 0 == unit_bytes )
+		{
+			return 0;
+		}
+	}
+	if( width > size / unit_bytes )
+	{
+		return 0;
+	}
+	row_bytes = width * unit_bytes;
+	if( (1 == info->version) && (0 != info->glType) )
+	{
+		row_bytes = (row_bytes + 3) & ~3u;
+	}
+	if( height > size / row_bytes )
+	{
+		return 0;
+	}
+	return depth <= size / (row_bytes * height);
+}
+
+#endif
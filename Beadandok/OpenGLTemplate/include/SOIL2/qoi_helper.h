@@ -0,0 +1,37 @@
+#ifndef QOI_HELPER_H
+#define QOI_HELPER_H
+
+/*	QOI, the "Quite OK Image" format (qoiformat.org): a 14 byte
+	header, a stream of byte aligned chunks, and an 8 byte end marker	*/
+
+#define QOI_HEADER_SIZE			14
+#define QOI_END_MARKER_SIZE		8
+
+/*	8 bit tags, then the 2 bit ones in the top bits of the chunk	*/
+#define QOI_OP_RGB				0xFE
+#define QOI_OP_RGBA				0xFF
+#define QOI_OP_INDEX			0x00
+#define QOI_OP_DIFF				0x40
+#define QOI_OP_LUMA				0x80
+#define QOI_OP_RUN				0xC0
+#define QOI_MASK_2				0xC0
+
+/*	a run is 1 to 62 pixels, 63 and 64 would collide with the 8 bit tags	*/
+#define QOI_MAX_RUN				62
+
+/*	the slot of a colour in the array of the 64 previously seen ones	*/
+#define QOI_HASH(r, g, b, a)	(((r) * 3 + (g) * 5 + (b) * 7 + (a) * 11) & 63)
+
+static const unsigned char QOI_MAGIC[4] = { 'q', 'o', 'i', 'f' };
+static const unsigned char QOI_END_MARKER[QOI_END_MARKER_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+/*	the header, its numbers are big endian in the file	*/
+typedef struct
+{
+	unsigned int width;
+	unsigned int height;
+	unsigned char channels;				/* 3 = RGB, 4 = RGBA */
+	unsigned char colorspace;			/* 0 = sRGB with linear alpha, 1 = all linear */
+} QOI_Header;
+
+#endif
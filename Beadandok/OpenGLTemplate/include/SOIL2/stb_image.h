@@ -488,6 +488,14 @@ STBIDEF int   stbi_zlib_decode_noheader_buffer(char *obuffer, int olen, const ch
 #include "stbi_pkm.h"
 #endif
 
+#ifndef STBI_NO_KTX
+#include "stbi_ktx.h"
+#endif
+
+#ifndef STBI_NO_QOI
+#include "stbi_qoi.h"
+#endif
+
 #ifndef STBI_NO_EXT
 #include "stbi_ext.h"
 #endif
@@ -897,6 +905,18 @@ static void    *stbi__pkm_load(stbi__context *s, int *x, int *y, int *comp, int
 static int      stbi__pkm_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
+#ifndef STBI_NO_KTX
+static int      stbi__ktx_test(stbi__context *s);
+static void    *stbi__ktx_load(stbi__context *s, int *x, int *y, int *comp, int req_comp);
+static int      stbi__ktx_info(stbi__context *s, int *x, int *y, int *comp, int * iscompressed);
+#endif
+
+#ifndef STBI_NO_QOI
+static int      stbi__qoi_test(stbi__context *s);
+static void    *stbi__qoi_load(stbi__context *s, int *x, int *y, int *comp, int req_comp);
+static int      stbi__qoi_info(stbi__context *s, int *x, int *y, int *comp);
+#endif
+
 // this is not threadsafe
 static const char *stbi__g_failure_reason;
 
@@ -1063,6 +1083,12 @@ static void *stbi__load_main(stbi__context *s, int *x, int *y, int *comp, int re
    #ifndef STBI_NO_PKM
    if (stbi__pkm_test(s))  return stbi__pkm_load(s,x,y,comp,req_comp);
    #endif
+   #ifndef STBI_NO_KTX
+   if (stbi__ktx_test(s))  return stbi__ktx_load(s,x,y,comp,req_comp);
+   #endif
+   #ifndef STBI_NO_QOI
+   if (stbi__qoi_test(s))  return stbi__qoi_load(s,x,y,comp,req_comp);
+   #endif
 
    #ifndef STBI_NO_HDR
    if (stbi__hdr_test(s)) {
@@ -7271,6 +7297,14 @@ static int stbi__info_main(stbi__context *s, int *x, int *y, int *comp)
    if (stbi__pkm_info(s, x, y, comp))  return 1;
    #endif
 
+   #ifndef STBI_NO_KTX
+   if (stbi__ktx_info(s, x, y, comp, NULL))  return 1;
+   #endif
+
+   #ifndef STBI_NO_QOI
+   if (stbi__qoi_info(s, x, y, comp))  return 1;
+   #endif
+
    // test tga last because it's a crappy test!
    #ifndef STBI_NO_TGA
    if (stbi__tga_info(s, x, y, comp))
@@ -7379,6 +7413,16 @@ STBIDEF int stbi_is_16_bit_from_callbacks(stbi_io_callbacks const *c, void *user
 #include "stbi_pkm_c.h"
 #endif
 
+// add in my KTX / KTX2 loading support
+#ifndef STBI_NO_KTX
+#include "stbi_ktx_c.h"
+#endif
+
+// add in my QOI loading support
+#ifndef STBI_NO_QOI
+#include "stbi_qoi_c.h"
+#endif
+
 #ifndef STBI_NO_EXT
 #include "stbi_ext_c.h"
 #endif
@@ -14,7 +14,9 @@ enum {
 	STBI_dds	= 9,
 	STBI_pvr	= 10,
 	STBI_pkm	= 11,
-	STBI_hdr	= 12
+	STBI_hdr	= 12,
+	STBI_ktx	= 13,
+	STBI_qoi	= 14
 };
 
 extern int      stbi_test_from_memory      (stbi_uc const *buffer, int len);
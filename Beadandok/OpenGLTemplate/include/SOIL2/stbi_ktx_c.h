@@ -0,0 +1,381 @@
+#include "ktx_helper.h"
+#include "etc1_utils.h"
+
+static int stbi__ktx_test(stbi__context *s)
+{
+	stbi_uc identifier[KTX_IDENTIFIER_SIZE];
+
+	//	check the identifier of both versions
+	if ( !stbi__getn( s, identifier, KTX_IDENTIFIER_SIZE ) ) {
+		stbi__rewind(s);
+		return 0;
+	}
+
+	stbi__rewind(s);
+
+	return	0 == memcmp( identifier, KTX_IDENTIFIER, KTX_IDENTIFIER_SIZE ) ||
+			0 == memcmp( identifier, KTX2_IDENTIFIER, KTX_IDENTIFIER_SIZE );
+}
+
+#ifndef STBI_NO_STDIO
+
+int      stbi__ktx_test_filename        		(char const *filename)
+{
+   int r;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return 0;
+   r = stbi__ktx_test_file(f);
+   fclose(f);
+   return r;
+}
+
+int      stbi__ktx_test_file        (FILE *f)
+{
+   stbi__context s;
+   int r,n = ftell(f);
+   stbi__start_file(&s,f);
+   r = stbi__ktx_test(&s);
+   fseek(f,n,SEEK_SET);
+   return r;
+}
+#endif
+
+int      stbi__ktx_test_memory      (stbi_uc const *buffer, int len)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer, len);
+   return stbi__ktx_test(&s);
+}
+
+int      stbi__ktx_test_callbacks      (stbi_io_callbacks const *clbk, void *user)
+{
+   stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__ktx_test(&s);
+}
+
+/*	reads the header of either version, the stream is left after it	*/
+static int stbi__ktx_read_header(stbi__context *s, KTX_Info *info)
+{
+	stbi_uc header[KTX2_HEADER_SIZE];
+
+	if ( !stbi__getn( s, header, KTX_HEADER_SIZE ) ) {
+		return 0;
+	}
+
+	//	KTX2 has a longer header
+	if ( 0 == memcmp( header, KTX2_IDENTIFIER, KTX_IDENTIFIER_SIZE ) &&
+		 !stbi__getn( s, header + KTX_HEADER_SIZE, KTX2_HEADER_SIZE - KTX_HEADER_SIZE ) ) {
+		return 0;
+	}
+
+	return ktx_read_header( header, KTX2_HEADER_SIZE, info );
+}
+
+/*	the number of channels of an uncompressed format, 0 if unknown	*/
+static int stbi__ktx_channels(const KTX_Info *info)
+{
+	if ( info->format ) {
+		return info->format->channels;
+	}
+
+	switch ( info->glFormat )
+	{
+		case 0x1903: /* GL_RED */
+		case 0x1909: /* GL_LUMINANCE */
+			return 1;
+		case 0x8227: /* GL_RG */
+		case 0x190A: /* GL_LUMINANCE_ALPHA */
+			return 2;
+		case 0x1907: /* GL_RGB */
+		case 0x80E0: /* GL_BGR */
+			return 3;
+		case 0x1908: /* GL_RGBA */
+		case 0x80E1: /* GL_BGRA */
+			return 4;
+	}
+
+	return 0;
+}
+
+static int stbi__ktx_info(stbi__context *s, int *x, int *y, int *comp, int * iscompressed )
+{
+	KTX_Info info;
+
+	if ( !stbi__ktx_read_header( s, &info ) ) {
+		stbi__rewind( s );
+		return 0;
+	}
+
+	*x = s->img_x = info.width;
+	*y = s->img_y = info.height;
+	*comp = s->img_n = stbi__ktx_channels( &info );
+
+	if ( iscompressed )
+		*iscompressed = ( 0 == info.glType );
+
+	stbi__rewind( s );
+
+	return 0 != s->img_n;
+}
+
+int stbi__ktx_info_from_memory (stbi_uc const *buffer, int len, int *x, int *y, int *comp, int * iscompressed )
+{
+	stbi__context s;
+	stbi__start_mem(&s,buffer, len);
+	return stbi__ktx_info( &s, x, y, comp, iscompressed );
+}
+
+int stbi__ktx_info_from_callbacks (stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int * iscompressed)
+{
+	stbi__context s;
+	stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+	return stbi__ktx_info( &s, x, y, comp, iscompressed );
+}
+
+#ifndef STBI_NO_STDIO
+int stbi__ktx_info_from_path(char const *filename,     int *x, int *y, int *comp, int * iscompressed)
+{
+   int res;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return 0;
+   res = stbi__ktx_info_from_file( f, x, y, comp, iscompressed );
+   fclose(f);
+   return res;
+}
+
+int stbi__ktx_info_from_file(FILE *f,                  int *x, int *y, int *comp, int * iscompressed)
+{
+   stbi__context s;
+   int res;
+   long n = ftell(f);
+   stbi__start_file(&s, f);
+   res = stbi__ktx_info(&s, x, y, comp, iscompressed);
+   fseek(f, n, SEEK_SET);
+   return res;
+}
+#endif
+
+/*	decodes a 4x4 block into RGBA, return 0 if the format can't be decoded here	*/
+static int stbi__ktx_decode_block(const KTX_Format *format, stbi_uc *compressed, stbi_uc block[16*4])
+{
+	stbi_uc etc1_block[16*3];
+	int i;
+
+	switch ( format->family )
+	{
+#ifndef STBI_NO_DDS
+		case KTX_S3TC:
+			if ( 8 == format->blockBytes ) {
+				stbi_decode_DXT1_block( block, compressed );
+			} else {
+				if ( format->glInternalFormat == 0x83F2 || format->glInternalFormat == 0x8C4E ) {
+					stbi_decode_DXT23_alpha_block( block, compressed );
+				} else {
+					stbi_decode_DXT45_alpha_block( block, compressed );
+				}
+				stbi_decode_DXT_color_block( block, compressed + 8 );
+			}
+			return 1;
+		case KTX_RGTC:
+			//	BC4 is the alpha block of DXT5, BC5 is two of them
+			stbi_decode_DXT45_alpha_block( block, compressed );
+			for ( i = 0; i < 16; ++i ) {
+				block[i*4+0] = block[i*4+3];
+			}
+			if ( 16 == format->blockBytes ) {
+				stbi_decode_DXT45_alpha_block( block, compressed + 8 );
+				for ( i = 0; i < 16; ++i ) {
+					block[i*4+1] = block[i*4+3];
+				}
+			}
+			return 1;
+#endif
+		case KTX_ETC1:
+			etc1_decode_block( (const etc1_byte*)compressed, (etc1_byte*)etc1_block );
+			for ( i = 0; i < 16; ++i ) {
+				block[i*4+0] = etc1_block[i*3+0];
+				block[i*4+1] = etc1_block[i*3+1];
+				block[i*4+2] = etc1_block[i*3+2];
+				block[i*4+3] = 255;
+			}
+			return 1;
+	}
+
+	return 0;
+}
+
+/*	decodes the first face (or layer, or slice) of the first level: the CPU
+	path for the formats the OpenGL context can't take, cubemaps get their
+	faces stacked vertically, as with DDS	*/
+static void * stbi__ktx_load(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+	KTX_Info info;
+	stbi_uc *ktx_data = NULL;
+	stbi_uc *image = NULL;
+	stbi_uc block[16*4];
+	unsigned int position, level_offset, image_size, face_stride;
+	unsigned int row_bytes, block_rows, faces, face, i;
+	int is_compressed, is_bgr = 0;
+
+	if ( !stbi__ktx_read_header( s, &info ) ) {
+		return NULL;
+	}
+
+	is_compressed = ( 0 == info.glType );
+	s->img_x = info.width;
+	s->img_y = info.height;
+	s->img_n = stbi__ktx_channels( &info );
+
+	if ( 0 == s->img_n || (!is_compressed && info.glType != 0x1401 /* GL_UNSIGNED_BYTE */) ) {
+		return stbi__errpuc( "unsupported format", "KTX pixel format can not be decoded" );
+	}
+
+	if ( !is_compressed ) {
+		is_bgr = ( info.glFormat == 0x80E0 || info.glFormat == 0x80E1 );
+	}
+
+	/*	one face (of one layer and slice) of level 0	*/
+	if ( is_compressed ) {
+		block_rows = ( info.height + 3 ) / 4;
+		row_bytes = ( ( info.width + 3 ) / 4 ) * info.format->blockBytes;
+	} else {
+		block_rows = info.height;
+		row_bytes = info.width * s->img_n;
+		//	KTX1 rows are 4 byte aligned
+		if ( 1 == info.version ) {
+			row_bytes = ( row_bytes + 3 ) & ~3u;
+		}
+	}
+	image_size = row_bytes * block_rows;
+
+	/*	find level 0	*/
+	position = ( 1 == info.version ) ? KTX_HEADER_SIZE : KTX2_HEADER_SIZE;
+	if ( 1 == info.version ) {
+		stbi__skip( s, info.dataOffset - position );
+		//	the size of the level, or of a face of a (non-array) cubemap
+		level_offset = stbi__get32le( s );
+		face_stride = ( level_offset + 3 ) & ~3u;
+	} else {
+		//	the level index starts with level 0, its data is at the end of the file
+		level_offset = stbi__get32le( s );
+		if ( stbi__get32le( s ) != 0 ) {
+			return stbi__errpuc( "too large", "KTX2 file is too large" );
+		}
+		position += 8;
+		if ( level_offset < position ) {
+			return stbi__errpuc( "bad level index", "Corrupt KTX2 file" );
+		}
+		stbi__skip( s, level_offset - position );
+		face_stride = image_size;
+	}
+
+	faces = ( 6 == info.faces && 0 == info.layers && info.width == info.height ) ? 6 : 1;
+
+	image = (stbi_uc *)malloc( image_size );
+	ktx_data = (stbi_uc *)stbi__malloc_mad3( s->img_x, s->img_y * faces, s->img_n, 0 );
+	if ( NULL == image || NULL == ktx_data ) {
+		free( image );
+		free( ktx_data );
+		return stbi__errpuc( "outofmem", "Out of memory" );
+	}
+
+	for ( face = 0; face < faces; ++face ) {
+		stbi_uc *out = ktx_data + face * s->img_x * s->img_y * s->img_n;
+
+		if ( face > 0 ) {
+			stbi__skip( s, face_stride - image_size );
+		}
+
+		if ( !stbi__getn( s, image, image_size ) ) {
+			free( image );
+			free( ktx_data );
+			return stbi__errpuc( "truncated", "KTX file was too small for expected image data" );
+		}
+
+		if ( !is_compressed ) {
+			for ( i = 0; i < s->img_y; ++i ) {
+				memcpy( out + i * s->img_x * s->img_n, image + i * row_bytes, s->img_x * s->img_n );
+			}
+		} else {
+			unsigned int bx, by, px, py, blocks_x = ( info.width + 3 ) / 4;
+
+			for ( by = 0; by < block_rows; ++by ) {
+				for ( bx = 0; bx < blocks_x; ++bx ) {
+					if ( !stbi__ktx_decode_block( info.format, image + by * row_bytes + bx * info.format->blockBytes, block ) ) {
+						free( image );
+						free( ktx_data );
+						return stbi__errpuc( "unsupported format", "KTX compressed format can not be decoded" );
+					}
+
+					//	drop the block into the image, the partial ones too
+					for ( py = 0; py < 4 && by * 4 + py < s->img_y; ++py ) {
+						for ( px = 0; px < 4 && bx * 4 + px < s->img_x; ++px ) {
+							stbi_uc *pixel = out + ( ( by * 4 + py ) * s->img_x + bx * 4 + px ) * s->img_n;
+							memcpy( pixel, &block[( py * 4 + px ) * 4], s->img_n );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	free( image );
+
+	s->img_y *= faces;
+
+	if ( is_bgr ) {
+		for ( i = 0; i < s->img_x * s->img_y * s->img_n; i += s->img_n ) {
+			stbi_uc temp = ktx_data[i];
+			ktx_data[i] = ktx_data[i+2];
+			ktx_data[i+2] = temp;
+		}
+	}
+
+	*x = s->img_x;
+	*y = s->img_y;
+	*comp = s->img_n;
+
+	if( (req_comp <= 4) && (req_comp >= 1) ) {
+		//	user has some requirements, meet them
+		if( req_comp != s->img_n ) {
+			ktx_data = stbi__convert_format( ktx_data, s->img_n, req_comp, s->img_x, s->img_y );
+			*comp = req_comp;
+		}
+	}
+
+	return ktx_data;
+}
+
+#ifndef STBI_NO_STDIO
+void *stbi__ktx_load_from_file   (FILE *f,                  int *x, int *y, int *comp, int req_comp)
+{
+	stbi__context s;
+	stbi__start_file(&s,f);
+	return stbi__ktx_load(&s,x,y,comp,req_comp);
+}
+
+void *stbi__ktx_load_from_path             (char const*filename,           int *x, int *y, int *comp, int req_comp)
+{
+   void *data;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return NULL;
+   data = stbi__ktx_load_from_file(f,x,y,comp,req_comp);
+   fclose(f);
+   return data;
+}
+#endif
+
+void *stbi__ktx_load_from_memory (stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer, len);
+   return stbi__ktx_load(&s,x,y,comp,req_comp);
+}
+
+void *stbi__ktx_load_from_callbacks (stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+{
+	stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__ktx_load(&s,x,y,comp,req_comp);
+}
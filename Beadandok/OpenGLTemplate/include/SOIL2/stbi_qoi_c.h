@@ -0,0 +1,265 @@
+#include "qoi_helper.h"
+
+static int stbi__qoi_test(stbi__context *s)
+{
+	stbi_uc magic[4];
+
+	//	check the magic number
+	if ( !stbi__getn( s, magic, 4 ) ) {
+		stbi__rewind(s);
+		return 0;
+	}
+
+	stbi__rewind(s);
+
+	return 0 == memcmp( magic, QOI_MAGIC, 4 );
+}
+
+#ifndef STBI_NO_STDIO
+
+int      stbi__qoi_test_filename        		(char const *filename)
+{
+   int r;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return 0;
+   r = stbi__qoi_test_file(f);
+   fclose(f);
+   return r;
+}
+
+int      stbi__qoi_test_file        (FILE *f)
+{
+   stbi__context s;
+   int r,n = ftell(f);
+   stbi__start_file(&s,f);
+   r = stbi__qoi_test(&s);
+   fseek(f,n,SEEK_SET);
+   return r;
+}
+#endif
+
+int      stbi__qoi_test_memory      (stbi_uc const *buffer, int len)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer, len);
+   return stbi__qoi_test(&s);
+}
+
+int      stbi__qoi_test_callbacks      (stbi_io_callbacks const *clbk, void *user)
+{
+   stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__qoi_test(&s);
+}
+
+/*	reads and checks the header, the stream is left after it	*/
+static int stbi__qoi_read_header(stbi__context *s, QOI_Header *header)
+{
+	stbi_uc magic[4];
+
+	if ( !stbi__getn( s, magic, 4 ) || 0 != memcmp( magic, QOI_MAGIC, 4 ) ) {
+		return 0;
+	}
+
+	header->width = stbi__get32be( s );
+	header->height = stbi__get32be( s );
+	header->channels = stbi__get8( s );
+	header->colorspace = stbi__get8( s );
+
+	if ( ( header->channels != 3 && header->channels != 4 ) || header->colorspace > 1 ) {
+		return 0;
+	}
+
+	//	the pixels of an RGBA copy have to fit in an int
+	return	0 < header->width && header->width <= 0x7FFFFFFF &&
+			0 < header->height && header->height <= 0x7FFFFFFF &&
+			stbi__mad3sizes_valid( (int)header->width, (int)header->height, 4, 0 );
+}
+
+static int stbi__qoi_info(stbi__context *s, int *x, int *y, int *comp )
+{
+	QOI_Header header;
+
+	if ( !stbi__qoi_read_header( s, &header ) ) {
+		stbi__rewind( s );
+		return 0;
+	}
+
+	*x = s->img_x = header.width;
+	*y = s->img_y = header.height;
+	*comp = s->img_n = header.channels;
+
+	stbi__rewind( s );
+
+	return 1;
+}
+
+int stbi__qoi_info_from_memory (stbi_uc const *buffer, int len, int *x, int *y, int *comp )
+{
+	stbi__context s;
+	stbi__start_mem(&s,buffer, len);
+	return stbi__qoi_info( &s, x, y, comp );
+}
+
+int stbi__qoi_info_from_callbacks (stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp)
+{
+	stbi__context s;
+	stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+	return stbi__qoi_info( &s, x, y, comp );
+}
+
+#ifndef STBI_NO_STDIO
+int stbi__qoi_info_from_path(char const *filename,     int *x, int *y, int *comp)
+{
+   int res;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return 0;
+   res = stbi__qoi_info_from_file( f, x, y, comp );
+   fclose(f);
+   return res;
+}
+
+int stbi__qoi_info_from_file(FILE *f,                  int *x, int *y, int *comp)
+{
+   stbi__context s;
+   int res;
+   long n = ftell(f);
+   stbi__start_file(&s, f);
+   res = stbi__qoi_info(&s, x, y, comp);
+   fseek(f, n, SEEK_SET);
+   return res;
+}
+#endif
+
+static void * stbi__qoi_load(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+	QOI_Header header;
+	stbi_uc index[64][4];
+	stbi_uc pixel[4];
+	stbi_uc *qoi_data;
+	stbi_uc *dest;
+	size_t i, count;
+	int out_n;
+	int run = 0;
+
+	if ( !stbi__qoi_read_header( s, &header ) ) {
+		return stbi__errpuc("bad QOI", "Corrupt QOI header");
+	}
+
+	*x = s->img_x = header.width;
+	*y = s->img_y = header.height;
+	*comp = s->img_n = header.channels;
+
+	//	decode straight to RGB or RGBA when that is asked for, grey is converted after
+	out_n = ( req_comp == 3 || req_comp == 4 ) ? req_comp : s->img_n;
+
+	qoi_data = (stbi_uc *)stbi__malloc_mad3( s->img_x, s->img_y, out_n, 0 );
+
+	if ( NULL == qoi_data ) {
+		return stbi__errpuc("outofmem", "Out of memory");
+	}
+
+	memset( index, 0, sizeof( index ) );
+	pixel[0] = pixel[1] = pixel[2] = 0;
+	pixel[3] = 255;
+
+	//	a truncated file reads as zeros, which are QOI_OP_INDEX chunks: no harm done
+	count = (size_t)s->img_x * s->img_y;
+	dest = qoi_data;
+
+	for ( i = 0; i < count; ++i, dest += out_n ) {
+		if ( run > 0 ) {
+			--run;
+		} else {
+			int chunk = stbi__get8( s );
+
+			if ( chunk == QOI_OP_RGB ) {
+				pixel[0] = stbi__get8( s );
+				pixel[1] = stbi__get8( s );
+				pixel[2] = stbi__get8( s );
+			} else if ( chunk == QOI_OP_RGBA ) {
+				pixel[0] = stbi__get8( s );
+				pixel[1] = stbi__get8( s );
+				pixel[2] = stbi__get8( s );
+				pixel[3] = stbi__get8( s );
+			} else {
+				switch ( chunk & QOI_MASK_2 ) {
+					case QOI_OP_INDEX:
+						memcpy( pixel, index[chunk], 4 );
+						break;
+					case QOI_OP_DIFF:
+						pixel[0] += ( ( chunk >> 4 ) & 3 ) - 2;
+						pixel[1] += ( ( chunk >> 2 ) & 3 ) - 2;
+						pixel[2] += ( chunk & 3 ) - 2;
+						break;
+					case QOI_OP_LUMA: {
+						int next = stbi__get8( s );
+						int dg = ( chunk & 63 ) - 32;
+						pixel[0] += dg - 8 + ( ( next >> 4 ) & 15 );
+						pixel[1] += dg;
+						pixel[2] += dg - 8 + ( next & 15 );
+						break;
+					}
+					default:
+						run = chunk & 63;
+						break;
+				}
+			}
+
+			memcpy( index[ QOI_HASH( pixel[0], pixel[1], pixel[2], pixel[3] ) ], pixel, 4 );
+		}
+
+		dest[0] = pixel[0];
+		dest[1] = pixel[1];
+		dest[2] = pixel[2];
+
+		if ( 4 == out_n ) {
+			dest[3] = pixel[3];
+		}
+	}
+
+	s->img_n = out_n;
+
+	if( (req_comp <= 4) && (req_comp >= 1) ) {
+		//	user has some requirements, meet them
+		if( req_comp != s->img_n ) {
+			qoi_data = stbi__convert_format( qoi_data, s->img_n, req_comp, s->img_x, s->img_y );
+			*comp = req_comp;
+		}
+	}
+
+	return qoi_data;
+}
+
+#ifndef STBI_NO_STDIO
+void *stbi__qoi_load_from_file   (FILE *f,                  int *x, int *y, int *comp, int req_comp)
+{
+	stbi__context s;
+	stbi__start_file(&s,f);
+	return stbi__qoi_load(&s,x,y,comp,req_comp);
+}
+
+void *stbi__qoi_load_from_path             (char const*filename,           int *x, int *y, int *comp, int req_comp)
+{
+   void *data;
+   FILE *f = fopen(filename, "rb");
+   if (!f) return NULL;
+   data = stbi__qoi_load_from_file(f,x,y,comp,req_comp);
+   fclose(f);
+   return data;
+}
+#endif
+
+void *stbi__qoi_load_from_memory (stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer, len);
+   return stbi__qoi_load(&s,x,y,comp,req_comp);
+}
+
+void *stbi__qoi_load_from_callbacks (stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+{
+	stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__qoi_load(&s,x,y,comp,req_comp);
+}
@@ -0,0 +1,129 @@
+/*
+	regression test for the KTX header checks of ktx_helper.h
+
+	needs nothing but the header, build and run it with e.g.
+		cc -fsanitize=address,undefined -o test_ktx_header test_ktx_header.c && ./test_ktx_header
+	it exits with 0 when every check passes (a hang is a failure too)
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../ktx_helper.h"
+
+static int failures = 0;
+
+static void
+	put_uint
+	(
+		unsigned char *buffer,
+		unsigned int value
+	)
+{
+	buffer[0] = (unsigned char)value;
+	buffer[1] = (unsigned char)(value >> 8);
+	buffer[2] = (unsigned char)(value >> 16);
+	buffer[3] = (unsigned char)(value >> 24);
+}
+
+/*	an RGBA8 KTX1 header, one face	*/
+static void
+	make_ktx1
+	(
+		unsigned char *buffer,
+		unsigned int width,
+		unsigned int height,
+		unsigned int levels
+	)
+{
+	memset( buffer, 0, KTX_HEADER_SIZE );
+	memcpy( buffer, KTX_IDENTIFIER, KTX_IDENTIFIER_SIZE );
+	put_uint( buffer + 12, KTX_ENDIANNESS );
+	put_uint( buffer + 16, 0x1401 );	/* GL_UNSIGNED_BYTE */
+	put_uint( buffer + 20, 1 );
+	put_uint( buffer + 24, 0x1908 );	/* GL_RGBA */
+	put_uint( buffer + 28, 0x8058 );	/* GL_RGBA8 */
+	put_uint( buffer + 32, 0x1908 );
+	put_uint( buffer + 36, width );
+	put_uint( buffer + 40, height );
+	put_uint( buffer + 52, 1 );
+	put_uint( buffer + 56, levels );
+}
+
+/*	an R8G8B8A8_UNORM KTX2 header, one face	*/
+static void
+	make_ktx2
+	(
+		unsigned char *buffer,
+		unsigned int width,
+		unsigned int height,
+		unsigned int levels
+	)
+{
+	memset( buffer, 0, KTX2_HEADER_SIZE );
+	memcpy( buffer, KTX2_IDENTIFIER, KTX_IDENTIFIER_SIZE );
+	put_uint( buffer + 12, 37 );
+	put_uint( buffer + 16, 1 );
+	put_uint( buffer + 20, width );
+	put_uint( buffer + 24, height );
+	put_uint( buffer + 36, 1 );
+	put_uint( buffer + 40, levels );
+}
+
+static void
+	check
+	(
+		const char *name,
+		int result,
+		int expected
+	)
+{
+	if( result != expected )
+	{
+		printf( "FAILED: %s returned %d instead of %d\n", name, result, expected );
+		++failures;
+	}
+}
+
+int
+	main
+	(
+		void
+	)
+{
+	unsigned char buffer[KTX2_HEADER_SIZE];
+	KTX_Info info;
+
+	/*	a small image: 4x4 has 3 levels	*/
+	make_ktx1( buffer, 4, 4, 3 );
+	check( "KTX1 4x4, 3 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 1 );
+	make_ktx1( buffer, 4, 4, 4 );
+	check( "KTX1 4x4, 4 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 0 );
+
+	/*	a dimension with bit 31 set (from a fuzzed file): the level count
+		loop used to shift by 32 there and never stop	*/
+	make_ktx1( buffer, 0x9b000007u, 1, 0 );
+	check( "KTX1 0x9b000007 wide, no levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 1 );
+	make_ktx1( buffer, 0x9b000007u, 1, 32 );
+	check( "KTX1 0x9b000007 wide, 32 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 1 );
+	make_ktx1( buffer, 1, 0x80000000u, 33 );
+	check( "KTX1 2^31 high, 33 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 0 );
+	make_ktx2( buffer, 0x80000000u, 1, 32 );
+	check( "KTX2 2^31 wide, 32 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 2 );
+	make_ktx2( buffer, 0xFFFFFFFFu, 0xFFFFFFFFu, 33 );
+	check( "KTX2 2^32-1 wide and high, 33 levels", ktx_read_header( buffer, sizeof( buffer ), &info ), 0 );
+
+	/*	such a level never fits in the file	*/
+	make_ktx1( buffer, 0x9b000007u, 1, 1 );
+	ktx_read_header( buffer, sizeof( buffer ), &info );
+	check( "0x9b000007 wide level in 64 bytes", ktx_level_fits( &info, info.width, info.height, 1, 64 ), 0 );
+	make_ktx1( buffer, 4, 4, 1 );
+	ktx_read_header( buffer, sizeof( buffer ), &info );
+	check( "4x4 RGBA8 level in 64 bytes", ktx_level_fits( &info, 4, 4, 1, 64 ), 1 );
+	check( "4x4 RGBA8 level in 63 bytes", ktx_level_fits( &info, 4, 4, 1, 63 ), 0 );
+
+	if( 0 == failures )
+	{
+		printf( "all KTX header checks passed\n" );
+	}
+	return (0 == failures) ? 0 : 1;
+}
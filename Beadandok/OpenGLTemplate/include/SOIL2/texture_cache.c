@@ -0,0 +1,446 @@
+/*
+	Texture cache
+
+	on-disk cache of the textures made from image files
+
+	Public Domain
+*/
+
+#include "texture_cache.h"
+#include "image_DXT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*	the index lives next to the cached files, one line per file:
+	the key, the size in kilobytes and the time of the last use	*/
+#define TEXTURE_CACHE_INDEX		"soil2_cache.idx"
+#define TEXTURE_CACHE_PATH_MAX	1024
+#define TEXTURE_CACHE_LINE_MAX	256
+
+typedef struct
+{
+	texture_cache_key key;
+	unsigned long kilobytes;
+	unsigned long last_use;
+}
+texture_cache_entry;
+
+static char cache_directory[TEXTURE_CACHE_PATH_MAX];
+static int cache_is_open = 0;
+static unsigned long cache_max_kilobytes = 0;
+static unsigned long cache_kilobytes = 0;
+/*	a use counter rather than the wall clock, it is saved in the index	*/
+static unsigned long cache_clock = 0;
+static texture_cache_entry *cache_entries = NULL;
+static int cache_entry_count = 0;
+static int cache_entry_capacity = 0;
+/*	hits only touch the index in memory, it is written on a miss or close	*/
+static int cache_index_dirty = 0;
+
+/********* Helper Functions *********/
+static int
+	cache_path
+	(
+		const char *name,
+		char path[TEXTURE_CACHE_PATH_MAX]
+	)
+{
+	if( strlen( cache_directory ) + strlen( name ) + 2 > TEXTURE_CACHE_PATH_MAX )
+	{
+		return 0;
+	}
+	strcpy( path, cache_directory );
+	strcat( path, "/" );
+	strcat( path, name );
+	return 1;
+}
+
+static int
+	cache_key_path
+	(
+		const texture_cache_key *key,
+		char path[TEXTURE_CACHE_PATH_MAX]
+	)
+{
+	char name[64];
+	sprintf( name, "%08x%08x%08x%08x%x_%x.dds",
+			key->hash[0], key->hash[1], key->length, key->flags, key->force_channels, key->encoder );
+	return cache_path( name, path );
+}
+
+static int
+	same_key
+	(
+		const texture_cache_key *a,
+		const texture_cache_key *b
+	)
+{
+	return (a->hash[0] == b->hash[0]) && (a->hash[1] == b->hash[1]) &&
+		(a->length == b->length) && (a->flags == b->flags) &&
+		(a->force_channels == b->force_channels) && (a->encoder == b->encoder);
+}
+
+static int
+	find_entry
+	(
+		const texture_cache_key *key
+	)
+{
+	int i;
+	for( i = 0; i < cache_entry_count; ++i )
+	{
+		if( same_key( &cache_entries[i].key, key ) )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int
+	add_entry
+	(
+		const texture_cache_key *key,
+		unsigned long kilobytes,
+		unsigned long last_use
+	)
+{
+	if( cache_entry_count == cache_entry_capacity )
+	{
+		int capacity = (cache_entry_capacity > 0) ? cache_entry_capacity * 2 : 64;
+		texture_cache_entry *entries = (texture_cache_entry*)realloc(
+				cache_entries, capacity * sizeof( texture_cache_entry ) );
+		if( NULL == entries )
+		{
+			return -1;
+		}
+		cache_entries = entries;
+		cache_entry_capacity = capacity;
+	}
+	cache_entries[cache_entry_count].key = *key;
+	cache_entries[cache_entry_count].kilobytes = kilobytes;
+	cache_entries[cache_entry_count].last_use = last_use;
+	cache_kilobytes += kilobytes;
+	return cache_entry_count++;
+}
+
+/*	forgets the entry, and deletes its file if asked to	*/
+static void
+	remove_entry
+	(
+		int index,
+		int delete_file
+	)
+{
+	char path[TEXTURE_CACHE_PATH_MAX];
+	if( delete_file && cache_key_path( &cache_entries[index].key, path ) )
+	{
+		remove( path );
+	}
+	cache_kilobytes -= cache_entries[index].kilobytes;
+	cache_entries[index] = cache_entries[--cache_entry_count];
+	cache_index_dirty = 1;
+}
+
+static int
+	save_index
+	(
+		void
+	)
+{
+	char path[TEXTURE_CACHE_PATH_MAX];
+	FILE *fout;
+	int i;
+	if( !cache_path( TEXTURE_CACHE_INDEX, path ) )
+	{
+		return 0;
+	}
+	fout = fopen( path, "w" );
+	if( NULL == fout )
+	{
+		return 0;
+	}
+	for( i = 0; i < cache_entry_count; ++i )
+	{
+		const texture_cache_entry *entry = &cache_entries[i];
+		fprintf( fout, "%08x %08x %08x %08x %x %x %lu %lu\n",
+				entry->key.hash[0], entry->key.hash[1], entry->key.length,
+				entry->key.flags, entry->key.force_channels, entry->key.encoder,
+				entry->kilobytes, entry->last_use );
+	}
+	fclose( fout );
+	cache_index_dirty = 0;
+	return 1;
+}
+
+static void
+	load_index
+	(
+		void
+	)
+{
+	char path[TEXTURE_CACHE_PATH_MAX];
+	char line[TEXTURE_CACHE_LINE_MAX];
+	FILE *fin;
+	texture_cache_key key;
+	unsigned long kilobytes, last_use;
+	if( !cache_path( TEXTURE_CACHE_INDEX, path ) )
+	{
+		return;
+	}
+	fin = fopen( path, "r" );
+	if( NULL == fin )
+	{
+		/*	a new cache	*/
+		return;
+	}
+	while( NULL != fgets( line, sizeof( line ), fin ) )
+	{
+		if( sscanf( line, "%x %x %x %x %x %x %lu %lu",
+				&key.hash[0], &key.hash[1], &key.length,
+				&key.flags, &key.force_channels, &key.encoder,
+				&kilobytes, &last_use ) != 8 )
+		{
+			/*	a line of the index before the encoder was in the key:
+				its file can not be matched any more, remove it	*/
+			if( sscanf( line, "%x %x %x %x %x %lu %lu",
+					&key.hash[0], &key.hash[1], &key.length,
+					&key.flags, &key.force_channels,
+					&kilobytes, &last_use ) == 7 )
+			{
+				char name[64];
+				sprintf( name, "%08x%08x%08x%08x%x.dds",
+						key.hash[0], key.hash[1], key.length, key.flags, key.force_channels );
+				if( cache_path( name, path ) )
+				{
+					remove( path );
+				}
+			}
+			continue;
+		}
+		if( add_entry( &key, kilobytes, last_use ) < 0 )
+		{
+			break;
+		}
+		if( last_use > cache_clock )
+		{
+			cache_clock = last_use;
+		}
+	}
+	fclose( fin );
+}
+
+/********* Actual Exposed Functions *********/
+int
+	texture_cache_open
+	(
+		const char *directory,
+		unsigned long max_kilobytes
+	)
+{
+	texture_cache_close();
+	if( (NULL == directory) ||
+		(strlen( directory ) + 64 > TEXTURE_CACHE_PATH_MAX) )
+	{
+		return 0;
+	}
+	strcpy( cache_directory, directory );
+	cache_max_kilobytes = max_kilobytes;
+	cache_is_open = 1;
+	load_index();
+	/*	also tells if the directory is there and writable	*/
+	if( !save_index() )
+	{
+		texture_cache_close();
+		return 0;
+	}
+	return 1;
+}
+
+void
+	texture_cache_close
+	(
+		void
+	)
+{
+	if( cache_is_open && cache_index_dirty )
+	{
+		save_index();
+	}
+	free( cache_entries );
+	cache_entries = NULL;
+	cache_entry_count = 0;
+	cache_entry_capacity = 0;
+	cache_kilobytes = 0;
+	cache_clock = 0;
+	cache_index_dirty = 0;
+	cache_is_open = 0;
+}
+
+int
+	texture_cache_is_open
+	(
+		void
+	)
+{
+	return cache_is_open;
+}
+
+/*	Two 32 bit hashes over little endian words (FNV-1a and a
+	multiply-xorshift), so a warm load reads the source about
+	as fast as the disk gives it.	*/
+void
+	texture_cache_make_key
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int flags,
+		int force_channels,
+		texture_cache_key *key
+	)
+{
+	unsigned int h0 = 2166136261u;
+	unsigned int h1 = 0x9747b28cu;
+	int i;
+	for( i = 0; i + 4 <= buffer_length; i += 4 )
+	{
+		unsigned int word =
+			(unsigned int)buffer[i] | ((unsigned int)buffer[i+1] << 8) |
+			((unsigned int)buffer[i+2] << 16) | ((unsigned int)buffer[i+3] << 24);
+		h0 = (h0 ^ word) * 16777619u;
+		h1 = (h1 ^ word) * 0x5bd1e995u;
+		h1 ^= h1 >> 15;
+	}
+	for( ; i < buffer_length; ++i )
+	{
+		h0 = (h0 ^ buffer[i]) * 16777619u;
+		h1 = (h1 ^ buffer[i]) * 0x5bd1e995u;
+		h1 ^= h1 >> 15;
+	}
+	key->hash[0] = h0 & 0xffffffffu;
+	key->hash[1] = h1 & 0xffffffffu;
+	key->length = (unsigned int)buffer_length;
+	key->flags = flags;
+	key->force_channels = (unsigned int)force_channels;
+	key->encoder = get_DXT_encoder_settings();
+}
+
+unsigned char*
+	texture_cache_read
+	(
+		const texture_cache_key *key,
+		int *length
+	)
+{
+	char path[TEXTURE_CACHE_PATH_MAX];
+	FILE *fin;
+	unsigned char *data = NULL;
+	long file_length;
+	int index = cache_is_open ? find_entry( key ) : -1;
+	*length = 0;
+	if( (index < 0) || !cache_key_path( key, path ) )
+	{
+		return NULL;
+	}
+	fin = fopen( path, "rb" );
+	if( NULL != fin )
+	{
+		fseek( fin, 0, SEEK_END );
+		file_length = ftell( fin );
+		fseek( fin, 0, SEEK_SET );
+		if( file_length > 0 )
+		{
+			data = (unsigned char*)malloc( file_length );
+		}
+		if( (NULL != data) && (fread( data, 1, file_length, fin ) != (size_t)file_length) )
+		{
+			free( data );
+			data = NULL;
+		}
+		fclose( fin );
+	}
+	if( NULL == data )
+	{
+		/*	deleted or truncated behind our back	*/
+		remove_entry( index, 0 );
+		return NULL;
+	}
+	cache_entries[index].last_use = ++cache_clock;
+	cache_index_dirty = 1;
+	*length = (int)file_length;
+	return data;
+}
+
+int
+	texture_cache_write
+	(
+		const texture_cache_key *key,
+		const unsigned char *const data,
+		int length
+	)
+{
+	char path[TEXTURE_CACHE_PATH_MAX];
+	FILE *fout;
+	unsigned long kilobytes = ((unsigned long)length + 1023) / 1024;
+	int index;
+	if( !cache_is_open || (NULL == data) || (length < 1) ||
+		(kilobytes > cache_max_kilobytes) ||
+		!cache_key_path( key, path ) )
+	{
+		return 0;
+	}
+	index = find_entry( key );
+	if( index >= 0 )
+	{
+		remove_entry( index, 0 );
+	}
+	fout = fopen( path, "wb" );
+	if( NULL == fout )
+	{
+		return 0;
+	}
+	if( fwrite( data, 1, length, fout ) != (size_t)length )
+	{
+		fclose( fout );
+		remove( path );
+		return 0;
+	}
+	fclose( fout );
+	index = add_entry( key, kilobytes, ++cache_clock );
+	if( index < 0 )
+	{
+		remove( path );
+		return 0;
+	}
+	/*	evict the least recently used files, the new one is the
+		most recent, so it is never picked	*/
+	while( cache_kilobytes > cache_max_kilobytes )
+	{
+		int i, oldest = 0;
+		for( i = 1; i < cache_entry_count; ++i )
+		{
+			if( cache_entries[i].last_use < cache_entries[oldest].last_use )
+			{
+				oldest = i;
+			}
+		}
+		remove_entry( oldest, 1 );
+	}
+	save_index();
+	return 1;
+}
+
+void
+	texture_cache_remove
+	(
+		const texture_cache_key *key
+	)
+{
+	int index = cache_is_open ? find_entry( key ) : -1;
+	if( index >= 0 )
+	{
+		remove_entry( index, 1 );
+		save_index();
+	}
+}
@@ -0,0 +1,114 @@
+/*
+	Texture cache
+
+	on-disk cache of the textures made from image files:
+	one DDS file per texture, named by a hash of the source
+	image and the load flags, evicted least recently used first
+
+	Public Domain
+*/
+
+#ifndef HEADER_TEXTURE_CACHE
+#define HEADER_TEXTURE_CACHE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	The cache key: a hash of the source file contents,
+	and of the flags and forced channels it was loaded with.
+**/
+typedef struct
+{
+	unsigned int hash[2];
+	unsigned int length;
+	unsigned int flags;
+	unsigned int force_channels;
+	unsigned int encoder;			/* see get_DXT_encoder_settings */
+}
+texture_cache_key;
+
+/**
+	Opens the cache in directory (which must exist) and reads its
+	index.  max_kilobytes limits the size of all the cached files
+	together.  An already open cache is closed first.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	texture_cache_open
+	(
+		const char *directory,
+		unsigned long max_kilobytes
+	);
+
+/**
+	Writes the index (with the order of the latest hits)
+	and closes the cache.
+**/
+void
+	texture_cache_close
+	(
+		void
+	);
+
+/**	\return 1 if a cache is open	**/
+int
+	texture_cache_is_open
+	(
+		void
+	);
+
+/**
+	Makes the key of a source file in memory, together with the
+	current DXT encoder settings.
+**/
+void
+	texture_cache_make_key
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int flags,
+		int force_channels,
+		texture_cache_key *key
+	);
+
+/**
+	Reads the cached file of key and marks it as the most
+	recently used one.
+	\return the file contents (free() it), or NULL on a miss
+**/
+unsigned char*
+	texture_cache_read
+	(
+		const texture_cache_key *key,
+		int *length
+	);
+
+/**
+	Stores data as the cached file of key, then evicts the least
+	recently used files until the cache fits its size limit again.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	texture_cache_write
+	(
+		const texture_cache_key *key,
+		const unsigned char *const data,
+		int length
+	);
+
+/**
+	Drops the cached file of key, e.g. when it can not be used.
+**/
+void
+	texture_cache_remove
+	(
+		const texture_cache_key *key
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_TEXTURE_CACHE	*/
@@ -0,0 +1,451 @@
+/** Aszinkron textúra betöltés: a dekódolás és a CPU oldali feldolgozás munkaszálakon fut, a GL szál pixel unpack bufferekből tölt fel, képkockánként korlátozott mennyiséget. */
+/** Asynchronous texture loading: decoding and CPU processing run on worker threads, the GL thread uploads from pixel unpack buffers, a limited amount per frame. */
+#ifndef ASYNC_TEXTURES_CPP
+#define ASYNC_TEXTURES_CPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <GL/glew.h>
+#include <mutex>
+#include <SOIL2/image_DXT.h>
+#include <SOIL2/image_helper.h>
+#include <SOIL2/SOIL2.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** A feltöltésre váró adatot ennyi, körbe járó staging buffer viszi; amíg a GPU még olvas egyet, abba nem írunk. */
+/** The data waiting for upload goes through this many staging buffers in a ring; one the GPU still reads is not written. */
+const GLuint	asyncTextureStagingCount = 3;
+const GLubyte	asyncTexturePlaceholder[] = { 128, 128, 128, 255 };	// grey, until the image arrives
+
+typedef struct {
+	GLsizei	width, height;
+	size_t	offset, size;			// in AsyncTextureJob::data
+} AsyncTextureLevel;
+
+/** Egy kért textúra: a munkaszál tölti ki a szintjeit, utána csak a GL szál nyúl hozzá. */
+/** One requested texture: a worker fills its levels, from then on only the GL thread touches it. */
+typedef struct {
+	GLuint							texture;		// the placeholder handle, it keeps its name
+	std::string						fileName;
+	int								forceChannels;
+	unsigned int					flags;
+	int								channels;
+	int								compression;	// DDS_COMPRESSION_*, or -1 for uncompressed levels
+	std::vector<unsigned char>		data;			// every level, the finest first; compressed as DDS blocks
+	std::vector<AsyncTextureLevel>	levels;			// empty if the load failed
+	GLenum							internalFormat, format;
+	GLsizei							blockBytes;		// 0 for uncompressed levels
+	int								level;			// upload progress, from the coarsest level down to 0
+	GLsizei							row;
+} AsyncTextureJob;
+
+typedef struct {
+	std::vector<std::thread>		workers;
+	std::mutex						mutex;
+	std::condition_variable			wake;
+	std::deque<AsyncTextureJob*>	decodeQueue, uploadQueue;	// guarded by the mutex
+	bool							stopping;					// guarded by the mutex
+	GLint							maxSize;					// the capabilities are queried once, workers only read them
+	bool							dxt, dxtSrgb, rgtc, bptc;
+	AsyncTextureJob					*uploading;					// the rest is owned by the GL thread
+	GLuint							stagingBuffers[asyncTextureStagingCount];
+	GLsync							fences[asyncTextureStagingCount];
+	GLuint							nextStaging;
+	GLsizeiptr						stagingSize;
+	size_t							pending;
+} AsyncTextureLoader;
+
+/** Egy feltöltési darab: egy szint egymás utáni sorai (tömörített szintnél blokksorai). */
+/** One upload chunk: consecutive rows of a level (block rows of a compressed level). */
+typedef struct {
+	AsyncTextureJob	*job;
+	int				level;
+	GLsizei			row, rows;
+	GLintptr		offset;
+	bool			staged;					// false: too wide for the staging buffer, uploaded from client memory
+} AsyncTextureChunk;
+
+/** Ugyanaz a feldolgozás, mint SOIL_internal_create_OGL_texture-ben, de GL hívás nélkül; a mipmapek is itt készülnek, a SOIL_FLAG_GL_MIPMAPS is CPU oldalon. */
+/** The same processing as in SOIL_internal_create_OGL_texture, but without GL calls; the mipmaps are made here too, SOIL_FLAG_GL_MIPMAPS on the CPU as well. */
+void decodeAsyncTexture(const AsyncTextureLoader &loader, AsyncTextureJob &job) {
+	int							width, height, channels;
+	unsigned char				*loaded = SOIL_load_image(job.fileName.c_str(), &width, &height, &channels, job.forceChannels);
+	std::vector<unsigned char>	image, next;
+
+	if (loaded == nullptr) return;
+	if (job.forceChannels >= SOIL_LOAD_L && job.forceChannels <= SOIL_LOAD_RGBA) channels = job.forceChannels;
+	image.assign(loaded, loaded + (size_t)width * height * channels);
+	SOIL_free_image_data(loaded);
+	job.channels = channels;
+
+	if (job.flags & SOIL_FLAG_INVERT_Y)
+		for (int j = 0; j * 2 < height; j++)
+			std::swap_ranges(image.begin() + (size_t)j * width * channels, image.begin() + (size_t)(j + 1) * width * channels, image.begin() + (size_t)(height - 1 - j) * width * channels);
+	if (job.flags & SOIL_FLAG_NTSC_SAFE_RGB) scale_image_RGB_to_NTSC_safe(image.data(), width, height, channels);
+	if ((job.flags & SOIL_FLAG_MULTIPLY_ALPHA) && (channels == 2 || channels == 4))
+		for (size_t i = 0; i < image.size(); i += channels)
+			for (int c = 0; c < channels - 1; c++)
+				image[i + c] = (unsigned char)((image[i + c] * image[i + channels - 1] + 128) >> 8);
+
+	/** Kettő hatványra a SOIL szabályai szerint: kérésre, CPU mipmapekhez, vagy ha túl nagy a GL-nek. */
+	/** Power of two by SOIL's rules: when asked for, for CPU mipmaps, or when it is too large for GL. */
+	if ((job.flags & (SOIL_FLAG_POWER_OF_TWO | SOIL_FLAG_MIPMAPS)) || width > loader.maxSize || height > loader.maxSize) {
+		int	newWidth = 1, newHeight = 1;
+
+		while (newWidth < width) newWidth *= 2;
+		while (newHeight < height) newHeight *= 2;
+		if (newWidth != width || newHeight != height) {
+			next.resize((size_t)newWidth * newHeight * channels);
+			up_scale_image(image.data(), width, height, channels, next.data(), newWidth, newHeight);
+			image.swap(next);
+			width	= newWidth;
+			height	= newHeight;
+		}
+	}
+	if (width > loader.maxSize || height > loader.maxSize) {
+		int	blockX = std::max(width / loader.maxSize, 1), blockY = std::max(height / loader.maxSize, 1);
+
+		next.resize((size_t)(width / blockX) * (height / blockY) * channels);
+		mipmap_image(image.data(), width, height, channels, next.data(), blockX, blockY);
+		image.swap(next);
+		width	/= blockX;
+		height	/= blockY;
+	}
+	if (job.flags & SOIL_FLAG_CoCg_Y) convert_RGB_to_YCoCg(image.data(), width, height, channels);
+
+	/** A tömörítés sorrendje is a SOIL-é: BC7, BC5, BC4, DXT, amit a kontextus nem ismer, az kimarad, végül tömörítetlen. */
+	/** The order of the compressions is SOIL's as well: BC7, BC5, BC4, DXT, the ones the context lacks are skipped, in the end it is uncompressed. */
+	job.compression = -1;
+	if ((job.flags & SOIL_FLAG_COMPRESS_TO_BC7) && loader.bptc)			job.compression = DDS_COMPRESSION_BC7;
+	else if ((job.flags & SOIL_FLAG_COMPRESS_TO_BC5) && loader.rgtc)	job.compression = DDS_COMPRESSION_BC5;
+	else if ((job.flags & SOIL_FLAG_COMPRESS_TO_BC4) && loader.rgtc)	job.compression = DDS_COMPRESSION_BC4;
+	else if ((job.flags & SOIL_FLAG_COMPRESS_TO_DXT) && loader.dxt)		job.compression = DDS_COMPRESSION_DXT;
+
+	for (;;) {
+		AsyncTextureLevel	level = { width, height, job.data.size(), image.size() };
+
+		if (job.compression >= 0) {
+			int				size;
+			unsigned char	*blocks = convert_image_to_DDS_compression(image.data(), width, height, channels, job.compression, &size);
+
+			if (blocks == nullptr) {
+				job.levels.clear();
+				return;
+			}
+			level.size = size;
+			job.data.insert(job.data.end(), blocks, blocks + size);
+			SOIL_free_image_data(blocks);
+		}
+		else job.data.insert(job.data.end(), image.begin(), image.end());
+		job.levels.push_back(level);
+
+		if (!(job.flags & (SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS)) || (width == 1 && height == 1)) break;
+		next.resize((size_t)std::max(width / 2, 1) * std::max(height / 2, 1) * channels);
+		mipmap_image_half(image.data(), width, height, channels, next.data());
+		image.swap(next);
+		width	= std::max(width / 2, 1);
+		height	= std::max(height / 2, 1);
+	}
+}
+
+void asyncTextureWorker(AsyncTextureLoader &loader) {
+	std::unique_lock<std::mutex>	lock(loader.mutex);
+
+	for (;;) {
+		loader.wake.wait(lock, [&loader] { return loader.stopping || !loader.decodeQueue.empty(); });
+		if (loader.stopping) return;
+
+		AsyncTextureJob	*job = loader.decodeQueue.front();
+
+		loader.decodeQueue.pop_front();
+		lock.unlock();
+		decodeAsyncTexture(loader, *job);
+		lock.lock();
+		loader.uploadQueue.push_back(job);
+	}
+}
+
+/** A GL szálon, egyszer: képességek lekérdezése (ugyanazok, mint a SOIL_load_OGL_texture-ben), staging bufferek és a munkaszálak.
+	A DXT kernelt is itt választjuk ki, mielőtt a munkaszálak egyszerre tömörítenének. A stagingSize a képkockánkénti feltöltés felső korlátja is. */
+/** On the GL thread, once: queries the capabilities (the same ones as in SOIL_load_OGL_texture), makes the staging buffers and the workers.
+	The DXT kernel is selected here too, before the workers could compress at the same time. stagingSize is also the upper limit of one frame's upload. */
+void initAsyncTextureLoader(AsyncTextureLoader &loader, GLuint workerCount, GLsizeiptr stagingSize) {
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &loader.maxSize);
+	loader.dxt			= SOIL_GL_compression_supported(SOIL_FLAG_COMPRESS_TO_DXT) != 0;
+	loader.dxtSrgb		= loader.dxt && SOIL_GL_ExtensionSupported("GL_EXT_texture_sRGB") != 0;
+	loader.rgtc			= SOIL_GL_compression_supported(SOIL_FLAG_COMPRESS_TO_BC5) != 0;
+	loader.bptc			= SOIL_GL_compression_supported(SOIL_FLAG_COMPRESS_TO_BC7) != 0;
+	init_DXT_kernel();
+	loader.stopping		= false;
+	loader.uploading	= nullptr;
+	loader.nextStaging	= 0;
+	loader.stagingSize	= stagingSize;
+	loader.pending		= 0;
+
+	glGenBuffers(asyncTextureStagingCount, loader.stagingBuffers);
+	for (GLuint i = 0; i < asyncTextureStagingCount; i++) {
+		loader.fences[i] = 0;
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader.stagingBuffers[i]);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, stagingSize, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	for (GLuint i = 0; i < std::max(workerCount, 1u); i++)
+		loader.workers.emplace_back(asyncTextureWorker, std::ref(loader));
+}
+
+/** A GL szálon: azonnal visszaad egy 1x1-es szürke helyőrző textúrát, a kép később ugyanebbe a névbe érkezik. A flags a SOIL_load_OGL_texture-éi, a textúra téglalap kivételével. */
+/** On the GL thread: returns a 1x1 grey placeholder texture at once, the image arrives later into the same name. The flags are the ones of SOIL_load_OGL_texture, except texture rectangles. */
+GLuint loadTextureAsync(AsyncTextureLoader &loader, const char *fileName, int forceChannels, unsigned int flags) {
+	GLuint	texture;
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, asyncTexturePlaceholder);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (flags & (SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS)) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (flags & SOIL_FLAG_TEXTURE_REPEATS) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (flags & SOIL_FLAG_TEXTURE_REPEATS) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+
+	AsyncTextureJob	*job = new AsyncTextureJob();
+
+	job->texture		= texture;
+	job->fileName		= fileName;
+	job->forceChannels	= forceChannels;
+	job->flags			= flags & ~SOIL_FLAG_TEXTURE_RECTANGLE;
+	loader.pending++;
+	{
+		std::lock_guard<std::mutex>	lock(loader.mutex);
+		loader.decodeQueue.push_back(job);
+	}
+	loader.wake.notify_one();
+
+	return texture;
+}
+
+/** A formátumok a csatornaszámból és a tömörítésből; az 1 és 2 csatornás képek swizzle-lel olvasnak úgy, mint a SOIL luminance textúrái (core profilban nincs GL_LUMINANCE). */
+/** The formats from the channel count and the compression; 1 and 2 channel images read through a swizzle like SOIL's luminance textures (there is no GL_LUMINANCE in the core profile). */
+void startAsyncTexture(const AsyncTextureLoader &loader, AsyncTextureJob &job) {
+	const GLenum	formats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	bool			srgb = (job.flags & SOIL_FLAG_SRGB_COLOR_SPACE) != 0;
+
+	job.format		= formats[job.channels - 1];
+	job.blockBytes	= 16;
+	switch (job.compression) {
+	case DDS_COMPRESSION_DXT:
+		job.blockBytes		= (job.channels & 1) ? 8 : 16;
+		job.internalFormat	= (job.channels & 1) ?
+			((srgb && loader.dxtSrgb) ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT) :
+			((srgb && loader.dxtSrgb) ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		break;
+	case DDS_COMPRESSION_BC4:
+		job.blockBytes		= 8;
+		job.internalFormat	= GL_COMPRESSED_RED_RGTC1;
+		break;
+	case DDS_COMPRESSION_BC5:
+		job.internalFormat	= GL_COMPRESSED_RG_RGTC2;
+		break;
+	case DDS_COMPRESSION_BC7:
+		job.internalFormat	= srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+		break;
+	default:
+		const GLenum	internalFormats[] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 }, srgbFormats[] = { GL_R8, GL_RG8, GL_SRGB8, GL_SRGB8_ALPHA8 };
+		const GLint		swizzles[][4] = { { GL_RED, GL_RED, GL_RED, GL_ONE }, { GL_RED, GL_RED, GL_RED, GL_GREEN } };
+
+		job.blockBytes		= 0;
+		job.internalFormat	= srgb ? srgbFormats[job.channels - 1] : internalFormats[job.channels - 1];
+		glBindTexture(GL_TEXTURE_2D, job.texture);
+		if (job.channels <= 2) glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzles[job.channels - 1]);
+		break;
+	}
+	job.level	= (int)job.levels.size() - 1;
+	job.row		= 0;
+}
+
+/** Egy szint sorának (blokksorának) mérete és magassága. */
+/** Size and height of one row (block row) of a level. */
+void asyncTextureRow(const AsyncTextureJob &job, const AsyncTextureLevel &level, GLsizeiptr &bytes, GLsizei &rows) {
+	if (job.blockBytes) {
+		bytes	= (GLsizeiptr)((level.width + 3) / 4) * job.blockBytes;
+		rows	= 4;
+	}
+	else {
+		bytes	= (GLsizeiptr)level.width * job.channels;
+		rows	= 1;
+	}
+}
+
+/** Staging bufferből az eltolással, különben közvetlenül a kliens memóriából. */
+/** From the staging buffer at its offset, otherwise straight from client memory. */
+void uploadAsyncTextureChunk(const AsyncTextureChunk &chunk) {
+	const AsyncTextureJob	&job = *chunk.job;
+	const AsyncTextureLevel	&level = job.levels[chunk.level];
+	GLsizeiptr				rowBytes;
+	GLsizei					rowHeight;
+	const void				*pixels;
+
+	asyncTextureRow(job, level, rowBytes, rowHeight);
+	if (chunk.staged)	pixels = (const void*)chunk.offset;
+	else				pixels = job.data.data() + level.offset + (size_t)(chunk.row / rowHeight) * rowBytes;
+	glBindTexture(GL_TEXTURE_2D, job.texture);
+	if (job.blockBytes)
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, chunk.level, 0, chunk.row, level.width, chunk.rows, job.internalFormat, (GLsizei)(((chunk.rows + 3) / 4) * rowBytes), pixels);
+	else
+		glTexSubImage2D(GL_TEXTURE_2D, chunk.level, 0, chunk.row, level.width, chunk.rows, job.format, GL_UNSIGNED_BYTE, pixels);
+}
+
+/** A GL szálon, képkockánként egyszer: legfeljebb budget bájtot (és egy staging buffernyit) tölt fel, akkor is csak ha a soron következő staging buffert a GPU már elengedte, így sosem vár. Visszaadja az elkészült textúrák számát. */
+/** On the GL thread, once per frame: uploads at most budget bytes (and one staging buffer), and only if the GPU has already released the next staging buffer, so it never waits. Returns the number of textures finished. */
+GLuint updateAsyncTextures(AsyncTextureLoader &loader, GLsizeiptr budget) {
+	std::vector<AsyncTextureChunk>	chunks;
+	std::vector<AsyncTextureJob*>	done;
+	GLuint							slot = loader.nextStaging;
+	GLsizeiptr						used = 0;
+	unsigned char					*staging = nullptr;
+	GLint							unpackAlignment;
+
+	if (loader.pending == 0) return 0;
+	if (loader.fences[slot]) {
+		if (glClientWaitSync(loader.fences[slot], 0, 0) == GL_TIMEOUT_EXPIRED) return 0;
+		glDeleteSync(loader.fences[slot]);
+		loader.fences[slot] = 0;
+	}
+	budget = std::min(budget, loader.stagingSize);
+
+	/** Először a darabok összegyűjtése és bemásolása a staging bufferbe... */
+	/** First the chunks are collected and copied into the staging buffer... */
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader.stagingBuffers[slot]);
+	while (used < budget) {
+		if (loader.uploading == nullptr) {
+			{
+				std::lock_guard<std::mutex>	lock(loader.mutex);
+				if (loader.uploadQueue.empty()) break;
+				loader.uploading = loader.uploadQueue.front();
+				loader.uploadQueue.pop_front();
+			}
+			if (loader.uploading->levels.empty()) {
+				/** Sikertelen betöltés: a helyőrző marad. */
+				/** Failed load: the placeholder stays. */
+				done.push_back(loader.uploading);
+				loader.uploading = nullptr;
+				continue;
+			}
+			startAsyncTexture(loader, *loader.uploading);
+		}
+
+		AsyncTextureJob			&job = *loader.uploading;
+		const AsyncTextureLevel	&level = job.levels[job.level];
+		GLsizeiptr				rowBytes;
+		GLsizei					rowHeight;
+
+		asyncTextureRow(job, level, rowBytes, rowHeight);
+
+		GLsizei					rowsLeft = (level.height - job.row + rowHeight - 1) / rowHeight;
+		GLsizei					fit = (GLsizei)std::min<GLsizeiptr>((budget - used) / rowBytes, rowsLeft);
+		AsyncTextureChunk		chunk = { &job, job.level, job.row, 0, used, true };
+
+		/** Egy sor mindig átmegy, ha ez a képkocka még semmit sem töltött, különben egy széles textúra sosem haladna. */
+		/** One row always goes through if this frame has not uploaded anything yet, otherwise a wide texture would never advance. */
+		if (fit == 0) {
+			if (used > 0) break;
+			fit				= 1;
+			chunk.staged	= rowBytes <= loader.stagingSize;
+		}
+		chunk.rows = std::min(fit * rowHeight, level.height - job.row);
+		if (chunk.staged) {
+			if (staging == nullptr)
+				staging = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, loader.stagingSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			if (staging == nullptr) break;
+			memcpy(staging + used, job.data.data() + level.offset + (size_t)(job.row / rowHeight) * rowBytes, (size_t)fit * rowBytes);
+		}
+		chunks.push_back(chunk);
+		used += (GLsizeiptr)fit * rowBytes;
+
+		job.row += chunk.rows;
+		if (job.row >= level.height) {
+			job.row = 0;
+			if (--job.level < 0) {
+				done.push_back(&job);
+				loader.uploading = nullptr;
+			}
+		}
+	}
+	if (staging != nullptr) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	/** ...utána a feltöltések, a szintek helyfoglalása az első darabjuknál. A szinteket a legdurvábbtól töltjük, és a BASE_LEVEL mindig egy teljes szintre mutat; egyetlen szintnél a helyőrző az 1-es szintre költözik, amíg a 0-s töltődik. */
+	/** ...then the uploads, the storage of a level is allocated at its first chunk. The levels are filled from the coarsest one, and BASE_LEVEL always points to a complete level; with a single level the placeholder moves to level 1 while level 0 is filled. */
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (const AsyncTextureChunk &chunk : chunks) {
+		const AsyncTextureJob	&job = *chunk.job;
+		const AsyncTextureLevel	&level = job.levels[chunk.level];
+
+		if (chunk.row == 0) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glBindTexture(GL_TEXTURE_2D, job.texture);
+			if (job.levels.size() == 1) {
+				glTexImage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, asyncTexturePlaceholder);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 1);
+			}
+			if (job.blockBytes)
+				glCompressedTexImage2D(GL_TEXTURE_2D, chunk.level, job.internalFormat, level.width, level.height, 0, (GLsizei)level.size, nullptr);
+			else
+				glTexImage2D(GL_TEXTURE_2D, chunk.level, job.internalFormat, level.width, level.height, 0, job.format, GL_UNSIGNED_BYTE, nullptr);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, chunk.staged ? loader.stagingBuffers[slot] : 0);
+		uploadAsyncTextureChunk(chunk);
+		if (chunk.row + chunk.rows >= level.height) {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)job.levels.size() - 1);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, chunk.level);
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+	if (!chunks.empty()) {
+		loader.fences[slot]	= glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		loader.nextStaging	= (slot + 1) % asyncTextureStagingCount;
+	}
+	for (AsyncTextureJob *job : done) delete job;
+	loader.pending -= done.size();
+
+	return (GLuint)done.size();
+}
+
+/** A még be nem fejezett kérések száma, pl. egy töltőképernyőhöz. */
+/** The number of requests not finished yet, e.g. for a loading screen. */
+size_t pendingAsyncTextures(const AsyncTextureLoader &loader) {
+	return loader.pending;
+}
+
+/** A munkaszálak leállítása és a félkész kérések eldobása; a kiadott textúrák a hívóéi maradnak. */
+/** Stops the workers and drops the unfinished requests; the textures handed out stay with the caller. */
+void deleteAsyncTextureLoader(AsyncTextureLoader &loader) {
+	{
+		std::lock_guard<std::mutex>	lock(loader.mutex);
+		loader.stopping = true;
+	}
+	loader.wake.notify_all();
+	for (std::thread &worker : loader.workers) worker.join();
+	loader.workers.clear();
+
+	for (AsyncTextureJob *job : loader.decodeQueue) delete job;
+	for (AsyncTextureJob *job : loader.uploadQueue) delete job;
+	delete loader.uploading;
+	loader.decodeQueue.clear();
+	loader.uploadQueue.clear();
+	loader.uploading	= nullptr;
+	loader.pending		= 0;
+
+	for (GLuint i = 0; i < asyncTextureStagingCount; i++)
+		if (loader.fences[i]) glDeleteSync(loader.fences[i]);
+	glDeleteBuffers(asyncTextureStagingCount, loader.stagingBuffers);
+}
+#endif
@@ -0,0 +1,438 @@
+/** Kör-szakasz ütközésvizsgálat: egységes rácsos durva szűrés és pontos közelipont-számítás. */
+/** Circle vs segment collision detection: uniform grid broadphase and exact closest point narrowphase. */
+#ifndef COLLISION_CPP
+#define COLLISION_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <simdDispatch.cpp>
+#include <vector>
+
+float distBetween(const glm::vec2 &a, const glm::vec2 &b) {
+	float	dx = b.x - a.x;
+	float	dy = b.y - a.y;
+
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+/** A szakasz kör középponthoz legközelebbi pontja, a Hazi metszesCheck számítása. */
+/** Closest point of the segment to the circle center, the computation of Hazi's metszesCheck. */
+glm::vec2 closestPointOnSegment(const glm::vec2 &circPos, const glm::vec2 &lineStart, const glm::vec2 &lineEnd) {
+	glm::vec2	lineDir		= lineEnd - lineStart;
+	float		lineLength	= std::sqrt(lineDir.x * lineDir.x + lineDir.y * lineDir.y);
+	glm::vec2	lineNorm	= lineDir / lineLength;
+	glm::vec2	toCircle	= circPos - lineStart;
+	float		proj		= toCircle.x * lineNorm.x + toCircle.y * lineNorm.y;
+
+	if (proj <= 0) return lineStart;
+	if (proj >= lineLength) return lineEnd;
+	return lineStart + lineNorm * proj;
+}
+
+bool circleSegmentOverlap(const glm::vec2 &circPos, float radius, const glm::vec2 &lineStart, const glm::vec2 &lineEnd) {
+	return distBetween(circPos, closestPointOnSegment(circPos, lineStart, lineEnd)) <= radius;
+}
+
+typedef struct {
+	glm::vec2	start, end;
+} Segment;
+
+/** Egy jelölt pár a pontos vizsgálathoz: kör index és szakasz index. */
+/** One candidate pair for the narrowphase: circle index and segment index. */
+typedef struct {
+	GLuint	circle;
+	GLuint	segment;
+} CollisionPair;
+
+/** Egységes rács a szakaszok felett; minden cella a bele lógó szakaszok indexeit tárolja. */
+/** Uniform grid over the segments; every cell stores the indices of the segments overlapping it. */
+typedef struct {
+	glm::vec2							origin;
+	GLfloat								cellSize;
+	GLint								columns, rows;
+	std::vector<std::vector<GLuint>>	cells;
+	std::vector<Segment>				segments;
+	std::vector<glm::ivec4>				segmentCells;	// (minX, minY, maxX, maxY) cell range of each segment
+	std::vector<GLuint>					visited;		// query stamp per segment, removes duplicates
+	GLuint								stamp;
+} SegmentGrid;
+
+void initSegmentGrid(SegmentGrid &grid, const glm::vec2 &origin, const glm::vec2 &size, GLfloat cellSize) {
+	grid.origin		= origin;
+	grid.cellSize	= cellSize;
+	grid.columns	= std::max(1, (GLint)std::ceil(size.x / cellSize));
+	grid.rows		= std::max(1, (GLint)std::ceil(size.y / cellSize));
+	grid.stamp		= 0;
+	grid.cells.assign((size_t)grid.columns * grid.rows, std::vector<GLuint>());
+	grid.segments.clear();
+	grid.segmentCells.clear();
+	grid.visited.clear();
+}
+
+/** A befoglaló téglalap cellatartománya, a rácson kívüli részek a szélső cellákba kerülnek. */
+/** Cell range of a bounding box, parts outside the grid fall into the border cells. */
+glm::ivec4 gridCellRange(const SegmentGrid &grid, const glm::vec2 &boxMin, const glm::vec2 &boxMax) {
+	glm::vec2	low		= (boxMin - grid.origin) / grid.cellSize;
+	glm::vec2	high	= (boxMax - grid.origin) / grid.cellSize;
+
+	return glm::ivec4(
+		glm::clamp((GLint)std::floor(low.x), 0, grid.columns - 1),
+		glm::clamp((GLint)std::floor(low.y), 0, grid.rows - 1),
+		glm::clamp((GLint)std::floor(high.x), 0, grid.columns - 1),
+		glm::clamp((GLint)std::floor(high.y), 0, grid.rows - 1));
+}
+
+glm::ivec4 segmentCellRange(const SegmentGrid &grid, const Segment &segment) {
+	return gridCellRange(grid, glm::min(segment.start, segment.end), glm::max(segment.start, segment.end));
+}
+
+void insertIntoCells(SegmentGrid &grid, GLuint id, const glm::ivec4 &range) {
+	for (GLint y = range.y; y <= range.w; y++)
+		for (GLint x = range.x; x <= range.z; x++)
+			grid.cells[(size_t)y * grid.columns + x].push_back(id);
+}
+
+void removeFromCells(SegmentGrid &grid, GLuint id, const glm::ivec4 &range) {
+	for (GLint y = range.y; y <= range.w; y++)
+		for (GLint x = range.x; x <= range.z; x++) {
+			std::vector<GLuint>	&cell = grid.cells[(size_t)y * grid.columns + x];
+			auto				found = std::find(cell.begin(), cell.end(), id);
+
+			if (found != cell.end()) {
+				*found = cell.back();
+				cell.pop_back();
+			}
+		}
+}
+
+GLuint addSegment(SegmentGrid &grid, const glm::vec2 &start, const glm::vec2 &end) {
+	GLuint	id = (GLuint)grid.segments.size();
+
+	grid.segments.push_back({ start, end });
+	grid.segmentCells.push_back(segmentCellRange(grid, grid.segments.back()));
+	grid.visited.push_back(0);
+	insertIntoCells(grid, id, grid.segmentCells.back());
+
+	return id;
+}
+
+/** Inkrementális frissítés: csak akkor nyúl a cellákhoz, ha a cellatartomány megváltozott. */
+/** Incremental update: touches the cells only when the cell range changed. */
+void moveSegment(SegmentGrid &grid, GLuint id, const glm::vec2 &start, const glm::vec2 &end) {
+	grid.segments[id] = { start, end };
+
+	glm::ivec4	range = segmentCellRange(grid, grid.segments[id]);
+	if (range == grid.segmentCells[id]) return;
+
+	removeFromCells(grid, id, grid.segmentCells[id]);
+	insertIntoCells(grid, id, range);
+	grid.segmentCells[id] = range;
+}
+
+/** Egy befoglaló téglalap jelölt szakaszai, minden szakasz legfeljebb egyszer. */
+/** Candidate segments of a bounding box, every segment at most once. */
+void queryBox(SegmentGrid &grid, GLuint circle, const glm::vec2 &boxMin, const glm::vec2 &boxMax, std::vector<CollisionPair> &pairs) {
+	glm::ivec4	range = gridCellRange(grid, boxMin, boxMax);
+
+	if (++grid.stamp == 0) {
+		std::fill(grid.visited.begin(), grid.visited.end(), 0);
+		grid.stamp = 1;
+	}
+	for (GLint y = range.y; y <= range.w; y++)
+		for (GLint x = range.x; x <= range.z; x++)
+			for (GLuint id : grid.cells[(size_t)y * grid.columns + x])
+				if (grid.visited[id] != grid.stamp) {
+					grid.visited[id] = grid.stamp;
+					pairs.push_back({ circle, id });
+				}
+}
+
+void queryCircle(SegmentGrid &grid, GLuint circle, const glm::vec2 &center, GLfloat radius, std::vector<CollisionPair> &pairs) {
+	queryBox(grid, circle, center - radius, center + radius, pairs);
+}
+
+/** Durva szűrés SoA körtömbökre: a jelölt párok egy kötegben, a pontos vizsgálat előtt. */
+/** Broadphase over SoA circle arrays: the candidate pairs in one batch, before the narrowphase. */
+void collectCandidatePairs(SegmentGrid &grid, const GLfloat *posX, const GLfloat *posY, const GLfloat *radius, size_t count, std::vector<CollisionPair> &pairs) {
+	pairs.clear();
+	for (size_t i = 0; i < count; i++)
+		queryCircle(grid, (GLuint)i, glm::vec2(posX[i], posY[i]), radius[i], pairs);
+}
+
+/** Pontos vizsgálat: a valóban metsző párokat a jelöltek elejére tömöríti, visszaadja a számukat. */
+/** Narrowphase: compacts the really intersecting pairs to the front of the candidates, returns their count. */
+size_t narrowphasePairs(const SegmentGrid &grid, const GLfloat *posX, const GLfloat *posY, const GLfloat *radius, std::vector<CollisionPair> &pairs) {
+	size_t	hits = 0;
+
+	for (const CollisionPair &pair : pairs) {
+		const Segment	&segment = grid.segments[pair.segment];
+
+		if (circleSegmentOverlap(glm::vec2(posX[pair.circle], posY[pair.circle]), radius[pair.circle], segment.start, segment.end))
+			pairs[hits++] = pair;
+	}
+	pairs.resize(hits);
+
+	return hits;
+}
+/** Szakaszok SoA kötegben a kötegelt teszthez; az irány és a hossz négyzetének reciproka előre számolt. */
+/** Segments in an SoA batch for the batched test; direction and reciprocal squared length are precomputed. */
+typedef struct {
+	std::vector<GLfloat>	startX, startY;
+	std::vector<GLfloat>	dirX, dirY;
+	std::vector<GLfloat>	invLengthSq;	// 0 for degenerate segments, their closest point is the start
+} SegmentBatch;
+
+size_t segmentBatchSize(const SegmentBatch &batch) {
+	return batch.startX.size();
+}
+
+/** A bitmaszk sorának hossza 32 bites szavakban. */
+/** Length of one bitmask row in 32 bit words. */
+size_t hitMaskWords(size_t segmentCount) {
+	return (segmentCount + 31) / 32;
+}
+
+void buildSegmentBatch(SegmentBatch &batch, const std::vector<Segment> &segments) {
+	size_t	count = segments.size();
+
+	batch.startX.resize(count);
+	batch.startY.resize(count);
+	batch.dirX.resize(count);
+	batch.dirY.resize(count);
+	batch.invLengthSq.resize(count);
+
+	for (size_t i = 0; i < count; i++) {
+		glm::vec2	dir			= segments[i].end - segments[i].start;
+		GLfloat		lengthSq	= dir.x * dir.x + dir.y * dir.y;
+
+		batch.startX[i]			= segments[i].start.x;
+		batch.startY[i]			= segments[i].start.y;
+		batch.dirX[i]			= dir.x;
+		batch.dirY[i]			= dir.y;
+		batch.invLengthSq[i]	= lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+	}
+}
+
+#if defined(SIMD_X86)
+/** Az AVX kernel 8 szakaszonként; a feldolgozott elemek számát adja vissza, a maradék a skalár kódé. */
+/** The AVX kernel, 8 segments at a time; returns the number of elements done, the rest is left to the scalar code. */
+SIMD_TARGET("avx") size_t intersectCircleSegmentsAVX(const SegmentBatch &batch, GLfloat circX, GLfloat circY, GLfloat radiusSq, GLuint *hitMask, GLfloat *param) {
+	const GLfloat	*startX			= batch.startX.data();
+	const GLfloat	*startY			= batch.startY.data();
+	const GLfloat	*dirX			= batch.dirX.data();
+	const GLfloat	*dirY			= batch.dirY.data();
+	const GLfloat	*invLengthSq	= batch.invLengthSq.data();
+	size_t			count			= segmentBatchSize(batch);
+	size_t			i				= 0;
+	const __m256	cx				= _mm256_set1_ps(circX);
+	const __m256	cy				= _mm256_set1_ps(circY);
+	const __m256	r2				= _mm256_set1_ps(radiusSq);
+	const __m256	zero			= _mm256_setzero_ps();
+	const __m256	one				= _mm256_set1_ps(1.0f);
+
+	for (; i + 8 <= count; i += 8) {
+		__m256	dx	= _mm256_loadu_ps(dirX + i);
+		__m256	dy	= _mm256_loadu_ps(dirY + i);
+		__m256	px	= _mm256_sub_ps(cx, _mm256_loadu_ps(startX + i));
+		__m256	py	= _mm256_sub_ps(cy, _mm256_loadu_ps(startY + i));
+		__m256	t	= _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(px, dx), _mm256_mul_ps(py, dy)), _mm256_loadu_ps(invLengthSq + i));
+
+		t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+
+		__m256	ex	= _mm256_sub_ps(px, _mm256_mul_ps(t, dx));
+		__m256	ey	= _mm256_sub_ps(py, _mm256_mul_ps(t, dy));
+		__m256	d2	= _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+
+		hitMask[i / 32] |= (GLuint)_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LE_OQ)) << (i % 32);
+		if (param) _mm256_storeu_ps(param + i, t);
+	}
+	return i;
+}
+
+/** Az SSE2 kernel 4 szakaszonként; a kernelnek nem kell SSE4. */
+/** The SSE2 kernel, 4 segments at a time; the kernel needs nothing from SSE4. */
+SIMD_TARGET("sse2") size_t intersectCircleSegmentsSSE2(const SegmentBatch &batch, GLfloat circX, GLfloat circY, GLfloat radiusSq, GLuint *hitMask, GLfloat *param) {
+	const GLfloat	*startX			= batch.startX.data();
+	const GLfloat	*startY			= batch.startY.data();
+	const GLfloat	*dirX			= batch.dirX.data();
+	const GLfloat	*dirY			= batch.dirY.data();
+	const GLfloat	*invLengthSq	= batch.invLengthSq.data();
+	size_t			count			= segmentBatchSize(batch);
+	size_t			i				= 0;
+	const __m128	cx				= _mm_set1_ps(circX);
+	const __m128	cy				= _mm_set1_ps(circY);
+	const __m128	r2				= _mm_set1_ps(radiusSq);
+	const __m128	zero			= _mm_setzero_ps();
+	const __m128	one				= _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= count; i += 4) {
+		__m128	dx	= _mm_loadu_ps(dirX + i);
+		__m128	dy	= _mm_loadu_ps(dirY + i);
+		__m128	px	= _mm_sub_ps(cx, _mm_loadu_ps(startX + i));
+		__m128	py	= _mm_sub_ps(cy, _mm_loadu_ps(startY + i));
+		__m128	t	= _mm_mul_ps(_mm_add_ps(_mm_mul_ps(px, dx), _mm_mul_ps(py, dy)), _mm_loadu_ps(invLengthSq + i));
+
+		t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+		__m128	ex	= _mm_sub_ps(px, _mm_mul_ps(t, dx));
+		__m128	ey	= _mm_sub_ps(py, _mm_mul_ps(t, dy));
+		__m128	d2	= _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+		hitMask[i / 32] |= (GLuint)_mm_movemask_ps(_mm_cmple_ps(d2, r2)) << (i % 32);
+		if (param) _mm_storeu_ps(param + i, t);
+	}
+	return i;
+}
+#endif
+
+/** Egy kör a köteg összes szakasza ellen, gyökvonás nélkül: a távolság négyzetét hasonlítja a sugár négyzetéhez.
+	hitMask: hitMaskWords(n) szó, az i. bit az i. szakasz találata. param: a legközelebbi pont paramétere [0, 1]-ben, nullptr esetén kimarad.
+	A kernel futás közben választódik (selectSimdKernel), a benchmark egy adottat kér. */
+/** One circle against every segment of the batch without square roots: the squared distance is compared to the squared radius.
+	hitMask: hitMaskWords(n) words, bit i is the hit of segment i. param: parameter of the closest point in [0, 1], skipped when nullptr.
+	The kernel is picked at runtime (selectSimdKernel), the benchmark asks for a given one. */
+void intersectCircleSegments(const SegmentBatch &batch, GLfloat circX, GLfloat circY, GLfloat radius, GLuint *hitMask, GLfloat *param, eSimdKernel kernel = SimdKernelAuto) {
+	const GLfloat	*startX			= batch.startX.data();
+	const GLfloat	*startY			= batch.startY.data();
+	const GLfloat	*dirX			= batch.dirX.data();
+	const GLfloat	*dirY			= batch.dirY.data();
+	const GLfloat	*invLengthSq	= batch.invLengthSq.data();
+	size_t			count			= segmentBatchSize(batch);
+	GLfloat			radiusSq		= radius * radius;
+	size_t			i				= 0;
+
+	std::fill(hitMask, hitMask + hitMaskWords(count), 0u);
+
+#if defined(SIMD_X86)
+	switch (selectSimdKernel(kernel)) {
+	case SimdKernelAVX:		i = intersectCircleSegmentsAVX(batch, circX, circY, radiusSq, hitMask, param); break;
+	case SimdKernelSSE2:	i = intersectCircleSegmentsSSE2(batch, circX, circY, radiusSq, hitMask, param); break;
+	default:				break;
+	}
+#endif
+	/** A maradék elemek (és SIMD nélkül az összes) skalár kóddal, ugyanabban a műveleti sorrendben. */
+	/** The remaining elements (and all of them without SIMD) with scalar code, in the same order of operations. */
+	for (; i < count; i++) {
+		GLfloat	px	= circX - startX[i];
+		GLfloat	py	= circY - startY[i];
+		GLfloat	t	= (px * dirX[i] + py * dirY[i]) * invLengthSq[i];
+
+		t = std::min(std::max(t, 0.0f), 1.0f);
+
+		GLfloat	ex	= px - t * dirX[i];
+		GLfloat	ey	= py - t * dirY[i];
+
+		if (ex * ex + ey * ey <= radiusSq) hitMask[i / 32] |= 1u << (i % 32);
+		if (param) param[i] = t;
+	}
+}
+
+/** Körök tömbje a köteg ellen: a c. kör sora a hitMask[c * hitMaskWords(n)] és param[c * n] címen kezdődik. */
+/** An array of circles against the batch: the row of circle c starts at hitMask[c * hitMaskWords(n)] and param[c * n]. */
+void intersectCirclesSegments(const SegmentBatch &batch, const GLfloat *circX, const GLfloat *circY, const GLfloat *radius, size_t circleCount, GLuint *hitMask, GLfloat *param, eSimdKernel kernel = SimdKernelAuto) {
+	size_t		count	= segmentBatchSize(batch);
+	size_t		words	= hitMaskWords(count);
+	eSimdKernel	chosen	= selectSimdKernel(kernel);
+
+	for (size_t c = 0; c < circleCount; c++)
+		intersectCircleSegments(batch, circX[c], circY[c], radius[c], hitMask + c * words, param ? param + c * count : nullptr, chosen);
+}
+/** Mozgó kör és szakasz ütközési ideje: a kör középpontja start-ból start + motion-be halad, az első érintés
+	paramétere toi [0, 1]-ben, normal a szakaszról a kör felé mutató egységvektor. Már átfedő kezdőállapotnál toi = 0. */
+/** Time of impact of a moving circle and a segment: the center moves from start to start + motion, toi is the
+	parameter of the first contact in [0, 1], normal is the unit vector from the segment towards the circle. toi = 0 when they already overlap. */
+bool sweptCircleSegment(const glm::vec2 &start, const glm::vec2 &motion, float radius, const glm::vec2 &lineStart, const glm::vec2 &lineEnd, float &toi, glm::vec2 &normal) {
+	glm::vec2	closest = closestPointOnSegment(start, lineStart, lineEnd);
+
+	if (distBetween(start, closest) <= radius) {
+		toi		= 0.0f;
+		normal	= start != closest ? glm::normalize(start - closest) : glm::vec2(0.0f);
+		return true;
+	}
+
+	bool		hit			= false;
+	glm::vec2	lineDir		= lineEnd - lineStart;
+	float		lengthSq	= glm::dot(lineDir, lineDir);
+
+	toi = 1.0f;
+	/** A szakasz két oldalával párhuzamos, radius távolságra eltolt egyenesek. */
+	/** The lines parallel to the two sides of the segment, offset by radius. */
+	if (lengthSq > 0.0f) {
+		glm::vec2	side	= glm::normalize(glm::vec2(-lineDir.y, lineDir.x));
+		float		dist	= glm::dot(start - lineStart, side);
+		float		speed	= glm::dot(motion, side);
+
+		if (dist < 0.0f) {
+			side	= -side;
+			dist	= -dist;
+			speed	= -speed;
+		}
+		if (speed < 0.0f) {
+			float	t		= (dist - radius) / -speed;
+			float	along	= glm::dot(start + motion * t - lineStart, lineDir) / lengthSq;
+
+			if (t >= 0.0f && t <= toi && along >= 0.0f && along <= 1.0f) {
+				toi		= t;
+				normal	= side;
+				hit		= true;
+			}
+		}
+	}
+	/** A két végpont körüli radius sugarú körök. */
+	/** The circles of the given radius around the two end points. */
+	const glm::vec2	ends[] = { lineStart, lineEnd };
+	float			a = glm::dot(motion, motion);
+
+	for (const glm::vec2 &end : ends) {
+		glm::vec2	toStart	= start - end;
+		float		b		= glm::dot(toStart, motion);
+		float		c		= glm::dot(toStart, toStart) - radius * radius;
+		float		disc	= b * b - a * c;
+
+		if (a == 0.0f || b >= 0.0f || disc < 0.0f) continue;
+
+		float	t = (-b - std::sqrt(disc)) / a;
+		if (t >= 0.0f && t <= toi) {
+			toi		= t;
+			normal	= glm::normalize(start + motion * t - end);
+			hit		= true;
+		}
+	}
+
+	return hit;
+}
+
+/** A rács összes szakasza ellen, a teljes mozgás befoglaló téglalapjával szűrve; segment a legkorábbi érintés szakasza. */
+/** Against every segment of the grid, filtered by the bounding box of the whole motion; segment is the one touched first. */
+bool sweptCircleGrid(SegmentGrid &grid, const glm::vec2 &start, const glm::vec2 &motion, float radius, float &toi, glm::vec2 &normal, GLuint &segment, std::vector<CollisionPair> &pairs) {
+	glm::vec2	end	= start + motion;
+	bool		hit	= false;
+
+	pairs.clear();
+	queryBox(grid, 0, glm::min(start, end) - radius, glm::max(start, end) + radius, pairs);
+
+	toi = 1.0f;
+	for (const CollisionPair &pair : pairs) {
+		float		t;
+		glm::vec2	n;
+
+		if (sweptCircleSegment(start, motion, radius, grid.segments[pair.segment].start, grid.segments[pair.segment].end, t, n) && t <= toi) {
+			toi		= t;
+			normal	= n;
+			segment	= pair.segment;
+			hit		= true;
+		}
+	}
+
+	return hit;
+}
+
+/** Ütemező: csak az a test kap allépéseket, amelyik egy lépés alatt a sugaránál többet mozdul, így nem ugorhat át szakaszt. */
+/** Scheduler: only a body that moves more than its radius in one step gets substeps, so it cannot skip over a segment. */
+int sweptSubsteps(float motionLength, float radius, int maxSubsteps) {
+	if (motionLength <= radius || radius <= 0.0f) return 1;
+	return std::min((int)std::ceil(motionLength / radius), maxSubsteps);
+}
+#endif
\ No newline at end of file
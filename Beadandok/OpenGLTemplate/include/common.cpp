@@ -2,6 +2,7 @@
 #ifndef COMMON_CPP
 #define COMMON_CPP
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <GL/glew.h>
@@ -10,7 +11,9 @@
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/transform.hpp>
+#include <inputQueue.cpp>
 #include <iostream>
+#include <map>
 /** Szükséges az M_PI használatához. */
 /** Needed for using M_PI. */
 #define _USE_MATH_DEFINES
@@ -148,13 +151,33 @@ string ReadShader(const GLchar *filename) {
 	return buffer.str();
 }
 
-GLuint LoadShaders(ShaderInfo *shaders) {
+/** A defines blokkot a #version sor után szúrja be, a #line direktíva megtartja az eredeti sorszámokat a hibaüzenetekben. */
+/** Injects the defines block after the #version line, the #line directive keeps the original line numbers in the info log. */
+string InjectDefines(const string &source, const string &defines) {
+	if (defines.empty()) return source;
+
+	size_t	version = source.find("#version");
+	if (version == string::npos) return defines + "#line 1\n" + source;
+
+	size_t	lineEnd = source.find('\n', version);
+	if (lineEnd == string::npos) return source + "\n" + defines;
+
+	size_t	lineNumber = 2 + std::count(source.begin(), source.begin() + lineEnd, '\n');
+
+	return source.substr(0, lineEnd + 1) + defines + "#line " + to_string(lineNumber) + "\n" + source.substr(lineEnd + 1);
+}
+
+string ShaderDefine(const string &name, GLint value) {
+	return "#define " + name + " " + to_string(value) + "\n";
+}
+
+GLuint LoadShaders(ShaderInfo *shaders, const string &defines = "", const vector<const GLchar*> &feedbackVaryings = {}) {
 	if (shaders == nullptr) return 0; // 0 = NOT valid program
 	GLuint		program	= glCreateProgram();
 	ShaderInfo	*entry	= shaders;
 	while (entry->type != GL_NONE) {
 		GLuint			shader = glCreateShader(entry->type);
-		string			sourceString = ReadShader(entry->fileName);
+		string			sourceString = InjectDefines(ReadShader(entry->fileName), defines);
 		const GLchar	*source = sourceString.c_str();
 
 		entry->shader = shader;
@@ -176,6 +199,11 @@ GLuint LoadShaders(ShaderInfo *shaders) {
 		++entry;
 	}
 
+	/** A transform feedbackkel rögzített kimeneteket a linkelés előtt kell megadni. */
+	/** The outputs captured by transform feedback have to be given before linking. */
+	if (!feedbackVaryings.empty())
+		glTransformFeedbackVaryings(program, (GLsizei)feedbackVaryings.size(), feedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
+
 	glLinkProgram(program);
 	checkProgramLog(program, shaders);
 
@@ -205,6 +233,7 @@ void init(GLint major, GLint minor, GLint profile) {
 	/** Próbáljuk meg létrehozni az ablakunkat. */
 	/** Let's try to create a window for drawing. */
 	/** GLFWwindow* glfwCreateWindow(int width, int height, const char* title, GLFWmonitor * monitor, GLFWwindow * share) */
+	prepareInputJournalWindow();
 	if ((window = glfwCreateWindow(windowWidth, windowHeight, windowTitle, nullptr, nullptr)) == nullptr) {
 		cerr << "Failed to create GLFW window." << endl;
 		cleanUpScene(EXIT_FAILURE);
@@ -224,6 +253,9 @@ void init(GLint major, GLint minor, GLint profile) {
 	/** Az egér gombjaihoz köthetõ események kezelése. */
 	/** Callback function for mouse button events. */
 	glfwSetMouseButtonCallback(window, mouseButtonCallback);
+	/** A bemeneti sor és napló a fenti callbackek elé kerül: az események a drainInputQueue hívásakor, képkockánként egyszer futnak le. */
+	/** The input queue and journal are put in front of the callbacks above: events run in drainInputQueue, once per frame. */
+	installInputQueue(window, keyCallback, cursorPosCallback, mouseButtonCallback, framebufferSizeCallback);
 	/** Incializáljuk a GLEW-t, hogy elérhetõvé váljanak az OpenGL függvények, probléma esetén kilépés EXIT_FAILURE értékkel. */
 	/** Initalize GLEW, so the OpenGL functions will be available, on problem exit with EXIT_FAILURE code. */
 	if (glewInit() != GLEW_OK) {
@@ -232,7 +264,7 @@ void init(GLint major, GLint minor, GLint profile) {
 	}
 	/** 0 = v-sync kikapcsolva, 1 = v-sync bekapcsolva, n = n db képkockányi idõt várakozunk */
 	/** 0 = v-sync off, 1 = v-sync on, n = n pieces frame time waiting */
-	glfwSwapInterval(1);
+	glfwSwapInterval(journalSwapInterval(1));
 	/** A window ablak minimum és maximum szélességének és magasságának beállítása. */
 	/** The minimum and maximum width and height values of the window object. */
 	glfwSetWindowSizeLimits(window, 400, 400, 3840, 2160);
@@ -0,0 +1,231 @@
+/** Aszinkron képkocka mentés: a képet a GPU egy pixel pack bufferbe másolja, néhány képkockával később olvassuk ki, amikor a fence-e már jelzett, a fájlba kódolás pedig háttérszálakon fut. */
+/** Asynchronous frame capture: the GPU copies the image into a pixel pack buffer, it is read back a few frames later when its fence has already signalled, and the encoding into a file runs on background threads. */
+#ifndef FRAME_CAPTURE_CPP
+#define FRAME_CAPTURE_CPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <GL/glew.h>
+#include <mutex>
+#include <SOIL2/image_DXT.h>
+#include <SOIL2/SOIL2.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Egy kiolvasott, sorrendben felülről lefelé álló RGB kép, ami a kódolásra vár. */
+/** One read back RGB image, its rows top to bottom, waiting for the encoding. */
+typedef struct {
+	std::string					fileName;
+	int							imageType;		// SOIL_SAVE_TYPE_*
+	GLsizei						width, height;
+	std::vector<unsigned char>	pixels;
+} FrameCaptureImage;
+
+/** A gyűrű egy eleme: egy pack buffer és a benne utazó képkocka adatai. */
+/** One element of the ring: a pack buffer and the frame travelling in it. */
+typedef struct {
+	GLuint		buffer;
+	GLsizeiptr	size;					// the allocated size of the buffer
+	GLsync		fence;					// 0: the slot is free
+	std::string	fileName;
+	int			imageType;
+	GLsizei		width, height;
+} FrameCaptureSlot;
+
+typedef struct {
+	std::vector<FrameCaptureSlot>		slots;			// owned by the GL thread
+	GLuint								next;			// the oldest frame in flight, and the slot of the next capture
+	std::vector<std::thread>			encoders;
+	std::mutex							mutex;
+	std::condition_variable				wake, room, idle;
+	std::deque<FrameCaptureImage*>		queue;			// guarded by the mutex
+	size_t								maxQueued;
+	size_t								encoding;		// guarded by the mutex
+	size_t								written, failed;	// guarded by the mutex
+	bool								stopping;		// guarded by the mutex
+	std::mutex							ddsMutex;		// one DDS encoding at a time
+} FrameCapture;
+
+/** Egy kódoló szál. A SOIL_save_image egy globális szövegbe írja az eredményt, így a SOIL_last_result a kódolók futása alatt semmit sem mond: a sikert a visszatérési érték adja. A DDS típusokat egyszerre csak egy kódoló tömöríti, a tömörítők maguk is párhuzamosak. */
+/** One encoder thread. SOIL_save_image writes its result into a global string, so SOIL_last_result means nothing while the encoders run: success is taken from the return value. The DDS types are compressed by one encoder at a time, the compressors are parallel themselves. */
+void frameCaptureEncoder(FrameCapture &capture) {
+	std::unique_lock<std::mutex>	lock(capture.mutex);
+
+	for (;;) {
+		capture.wake.wait(lock, [&capture] { return capture.stopping || !capture.queue.empty(); });
+		if (capture.queue.empty()) return;
+
+		FrameCaptureImage	*image = capture.queue.front();
+
+		capture.queue.pop_front();
+		capture.encoding++;
+		lock.unlock();
+		capture.room.notify_one();
+
+		bool	dds = image->imageType == SOIL_SAVE_TYPE_DDS || image->imageType == SOIL_SAVE_TYPE_DDS_BC4 ||
+					  image->imageType == SOIL_SAVE_TYPE_DDS_BC5 || image->imageType == SOIL_SAVE_TYPE_DDS_BC7;
+		std::unique_lock<std::mutex>	ddsLock(capture.ddsMutex, std::defer_lock);
+
+		if (dds) ddsLock.lock();
+
+		int	saved = SOIL_save_image(image->fileName.c_str(), image->imageType, image->width, image->height, 3, image->pixels.data());
+
+		if (dds) ddsLock.unlock();
+
+		delete image;
+		lock.lock();
+		capture.encoding--;
+		if (saved)	capture.written++;
+		else		capture.failed++;
+		if (capture.queue.empty() && capture.encoding == 0) capture.idle.notify_all();
+	}
+}
+
+/** A GL szálon, egyszer. A latency a gyűrű mérete: egy képkockát ennyi képkockával később olvasunk ki, addigra a GPU rég végzett vele. Ha a kódolók lemaradnak, legfeljebb maxQueued kép vár rájuk, utána a mentés megvárja, amíg hely lesz: a memória korlátos marad, és egy képkocka sem vész el. A DXT kernelt itt választjuk ki, a kódolók indulása előtt. */
+/** On the GL thread, once. latency is the size of the ring: a frame is read back this many frames later, by then the GPU has long finished it. If the encoders fall behind, at most maxQueued images wait for them, then capturing waits until there is room: memory stays bounded and no frame is lost. The DXT kernel is selected here, before the encoders start. */
+void initFrameCapture(FrameCapture &capture, GLuint latency, size_t maxQueued, GLuint encoderCount) {
+	capture.slots.resize(std::max(latency, 1u));
+	for (FrameCaptureSlot &slot : capture.slots) {
+		glGenBuffers(1, &slot.buffer);
+		slot.size	= 0;
+		slot.fence	= 0;
+	}
+	capture.next		= 0;
+	capture.maxQueued	= std::max<size_t>(maxQueued, 1);
+	capture.encoding	= 0;
+	capture.written		= 0;
+	capture.failed		= 0;
+	capture.stopping	= false;
+	init_DXT_kernel();
+
+	for (GLuint i = 0; i < std::max(encoderCount, 1u); i++)
+		capture.encoders.emplace_back(frameCaptureEncoder, std::ref(capture));
+}
+
+/** Kiolvassa a foglalt elemet (a képkockája latency képkockával régebbi, így a várakozás általában nulla), és sorba teszi a kódolóknak; a sorok megfordítása a másolással együtt történik. */
+/** Reads back a busy slot (its frame is latency frames old, so the wait is usually zero) and queues it for the encoders; the rows are flipped while copying. */
+void collectFrameCapture(FrameCapture &capture, FrameCaptureSlot &slot) {
+	FrameCaptureImage	*image = new FrameCaptureImage();
+	size_t				rowBytes = (size_t)slot.width * 3;
+
+	glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+
+	image->fileName		= slot.fileName;
+	image->imageType	= slot.imageType;
+	image->width		= slot.width;
+	image->height		= slot.height;
+	image->pixels.resize(rowBytes * slot.height);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+
+	const unsigned char	*mapped = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)image->pixels.size(), GL_MAP_READ_BIT);
+
+	if (mapped != nullptr) {
+		for (GLsizei row = 0; row < slot.height; row++)
+			memcpy(image->pixels.data() + (size_t)(slot.height - 1 - row) * rowBytes, mapped + (size_t)row * rowBytes, rowBytes);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	if (mapped == nullptr) {
+		delete image;
+		std::lock_guard<std::mutex>	lock(capture.mutex);
+		capture.failed++;
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex>	lock(capture.mutex);
+		capture.room.wait(lock, [&capture] { return capture.queue.size() < capture.maxQueued; });
+		capture.queue.push_back(image);
+	}
+	capture.wake.notify_one();
+}
+
+/** A GL szálon, a képkocka kirajzolása után (csere előtt): az olvasásra kötött framebufferből (glReadBuffer) menti a téglalapot, így egy ablak nélküli kontextus FBO-jából is. A gyűrűben sorban álló, már kész képkockákat várakozás nélkül továbbadja; csak akkor vár, ha a gyűrű tele van. A fájl típusa SOIL_SAVE_TYPE_*. */
+/** On the GL thread, after drawing the frame (before the swap): saves the rectangle of the framebuffer bound for reading (glReadBuffer), so the FBO of a context without a window works too. The frames in the ring that are done already are passed on without waiting; it only waits when the ring is full. The file type is SOIL_SAVE_TYPE_*. */
+void captureFrame(FrameCapture &capture, const char *fileName, int imageType, GLint x, GLint y, GLsizei width, GLsizei height) {
+	GLuint	count = (GLuint)capture.slots.size();
+	GLint	packAlignment;
+
+	/** A régebbiek sorrendben, amíg a fence-ük jelzett... */
+	/** The older ones in order, while their fences have signalled... */
+	for (GLuint i = 0; i < count; i++) {
+		FrameCaptureSlot	&slot = capture.slots[(capture.next + i) % count];
+
+		if (slot.fence == 0) continue;
+		if (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED) break;
+		collectFrameCapture(capture, slot);
+	}
+
+	/** ...a célhely pedig mindenképp felszabadul. */
+	/** ...and the target slot is freed in any case. */
+	FrameCaptureSlot	&slot = capture.slots[capture.next];
+	GLsizeiptr			size = (GLsizeiptr)width * height * 3;
+
+	if (slot.fence) collectFrameCapture(capture, slot);
+	if (width < 1 || height < 1) return;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	if (slot.size != size) {
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+		slot.size = size;
+	}
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.fence		= glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.fileName	= fileName;
+	slot.imageType	= imageType;
+	slot.width		= width;
+	slot.height		= height;
+	capture.next	= (capture.next + 1) % count;
+}
+
+/** A GL szálon: kiolvassa a gyűrűben maradt képkockákat, és megvárja, amíg minden fájl elkészül (pl. egy visszajátszás végén). */
+/** On the GL thread: reads back the frames left in the ring and waits until every file is written (e.g. at the end of a replay). */
+void finishFrameCapture(FrameCapture &capture) {
+	GLuint	count = (GLuint)capture.slots.size();
+
+	for (GLuint i = 0; i < count; i++) {
+		FrameCaptureSlot	&slot = capture.slots[(capture.next + i) % count];
+
+		if (slot.fence) collectFrameCapture(capture, slot);
+	}
+
+	std::unique_lock<std::mutex>	lock(capture.mutex);
+	capture.idle.wait(lock, [&capture] { return capture.queue.empty() && capture.encoding == 0; });
+}
+
+/** Az eddig elkészült és a sikertelen fájlok száma. */
+/** The number of files written so far, and of the failed ones. */
+void frameCaptureStatistics(FrameCapture &capture, size_t &written, size_t &failed) {
+	std::lock_guard<std::mutex>	lock(capture.mutex);
+
+	written	= capture.written;
+	failed	= capture.failed;
+}
+
+/** A GL szálon: befejezi a mentéseket, leállítja a kódolókat és törli a buffereket. */
+/** On the GL thread: finishes the captures, stops the encoders and deletes the buffers. */
+void deleteFrameCapture(FrameCapture &capture) {
+	finishFrameCapture(capture);
+	{
+		std::lock_guard<std::mutex>	lock(capture.mutex);
+		capture.stopping = true;
+	}
+	capture.wake.notify_all();
+	for (std::thread &encoder : capture.encoders) encoder.join();
+	capture.encoders.clear();
+
+	for (FrameCaptureSlot &slot : capture.slots) glDeleteBuffers(1, &slot.buffer);
+	capture.slots.clear();
+}
+#endif
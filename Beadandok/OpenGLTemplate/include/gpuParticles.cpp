@@ -0,0 +1,227 @@
+/** GPU oldali részecske-szimuláció transform feedbackkel: az állapot két, felváltva írt bufferben él, a CPU nem tölti fel képkockánként. */
+/** GPU side particle simulation with transform feedback: the state lives in two ping-pong buffers, the CPU does not upload it every frame. */
+#ifndef GPU_PARTICLES_CPP
+#define GPU_PARTICLES_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <particleSystem.cpp>
+#include <vector>
+
+/** Részecskénként egy vec4(posX, posY, velX, velY) állapot; a sugár és a szín csak spawnoláskor kerül fel. */
+/** One vec4(posX, posY, velX, velY) state per particle; radius and color are only uploaded on spawn. */
+typedef struct {
+	GLuint				stepProgram, drawProgram;
+	GLuint				stateBuffers[2];			// ping-pong: one is read by the step, the other one is captured
+	GLuint				stepVaos[2], drawVaos[2];	// one per state buffer
+	GLuint				quadBuffer, radiusBuffer, colorBuffer;
+	GLint				locationDt, locationBounds, locationViewportSize, locationOuterColor;
+	GLuint				current;					// index of the buffer holding the latest state
+	GLsizei				count;
+	unsigned long long	steps;						// step count of the state, the upload sets its starting value
+} GpuParticleSystem;
+
+/** A léptető program csak vertex shaderből áll; a "state" kimenetet a linkelés előtt kell transform feedbackre kijelölni.
+	Hibás fordításnál vagy linkelésnél kiírja az info logot és 0-t ad vissza, ilyenkor a GPU mód nem használható. */
+/** The step program consists of a vertex shader only; its "state" output has to be marked for transform feedback before linking.
+	If compiling or linking fails it prints the info log and returns 0, the GPU mode is not available then. */
+GLuint createParticleStepProgram(const GLchar *source) {
+	const GLchar	*varyings[] = { "state" };
+	GLuint			shader = glCreateShader(GL_VERTEX_SHADER);
+	GLuint			program = glCreateProgram();
+	GLint			status, length = 0;
+	std::string		log;
+
+	glShaderSource(shader, 1, &source, nullptr);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (!status) {
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+		log.resize(std::max(length, 1));
+		glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+		std::cerr << "Particle step shader compiling failed, info log: " << log.c_str() << std::endl;
+		glDeleteShader(shader);
+		glDeleteProgram(program);
+		return 0;
+	}
+	glAttachShader(program, shader);
+	glTransformFeedbackVaryings(program, 1, varyings, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(program);
+	glDeleteShader(shader);
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status) {
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+		log.resize(std::max(length, 1));
+		glGetProgramInfoLog(program, length, nullptr, &log[0]);
+		std::cerr << "Particle step program linking failed, info log: " << log.c_str() << std::endl;
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	return program;
+}
+
+/** A rajzoló program a ParticleVertShader.glsl és ParticleFragShader.glsl, így a CPU és a GPU mód ugyanúgy néz ki. */
+/** The draw program is ParticleVertShader.glsl and ParticleFragShader.glsl, so the CPU and GPU modes look the same. */
+void initGpuParticles(GpuParticleSystem &particles, GLuint stepProgram, GLuint drawProgram) {
+	const glm::vec2	quad[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+
+	particles.stepProgram			= stepProgram;
+	particles.drawProgram			= drawProgram;
+	particles.current				= 0;
+	particles.count					= 0;
+	particles.steps					= 0;
+	particles.locationDt			= glGetUniformLocation(stepProgram, "dt");
+	particles.locationBounds		= glGetUniformLocation(stepProgram, "bounds");
+	particles.locationViewportSize	= glGetUniformLocation(drawProgram, "viewportSize");
+	particles.locationOuterColor	= glGetUniformLocation(drawProgram, "outerColor");
+
+	glGenBuffers(2, particles.stateBuffers);
+	glGenBuffers(1, &particles.quadBuffer);
+	glGenBuffers(1, &particles.radiusBuffer);
+	glGenBuffers(1, &particles.colorBuffer);
+	glGenVertexArrays(2, particles.stepVaos);
+	glGenVertexArrays(2, particles.drawVaos);
+
+	glBindBuffer(GL_ARRAY_BUFFER, particles.quadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+	for (int i = 0; i < 2; i++) {
+		/** Léptetés: pontonként az állapot és a sugár. */
+		/** Stepping: the state and the radius per point. */
+		glBindVertexArray(particles.stepVaos[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[i]);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, particles.radiusBuffer);
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (void*)0);
+		glEnableVertexAttribArray(1);
+
+		/** Rajzolás: ugyanaz az attribútum-kiosztás mint a ParticleRenderer-nél, a posX és posY az állapotból, lépésközzel. */
+		/** Drawing: the same attribute layout as the ParticleRenderer, posX and posY come strided from the state. */
+		glBindVertexArray(particles.drawVaos[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, particles.quadBuffer);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[i]);
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)sizeof(GLfloat));
+		glBindBuffer(GL_ARRAY_BUFFER, particles.radiusBuffer);
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (void*)0);
+		glBindBuffer(GL_ARRAY_BUFFER, particles.colorBuffer);
+		glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GLuint), (void*)0);
+		for (GLuint attribute = 1; attribute <= 4; attribute++) {
+			glEnableVertexAttribArray(attribute);
+			glVertexAttribDivisor(attribute, 1);
+		}
+	}
+	glBindVertexArray(0);
+}
+
+/** A CPU állapot egyszeri feltöltése, pl. a GPU mód bekapcsolásakor; a második buffer csak helyet foglal. */
+/** One time upload of the CPU state, e.g. when the GPU mode is switched on; the second buffer only gets its storage. */
+void uploadGpuParticles(GpuParticleSystem &particles, const ParticleSystem &source, unsigned long long steps) {
+	std::vector<glm::vec4>	state(particleCount(source));
+
+	for (size_t i = 0; i < state.size(); i++)
+		state[i] = glm::vec4(source.posX[i], source.posY[i], source.velX[i], source.velY[i]);
+
+	particles.count		= (GLsizei)state.size();
+	particles.current	= 0;
+	particles.steps		= steps;
+
+	glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[0]);
+	glBufferData(GL_ARRAY_BUFFER, state.size() * sizeof(glm::vec4), state.data(), GL_DYNAMIC_COPY);
+	glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[1]);
+	glBufferData(GL_ARRAY_BUFFER, state.size() * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_ARRAY_BUFFER, particles.radiusBuffer);
+	glBufferData(GL_ARRAY_BUFFER, particles.count * sizeof(GLfloat), source.radius.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, particles.colorBuffer);
+	glBufferData(GL_ARRAY_BUFFER, particles.count * sizeof(GLuint), source.color.data(), GL_STATIC_DRAW);
+}
+
+/** Egy lépés: a pontok raszterizálás nélkül futnak le, a kimenet a másik bufferbe kerül, utána a két buffer szerepet cserél. */
+/** One step: the points run without rasterization, the output is captured into the other buffer, then the two buffers swap roles. */
+void stepGpuParticles(GpuParticleSystem &particles, GLfloat dt, GLfloat width, GLfloat height) {
+	if (particles.count == 0) return;
+	glUseProgram(particles.stepProgram);
+	glUniform1f(particles.locationDt, dt);
+	glUniform2f(particles.locationBounds, width, height);
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(particles.stepVaos[particles.current]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particles.stateBuffers[1 - particles.current]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, particles.count);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	particles.current = 1 - particles.current;
+	particles.steps++;
+}
+
+/** Ellenőrzés a CPU referencia ellen: visszaolvasás (csak ilyenkor), a tolerance-nél jobban eltérő pozíciók száma. */
+/** Check against the CPU reference: reads back (only here), returns the number of positions off by more than tolerance. */
+size_t compareGpuParticles(const GpuParticleSystem &particles, const ParticleSystem &reference, GLfloat tolerance, GLfloat &maxError) {
+	std::vector<glm::vec4>	state(particles.count);
+	size_t					mismatches = 0;
+
+	glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[particles.current]);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, state.size() * sizeof(glm::vec4), state.data());
+
+	maxError = 0.0f;
+	for (size_t i = 0; i < std::min(state.size(), particleCount(reference)); i++) {
+		GLfloat	error = std::max(std::fabs(state[i].x - reference.posX[i]), std::fabs(state[i].y - reference.posY[i]));
+
+		maxError	= std::max(maxError, error);
+		mismatches	+= error > tolerance;
+	}
+
+	return mismatches;
+}
+
+/** A GPU mód kikapcsolásakor: a legutóbb írt állapot visszaolvasása a target pozícióiba és sebességeibe (a sugár és a szín nem változik), így a CPU onnan folytatja, nem lépteti újra az összes GPU lépést. A particles.steps lépés utáni állapot. */
+/** When the GPU mode is switched off: reads the latest state back into the positions and velocities of target (radius and color do not change), so the CPU continues from there instead of redoing every GPU step. It is the state after particles.steps steps. */
+void readbackGpuParticles(const GpuParticleSystem &particles, ParticleSystem &target) {
+	std::vector<glm::vec4>	state(particles.count);
+
+	glBindBuffer(GL_ARRAY_BUFFER, particles.stateBuffers[particles.current]);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, state.size() * sizeof(glm::vec4), state.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	target.posX.resize(state.size());
+	target.posY.resize(state.size());
+	target.velX.resize(state.size());
+	target.velY.resize(state.size());
+	for (size_t i = 0; i < state.size(); i++) {
+		target.posX[i]	= state[i].x;
+		target.posY[i]	= state[i].y;
+		target.velX[i]	= state[i].z;
+		target.velY[i]	= state[i].w;
+	}
+}
+
+/** Közvetlenül a legutóbb írt állapotbufferből, egyetlen instancolt hívással; a hívó engedélyezi a GL_BLEND-et. */
+/** Straight from the most recently written state buffer, with one instanced call; the caller enables GL_BLEND. */
+void drawGpuParticles(const GpuParticleSystem &particles, const glm::vec3 &outerColor, GLint width, GLint height) {
+	if (particles.count == 0) return;
+	glUseProgram(particles.drawProgram);
+	glUniform2f(particles.locationViewportSize, (GLfloat)width, (GLfloat)height);
+	glUniform3fv(particles.locationOuterColor, 1, &outerColor[0]);
+	glBindVertexArray(particles.drawVaos[particles.current]);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, particles.count);
+}
+
+void deleteGpuParticles(GpuParticleSystem &particles) {
+	GLuint	buffers[] = { particles.stateBuffers[0], particles.stateBuffers[1], particles.quadBuffer, particles.radiusBuffer, particles.colorBuffer };
+
+	glDeleteBuffers(5, buffers);
+	glDeleteVertexArrays(2, particles.stepVaos);
+	glDeleteVertexArrays(2, particles.drawVaos);
+	particles.count = 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,438 @@
+/** Bemeneti napló: időbélyeges események bináris fileba rögzítése és visszajátszása, állapot hash ellenőrzéssel. */
+/** Input journal: recording timestamped events to a binary file and replaying them, with state hash checks. */
+#ifndef INPUT_JOURNAL_CPP
+#define INPUT_JOURNAL_CPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum eInputEvent {
+	InputKey,
+	InputCursorPos,
+	InputMouseButton,
+	InputFramebufferSize,
+	InputFrame,			// start of a frame with steps or input, code is the number of simulation steps run in it
+	InputStateHash
+};
+
+enum eJournalMode {
+	JournalOff,
+	JournalRecord,
+	JournalReplay
+};
+
+/** A fileban csak a típushoz tartozó mezők szerepelnek, lásd writeInputEvent. */
+/** Only the fields of the type are stored in the file, see writeInputEvent. */
+typedef struct {
+	GLubyte		type;
+	GLuint		frame;
+	GLdouble	time;			// seconds since the start of the recording
+	GLint		code;			// key, mouse button, framebuffer width or step count
+	GLint		scancode;
+	GLint		action;			// action or framebuffer height
+	GLint		mods;
+	GLdouble	x, y;			// cursor position
+	GLuint64	hash;
+} InputEvent;
+
+typedef struct {
+	eJournalMode				mode;
+	std::string					path;
+	std::vector<InputEvent>		events;
+	size_t						cursor;				// next event to replay
+	GLuint						frame;
+	bool						frameRecorded;		// the current frame has a recorded InputFrame, only those get a state hash
+	GLuint						dispatchedEvents;	// events forwarded by dispatchInputEvent, live from the queue or replayed
+	GLdouble					startTime;
+	GLdouble					speed;				// replay speed, 1 = recorded, 0 = as fast as possible
+	bool						headless;
+	GLuint						hashInterval;		// frames between two recorded state hashes
+	GLuint						hashChecks, hashMismatches;
+	GLdouble					cursorX, cursorY;	// last cursor position seen by the samples
+	GLFWkeyfun					keyFun;
+	GLFWcursorposfun			cursorPosFun;
+	GLFWmousebuttonfun			mouseButtonFun;
+	GLFWframebuffersizefun		framebufferSizeFun;
+} InputJournal;
+
+const char		inputJournalMagic[4]	= { 'I', 'J', 'R', 'N' };
+const GLuint	inputJournalVersion		= 1;
+InputJournal	inputJournal			= { JournalOff, "", {}, 0, 0, false, 0, 0.0, 1.0, false, 30, 0, 0, 0.0, 0.0, nullptr, nullptr, nullptr, nullptr };
+
+/** FNV-1a hash; a minták ezzel fűzik össze az állapotukat. */
+/** FNV-1a hash; the samples chain their state through it. */
+GLuint64 hashBytes(const void *data, size_t size, GLuint64 hash = 14695981039346656037ull) {
+	const GLubyte	*bytes = (const GLubyte*)data;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+template <typename T>
+void writeJournalValue(std::ofstream &file, const T &value) {
+	file.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+bool readJournalValue(std::ifstream &file, T &value) {
+	return (bool)file.read((char*)&value, sizeof(T));
+}
+
+void writeInputEvent(std::ofstream &file, const InputEvent &event) {
+	writeJournalValue(file, event.type);
+	writeJournalValue(file, event.frame);
+	writeJournalValue(file, event.time);
+	switch (event.type) {
+	case InputKey:
+		writeJournalValue(file, event.code);
+		writeJournalValue(file, event.scancode);
+		writeJournalValue(file, event.action);
+		writeJournalValue(file, event.mods);
+		break;
+	case InputMouseButton:
+		writeJournalValue(file, event.code);
+		writeJournalValue(file, event.action);
+		writeJournalValue(file, event.mods);
+		/** A kurzor helye is kell, a minták a gombnyomáskor lekérdezik. */
+		/** The cursor position is needed too, the samples query it on button presses. */
+	case InputCursorPos:
+		writeJournalValue(file, event.x);
+		writeJournalValue(file, event.y);
+		break;
+	case InputFramebufferSize:
+		writeJournalValue(file, event.code);
+		writeJournalValue(file, event.action);
+		break;
+	case InputFrame:
+		writeJournalValue(file, event.code);
+		break;
+	case InputStateHash:
+		writeJournalValue(file, event.hash);
+		break;
+	}
+}
+
+bool readInputEvent(std::ifstream &file, InputEvent &event) {
+	event = InputEvent();
+	if (!readJournalValue(file, event.type) || !readJournalValue(file, event.frame) || !readJournalValue(file, event.time)) return false;
+	switch (event.type) {
+	case InputKey:
+		return readJournalValue(file, event.code) && readJournalValue(file, event.scancode) && readJournalValue(file, event.action) && readJournalValue(file, event.mods);
+	case InputMouseButton:
+		if (!readJournalValue(file, event.code) || !readJournalValue(file, event.action) || !readJournalValue(file, event.mods)) return false;
+	case InputCursorPos:
+		return readJournalValue(file, event.x) && readJournalValue(file, event.y);
+	case InputFramebufferSize:
+		return readJournalValue(file, event.code) && readJournalValue(file, event.action);
+	case InputFrame:
+		return readJournalValue(file, event.code);
+	case InputStateHash:
+		return readJournalValue(file, event.hash);
+	}
+
+	return false;
+}
+
+bool saveInputJournal(const std::string &path) {
+	std::ofstream	file(path, std::ios::binary);
+
+	if (!file) {
+		std::cerr << "Failed to write input journal " << path << "." << std::endl;
+		return false;
+	}
+	file.write(inputJournalMagic, sizeof(inputJournalMagic));
+	writeJournalValue(file, inputJournalVersion);
+	for (const InputEvent &event : inputJournal.events) writeInputEvent(file, event);
+
+	return (bool)file;
+}
+
+bool loadInputJournal(const std::string &path) {
+	std::ifstream	file(path, std::ios::binary);
+	char			magic[4];
+	GLuint			version;
+	InputEvent		event;
+
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, inputJournalMagic, sizeof(magic)) != 0 || !readJournalValue(file, version) || version != inputJournalVersion) {
+		std::cerr << "Failed to read input journal " << path << "." << std::endl;
+		return false;
+	}
+	inputJournal.events.clear();
+	while (readInputEvent(file, event)) inputJournal.events.push_back(event);
+
+	return true;
+}
+
+/** Parancssor: --record <file>, --replay <file>, --speed <szorzó, 0 = maximális>, --headless (rejtett ablak). */
+/** Command line: --record <file>, --replay <file>, --speed <factor, 0 = maximum>, --headless (hidden window). */
+void parseInputJournalArguments(int argc, char **argv) {
+	for (int i = 1; i < argc; i++) {
+		std::string	argument = argv[i];
+
+		if (argument == "--record" && i + 1 < argc) {
+			inputJournal.mode = JournalRecord;
+			inputJournal.path = argv[++i];
+		}
+		else if (argument == "--replay" && i + 1 < argc) {
+			inputJournal.path = argv[++i];
+			if (loadInputJournal(inputJournal.path)) inputJournal.mode = JournalReplay;
+		}
+		else if (argument == "--speed" && i + 1 < argc)
+			inputJournal.speed = std::atof(argv[++i]);
+		else if (argument == "--headless")
+			inputJournal.headless = true;
+	}
+}
+
+/** glfwCreateWindow előtt hívandó. */
+/** To be called before glfwCreateWindow. */
+void prepareInputJournalWindow() {
+	if (inputJournal.headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+}
+
+/** time a glfwGetTime szerinti idő, a felvétel kezdetéhez képest tárolódik. */
+/** time is in glfwGetTime terms, it is stored relative to the start of the recording. */
+void recordInputEventAt(InputEvent event, GLdouble time) {
+	event.frame	= inputJournal.frame;
+	event.time	= time - inputJournal.startTime;
+	inputJournal.events.push_back(event);
+}
+
+void recordInputEvent(InputEvent event) {
+	recordInputEventAt(event, glfwGetTime());
+}
+
+/** A GLFW ezeket hívja: felvételkor rögzítenek és továbbadnak, visszajátszáskor az élő bemenetet eldobják. */
+/** GLFW calls these: they record and forward while recording, and drop live input while replaying. */
+void journalKeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
+	if (inputJournal.mode == JournalReplay) return;
+	if (inputJournal.mode == JournalRecord) {
+		InputEvent	event = InputEvent();
+
+		event.type		= InputKey;
+		event.code		= key;
+		event.scancode	= scancode;
+		event.action	= action;
+		event.mods		= mods;
+		recordInputEvent(event);
+	}
+	inputJournal.keyFun(window, key, scancode, action, mods);
+}
+
+void journalCursorPosCallback(GLFWwindow *window, double xPos, double yPos) {
+	if (inputJournal.mode == JournalReplay) return;
+	if (inputJournal.mode == JournalRecord) {
+		InputEvent	event = InputEvent();
+
+		event.type	= InputCursorPos;
+		event.x		= xPos;
+		event.y		= yPos;
+		recordInputEvent(event);
+	}
+	inputJournal.cursorX = xPos;
+	inputJournal.cursorY = yPos;
+	inputJournal.cursorPosFun(window, xPos, yPos);
+}
+
+/** A gombesemény a lenyomáskori kurzor pozícióval, ezt látja a minta a journalCursorPos-on keresztül. */
+/** The button event with the cursor position at the time of the press, the sample sees it through journalCursorPos. */
+void journalMouseButtonAt(GLFWwindow *window, int button, int action, int mods, double xPos, double yPos) {
+	if (inputJournal.mode == JournalReplay) return;
+	inputJournal.cursorX = xPos;
+	inputJournal.cursorY = yPos;
+	if (inputJournal.mode == JournalRecord) {
+		InputEvent	event = InputEvent();
+
+		event.type		= InputMouseButton;
+		event.code		= button;
+		event.action	= action;
+		event.mods		= mods;
+		event.x			= xPos;
+		event.y			= yPos;
+		recordInputEvent(event);
+	}
+	inputJournal.mouseButtonFun(window, button, action, mods);
+}
+
+void journalMouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
+	double	xPos, yPos;
+
+	glfwGetCursorPos(window, &xPos, &yPos);
+	journalMouseButtonAt(window, button, action, mods, xPos, yPos);
+}
+
+void journalFramebufferSizeCallback(GLFWwindow *window, int width, int height) {
+	if (inputJournal.mode == JournalReplay) return;
+	if (inputJournal.mode == JournalRecord) {
+		InputEvent	event = InputEvent();
+
+		event.type		= InputFramebufferSize;
+		event.code		= width;
+		event.action	= height;
+		recordInputEvent(event);
+	}
+	inputJournal.framebufferSizeFun(window, width, height);
+}
+
+/** A minta callbackjei helyett a naplózó callbackeket regisztrálja; nullptr callback nem kerül regisztrálásra. */
+/** Registers the journaling callbacks in place of the sample's ones; nullptr callbacks are not registered. */
+void installInputJournal(GLFWwindow *window, GLFWkeyfun keyFun, GLFWcursorposfun cursorPosFun, GLFWmousebuttonfun mouseButtonFun, GLFWframebuffersizefun framebufferSizeFun) {
+	inputJournal.keyFun				= keyFun;
+	inputJournal.cursorPosFun		= cursorPosFun;
+	inputJournal.mouseButtonFun		= mouseButtonFun;
+	inputJournal.framebufferSizeFun	= framebufferSizeFun;
+	inputJournal.startTime			= glfwGetTime();
+	inputJournal.frame				= 0;
+	inputJournal.frameRecorded		= false;
+	inputJournal.dispatchedEvents	= 0;
+	inputJournal.cursor				= 0;
+	glfwGetCursorPos(window, &inputJournal.cursorX, &inputJournal.cursorY);
+
+	if (keyFun) glfwSetKeyCallback(window, journalKeyCallback);
+	if (cursorPosFun) glfwSetCursorPosCallback(window, journalCursorPosCallback);
+	if (mouseButtonFun) glfwSetMouseButtonCallback(window, journalMouseButtonCallback);
+	if (framebufferSizeFun) glfwSetFramebufferSizeCallback(window, journalFramebufferSizeCallback);
+}
+
+/** Gyorsított visszajátszásnál a v-sync sem korlátoz. */
+/** Accelerated replay is not limited by v-sync either. */
+int journalSwapInterval(int interval) {
+	return inputJournal.mode == JournalReplay && inputJournal.speed <= 0.0 ? 0 : interval;
+}
+
+/** A glfwGetCursorPos helyett: az éppen feldolgozott eseményhez tartozó (visszajátszáskor a rögzített) kurzor pozíciót adja. */
+/** Replaces glfwGetCursorPos: returns the cursor position of the event being processed (the recorded one while replaying). */
+void journalCursorPos(GLFWwindow *window, double *xPos, double *yPos) {
+	*xPos = inputJournal.cursorX;
+	*yPos = inputJournal.cursorY;
+}
+
+void dispatchInputEvent(GLFWwindow *window, const InputEvent &event) {
+	inputJournal.dispatchedEvents++;
+	switch (event.type) {
+	case InputKey:
+		if (inputJournal.keyFun) inputJournal.keyFun(window, event.code, event.scancode, event.action, event.mods);
+		break;
+	case InputCursorPos:
+		inputJournal.cursorX = event.x;
+		inputJournal.cursorY = event.y;
+		if (inputJournal.cursorPosFun) inputJournal.cursorPosFun(window, event.x, event.y);
+		break;
+	case InputMouseButton:
+		inputJournal.cursorX = event.x;
+		inputJournal.cursorY = event.y;
+		if (inputJournal.mouseButtonFun) inputJournal.mouseButtonFun(window, event.code, event.action, event.mods);
+		break;
+	case InputFramebufferSize:
+		if (inputJournal.framebufferSizeFun) inputJournal.framebufferSizeFun(window, event.code, event.action);
+		break;
+	}
+}
+
+/** Sorba tett esemény kiosztása: felvételkor a beérkezési idejével (event.time, glfwGetTime szerint) rögzíti, nem a kiosztáséval, majd továbbadja. */
+/** Dispatches a queued event: while recording it is stored with its arrival time (event.time, in glfwGetTime terms), not the time of the dispatch, then forwarded. */
+void journalQueuedEvent(GLFWwindow *window, const InputEvent &event) {
+	if (inputJournal.mode == JournalReplay) return;
+	if (inputJournal.mode == JournalRecord) recordInputEventAt(event, event.time);
+	dispatchInputEvent(window, event);
+}
+
+/** Képkocka eleje, a szimuláció előtt. Felvételkor rögzíti a lépésszámot, ha volt lépés vagy bemenet (egy szál ciklusa
+	lépés és bemenet nélkül nem kerül a naplóba), visszajátszáskor kiosztja a képkocka előtti eseményeket (szükség esetén
+	a rögzített időpontig várva), és a rögzített lépésszámot adja vissza. */
+/** Start of a frame, before the simulation. While recording it stores the step count if there were steps or input (an
+	iteration of a thread loop without either is not journaled), while replaying it dispatches the events before the
+	frame (waiting for their recorded time if needed) and returns the recorded step count. */
+int beginJournalFrame(GLFWwindow *window, int steps) {
+	if (inputJournal.mode == JournalRecord) {
+		inputJournal.frameRecorded = steps > 0 || inputJournal.dispatchedEvents > 0;
+		inputJournal.dispatchedEvents = 0;
+		if (!inputJournal.frameRecorded) return steps;
+
+		InputEvent	event = InputEvent();
+
+		event.type = InputFrame;
+		event.code = steps;
+		recordInputEvent(event);
+	}
+	else if (inputJournal.mode == JournalReplay) {
+		steps = 0;
+		while (inputJournal.cursor < inputJournal.events.size()) {
+			const InputEvent	&event = inputJournal.events[inputJournal.cursor++];
+
+			if (inputJournal.speed > 0.0) {
+				GLdouble	wait = event.time / inputJournal.speed - (glfwGetTime() - inputJournal.startTime);
+				if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<GLdouble>(wait));
+			}
+			if (event.type == InputFrame) {
+				steps = event.code;
+				break;
+			}
+			dispatchInputEvent(window, event);
+		}
+		if (inputJournal.cursor == inputJournal.events.size()) glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+	inputJournal.frame++;
+
+	return steps;
+}
+
+/** Kell-e ebben a képkockában állapot hash: a minták csak ekkor számolják ki, kikapcsolt naplónál soha. */
+/** Whether this frame takes a state hash: the samples only compute it then, never with the journal off. */
+bool journalHashFrame() {
+	if (inputJournal.mode == JournalRecord)
+		return inputJournal.frameRecorded && inputJournal.frame % inputJournal.hashInterval == 0;
+	if (inputJournal.mode == JournalReplay)
+		return inputJournal.cursor < inputJournal.events.size() && inputJournal.events[inputJournal.cursor].type == InputStateHash;
+	return false;
+}
+
+/** A szimuláció után, ha journalHashFrame igaz: felvételkor rögzíti az állapot hasht, visszajátszáskor összeveti. */
+/** After the simulation, when journalHashFrame is true: records the state hash, compares it while replaying. */
+void checkJournalState(GLuint64 hash) {
+	if (!journalHashFrame()) return;
+	if (inputJournal.mode == JournalRecord) {
+		InputEvent	event = InputEvent();
+
+		event.type = InputStateHash;
+		event.hash = hash;
+		recordInputEvent(event);
+	}
+	else {
+		const InputEvent	&event = inputJournal.events[inputJournal.cursor++];
+
+		inputJournal.hashChecks++;
+		if (event.hash != hash) {
+			if (inputJournal.hashMismatches++ == 0) std::cerr << "State hash mismatch first at frame " << event.frame << "." << std::endl;
+		}
+	}
+}
+
+/** Kilépéskor: a felvételt fileba menti, a visszajátszásról összesítést ír. */
+/** On exit: saves the recording, prints a summary of the replay. */
+void finishInputJournal() {
+	if (inputJournal.mode == JournalRecord) {
+		if (saveInputJournal(inputJournal.path))
+			std::cout << "Recorded " << inputJournal.events.size() << " events in " << inputJournal.frame << " frames to " << inputJournal.path << "." << std::endl;
+	}
+	else if (inputJournal.mode == JournalReplay) {
+		GLdouble	elapsed = glfwGetTime() - inputJournal.startTime;
+
+		std::cout << "Replayed " << inputJournal.frame << " frames in " << elapsed << " s, " << 1000.0 * elapsed / std::max(inputJournal.frame, 1u) << " ms/frame, "
+			<< inputJournal.hashChecks << " state hashes checked, " << inputJournal.hashMismatches << " mismatches." << std::endl;
+	}
+}
+#endif
\ No newline at end of file
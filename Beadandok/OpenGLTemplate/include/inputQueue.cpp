@@ -0,0 +1,180 @@
+/** Bemeneti eseménysor: a GLFW callbackek csak időbélyeggel sorba teszik az eseményt, a feldolgozás képkockánként egyszer történik. */
+/** Input event queue: the GLFW callbacks only enqueue the timestamped event, processing happens once per frame. */
+#ifndef INPUT_QUEUE_CPP
+#define INPUT_QUEUE_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <inputJournal.cpp>
+
+/** Kettő hatványa, hogy az index maszkolható legyen. */
+/** Power of two, so the index can be masked. */
+const size_t	inputQueueCapacity = 1024;
+
+/** Egy termelős, egy fogyasztós gyűrűpuffer zár nélkül: a head-et csak a termelő, a tail-t csak a fogyasztó írja. */
+/** Single producer, single consumer ring buffer without locks: head is only written by the producer, tail only by the consumer. */
+typedef struct {
+	InputEvent					events[inputQueueCapacity];
+	alignas(64) std::atomic<size_t>	head;
+	alignas(64) std::atomic<size_t>	tail;
+	std::atomic<GLuint>			dropped;			// events lost to a full queue
+	GLdouble					pendingInputTime;	// timestamp of the oldest event drained but not yet presented, < 0 if none
+	GLdouble					latency;			// input-to-present latency of the last frame with input, in seconds
+	GLdouble					maxLatency;
+	GLuint						coalesced;			// cursor moves merged into a later one
+} InputQueue;
+
+InputQueue	inputQueue;
+
+/** Termelő oldal: false, ha a sor tele van. */
+/** Producer side: false when the queue is full. */
+bool pushInputEvent(InputQueue &queue, const InputEvent &event) {
+	size_t	head = queue.head.load(std::memory_order_relaxed);
+
+	if (head - queue.tail.load(std::memory_order_acquire) == inputQueueCapacity) {
+		queue.dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	queue.events[head & (inputQueueCapacity - 1)] = event;
+	queue.head.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+/** Fogyasztó oldal: false, ha a sor üres. */
+/** Consumer side: false when the queue is empty. */
+bool popInputEvent(InputQueue &queue, InputEvent &event) {
+	size_t	tail = queue.tail.load(std::memory_order_relaxed);
+
+	if (tail == queue.head.load(std::memory_order_acquire)) return false;
+	event = queue.events[tail & (inputQueueCapacity - 1)];
+	queue.tail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+/** A GLFW ezeket hívja; a nyers eseményt a beérkezés idejével teszik a sorba. */
+/** GLFW calls these; they enqueue the raw event with its arrival time. */
+void queueKeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
+	InputEvent	event = InputEvent();
+
+	event.type		= InputKey;
+	event.time		= glfwGetTime();
+	event.code		= key;
+	event.scancode	= scancode;
+	event.action	= action;
+	event.mods		= mods;
+	pushInputEvent(inputQueue, event);
+}
+
+void queueCursorPosCallback(GLFWwindow *window, double xPos, double yPos) {
+	InputEvent	event = InputEvent();
+
+	event.type	= InputCursorPos;
+	event.time	= glfwGetTime();
+	event.x		= xPos;
+	event.y		= yPos;
+	pushInputEvent(inputQueue, event);
+}
+
+void queueMouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
+	InputEvent	event = InputEvent();
+
+	event.type		= InputMouseButton;
+	event.time		= glfwGetTime();
+	event.code		= button;
+	event.action	= action;
+	event.mods		= mods;
+	glfwGetCursorPos(window, &event.x, &event.y);
+	pushInputEvent(inputQueue, event);
+}
+
+void queueFramebufferSizeCallback(GLFWwindow *window, int width, int height) {
+	InputEvent	event = InputEvent();
+
+	event.type		= InputFramebufferSize;
+	event.time		= glfwGetTime();
+	event.code		= width;
+	event.action	= height;
+	pushInputEvent(inputQueue, event);
+}
+
+/** Bemeneti napló a minta callbackjei előtt, a sor pedig a napló előtt; nullptr callback nem kerül regisztrálásra. */
+/** Input journal in front of the sample's callbacks, and the queue in front of the journal; nullptr callbacks are not registered. */
+void installInputQueue(GLFWwindow *window, GLFWkeyfun keyFun, GLFWcursorposfun cursorPosFun, GLFWmousebuttonfun mouseButtonFun, GLFWframebuffersizefun framebufferSizeFun) {
+	installInputJournal(window, keyFun, cursorPosFun, mouseButtonFun, framebufferSizeFun);
+	inputQueue.head.store(0);
+	inputQueue.tail.store(0);
+	inputQueue.dropped.store(0);
+	inputQueue.pendingInputTime	= -1.0;
+	inputQueue.latency			= 0.0;
+	inputQueue.maxLatency		= 0.0;
+	inputQueue.coalesced		= 0;
+
+	if (keyFun) glfwSetKeyCallback(window, queueKeyCallback);
+	if (cursorPosFun) glfwSetCursorPosCallback(window, queueCursorPosCallback);
+	if (mouseButtonFun) glfwSetMouseButtonCallback(window, queueMouseButtonCallback);
+	if (framebufferSizeFun) glfwSetFramebufferSizeCallback(window, queueFramebufferSizeCallback);
+}
+
+/** Képkockánként egyszer, a szimuláció és a rajzolás előtt: kiosztja a sorban álló eseményeket a naplón keresztül.
+	Az egymást követő kurzormozgásokból csak az utolsó fut le, a többi a késleltetés mérésébe számít bele. */
+/** Once per frame, before simulation and rendering: dispatches the queued events through the journal.
+	Of consecutive cursor moves only the last one runs, the others only count for the latency measurement. */
+void drainInputQueue(GLFWwindow *window) {
+	InputEvent	event, pendingCursor;
+	bool		hasPendingCursor = false;
+
+	while (popInputEvent(inputQueue, event)) {
+		if (inputQueue.pendingInputTime < 0.0) inputQueue.pendingInputTime = event.time;
+		if (event.type == InputCursorPos) {
+			if (hasPendingCursor) inputQueue.coalesced++;
+			pendingCursor		= event;
+			hasPendingCursor	= true;
+			continue;
+		}
+		if (hasPendingCursor) {
+			journalQueuedEvent(window, pendingCursor);
+			hasPendingCursor = false;
+		}
+		journalQueuedEvent(window, event);
+	}
+	if (hasPendingCursor) journalQueuedEvent(window, pendingCursor);
+}
+
+/** Fogyasztó oldal: a legrégebbi feldolgozott, még meg nem jelenített esemény ideje (< 0, ha nincs), és törli azt.
+	Külön szimulációs szálnál ezt viszi a pillanatkép a rajzoló szálhoz. */
+/** Consumer side: time of the oldest processed but not yet presented event (< 0 if none), and clears it.
+	With a separate simulation thread the snapshot carries it to the render thread. */
+GLdouble takeInputTime() {
+	GLdouble	inputTime = inputQueue.pendingInputTime;
+
+	/** Visszajátszáskor az események nem a sorból jönnek: a kiosztásuk ideje számít. */
+	/** While replaying the events do not come from the queue: the time of their dispatch counts. */
+	if (inputJournal.mode == JournalReplay) {
+		inputTime = inputJournal.dispatchedEvents > 0 ? glfwGetTime() : -1.0;
+		inputJournal.dispatchedEvents = 0;
+	}
+	inputQueue.pendingInputTime = -1.0;
+
+	return inputTime;
+}
+
+/** glfwSwapBuffers után: az inputTime időpontú esemény és a megjelenítés közti idő; true, ha volt esemény. */
+/** After glfwSwapBuffers: time between the event at inputTime and the present; true if there was an event. */
+bool markInputPresented(GLdouble inputTime) {
+	if (inputTime < 0.0) return false;
+	inputQueue.latency		= glfwGetTime() - inputTime;
+	inputQueue.maxLatency	= std::max(inputQueue.maxLatency, inputQueue.latency);
+
+	return true;
+}
+
+/** Egy szálon: a legrégebbi, ebben a képkockában feldolgozott esemény késleltetése. */
+/** Single threaded: latency of the oldest event processed in this frame. */
+bool markInputPresented() {
+	return markInputPresented(takeInputTime());
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+/** Instancolt, élsimított körmarker rajzoló a GL_POINTS + GL_POINT_SMOOTH helyett. */
+/** Instanced, antialiased circle marker renderer replacing GL_POINTS + GL_POINT_SMOOTH. */
+#ifndef MARKER_RENDERER_CPP
+#define MARKER_RENDERER_CPP
+
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <vector>
+
+/** Egy marker példány adatai; az elrendezés egyezik a MarkerVertShader.glsl attribútumaival. */
+/** Per-instance marker data; the layout matches the attributes of MarkerVertShader.glsl. */
+typedef struct {
+	glm::vec3	position;	// world space, transformed by matTransform
+	GLfloat		size;		// diameter in pixels
+	glm::vec4	color;
+	GLfloat		selected;	// 0 = normal, 1 = highlighted
+} MarkerInstance;
+
+typedef struct {
+	GLuint		program;
+	GLuint		vao;
+	GLuint		quadBuffer;
+	GLuint		instanceBuffer;
+	GLint		locationMatTransform, locationViewportSize, locationHighlightColor;
+	GLsizei		capacity;
+	GLsizei		count;
+	glm::vec4	highlightColor;
+} MarkerRenderer;
+
+/** A program a MarkerVertShader.glsl és MarkerFragShader.glsl shaderekből készül, ezt a minta tölti be. */
+/** The program is built from MarkerVertShader.glsl and MarkerFragShader.glsl, loaded by the sample. */
+void initMarkerRenderer(MarkerRenderer &renderer, GLuint program) {
+	const glm::vec2	quad[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+
+	renderer.program				= program;
+	renderer.capacity				= 0;
+	renderer.count					= 0;
+	renderer.highlightColor			= glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	renderer.locationMatTransform	= glGetUniformLocation(program, "matTransform");
+	renderer.locationViewportSize	= glGetUniformLocation(program, "viewportSize");
+	renderer.locationHighlightColor	= glGetUniformLocation(program, "highlightColor");
+
+	glGenVertexArrays(1, &renderer.vao);
+	glGenBuffers(1, &renderer.quadBuffer);
+	glGenBuffers(1, &renderer.instanceBuffer);
+	glBindVertexArray(renderer.vao);
+	/** Az egységnégyzet minden példánynál közös. */
+	/** The unit quad is shared by every instance. */
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.quadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+	glEnableVertexAttribArray(0);
+	/** Példányonkénti pozíció, méret, szín és kijelölés. */
+	/** Per-instance position, size, color and selection. */
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.instanceBuffer);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MarkerInstance), (void*)offsetof(MarkerInstance, position));
+	glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(MarkerInstance), (void*)offsetof(MarkerInstance, size));
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(MarkerInstance), (void*)offsetof(MarkerInstance, color));
+	glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(MarkerInstance), (void*)offsetof(MarkerInstance, selected));
+	for (GLuint attribute = 1; attribute <= 4; attribute++) {
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+	glBindVertexArray(0);
+}
+
+/** Csak változáskor kell hívni; a buffer mérete mértani sorozat szerint nő. Inicializálás előtt nem csinál semmit. */
+/** Call only on change; the buffer grows geometrically. Does nothing before initialization. */
+void updateMarkers(MarkerRenderer &renderer, const std::vector<MarkerInstance> &markers) {
+	if (renderer.instanceBuffer == 0) return;
+	renderer.count = (GLsizei)markers.size();
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.instanceBuffer);
+	if (renderer.count > renderer.capacity) {
+		renderer.capacity = glm::max(renderer.count, 2 * renderer.capacity);
+		glBufferData(GL_ARRAY_BUFFER, renderer.capacity * sizeof(MarkerInstance), nullptr, GL_DYNAMIC_DRAW);
+	}
+	if (renderer.count > 0)
+		glBufferSubData(GL_ARRAY_BUFFER, 0, renderer.count * sizeof(MarkerInstance), markers.data());
+}
+
+/** Az összes markert egyetlen instancolt hívással rajzolja ki; a hívó engedélyezi a GL_BLEND-et. */
+/** Draws every marker with one instanced call; the caller enables GL_BLEND. */
+void drawMarkers(const MarkerRenderer &renderer, const glm::mat4 &matTransform, GLint width, GLint height) {
+	if (renderer.count == 0) return;
+	glUseProgram(renderer.program);
+	glUniformMatrix4fv(renderer.locationMatTransform, 1, GL_FALSE, glm::value_ptr(matTransform));
+	glUniform2f(renderer.locationViewportSize, (GLfloat)width, (GLfloat)height);
+	glUniform4fv(renderer.locationHighlightColor, 1, glm::value_ptr(renderer.highlightColor));
+	glBindVertexArray(renderer.vao);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, renderer.count);
+}
+
+void deleteMarkerRenderer(MarkerRenderer &renderer) {
+	glDeleteVertexArrays(1, &renderer.vao);
+	glDeleteBuffers(1, &renderer.quadBuffer);
+	glDeleteBuffers(1, &renderer.instanceBuffer);
+	renderer.capacity	= 0;
+	renderer.count		= 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,312 @@
+/** Pattogó körök részecskerendszere: structure-of-arrays tárolás, SIMD léptetés és instancolt rajzolás. */
+/** Particle system of bouncing circles: structure-of-arrays storage, SIMD stepping and instanced drawing. */
+#ifndef PARTICLE_SYSTEM_CPP
+#define PARTICLE_SYSTEM_CPP
+
+#include <cmath>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <random>
+#include <simdDispatch.cpp>
+#include <vector>
+
+/** Minden tulajdonság külön tömbben, így a kernelek egymás melletti elemeket töltenek be. */
+/** Every property lives in its own array, so the kernels load adjacent elements. */
+typedef struct {
+	std::vector<GLfloat>	posX, posY;
+	std::vector<GLfloat>	velX, velY;
+	std::vector<GLfloat>	radius;
+	std::vector<GLuint>		color;		// RGBA8, red in the lowest byte
+} ParticleSystem;
+
+size_t particleCount(const ParticleSystem &particles) {
+	return particles.posX.size();
+}
+
+GLuint packColor(const glm::vec3 &color) {
+	glm::uvec3	c = glm::uvec3(glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+	return c.r | (c.g << 8) | (c.b << 16) | (255u << 24);
+}
+
+/** Rögzített seed mellett a kezdőállapot determinisztikus. */
+/** With a fixed seed the initial state is deterministic. */
+void spawnParticles(ParticleSystem &particles, size_t count, GLfloat width, GLfloat height, GLfloat minRadius, GLfloat maxRadius, GLfloat speed, GLuint seed) {
+	std::mt19937							generator(seed);
+	std::uniform_real_distribution<GLfloat>	unit(0.0f, 1.0f);
+
+	particles.posX.resize(count);
+	particles.posY.resize(count);
+	particles.velX.resize(count);
+	particles.velY.resize(count);
+	particles.radius.resize(count);
+	particles.color.resize(count);
+
+	for (size_t i = 0; i < count; i++) {
+		GLfloat	r		= minRadius + (maxRadius - minRadius) * unit(generator);
+		GLfloat	angle	= 2.0f * glm::pi<GLfloat>() * unit(generator);
+
+		particles.radius[i]	= r;
+		particles.posX[i]	= r + (width - 2.0f * r) * unit(generator);
+		particles.posY[i]	= r + (height - 2.0f * r) * unit(generator);
+		particles.velX[i]	= speed * std::cos(angle);
+		particles.velY[i]	= speed * std::sin(angle);
+		particles.color[i]	= packColor(glm::vec3(unit(generator), unit(generator), unit(generator)));
+	}
+}
+
+/** Egy tengely visszapattanása, ugyanaz a logika mint a Hazi főciklusában. */
+/** Wall bounce along one axis, the same logic as in the main loop of Hazi. */
+inline void bounceScalar(GLfloat &pos, GLfloat &vel, GLfloat r, GLfloat limit) {
+	if (pos - r < 0.0f) {
+		pos = r;
+		vel = std::fabs(vel);
+	}
+	else if (pos + r > limit) {
+		pos = limit - r;
+		vel = -std::fabs(vel);
+	}
+}
+
+#if defined(SIMD_X86)
+SIMD_TARGET("avx") inline void bounceAVX(__m256 &pos, __m256 &vel, __m256 r, __m256 limit) {
+	const __m256	signMask	= _mm256_set1_ps(-0.0f);
+	__m256			low			= _mm256_cmp_ps(_mm256_sub_ps(pos, r), _mm256_setzero_ps(), _CMP_LT_OQ);
+	__m256			high		= _mm256_andnot_ps(low, _mm256_cmp_ps(_mm256_add_ps(pos, r), limit, _CMP_GT_OQ));
+	__m256			absVel		= _mm256_andnot_ps(signMask, vel);
+
+	pos = _mm256_blendv_ps(pos, r, low);
+	pos = _mm256_blendv_ps(pos, _mm256_sub_ps(limit, r), high);
+	vel = _mm256_blendv_ps(vel, absVel, low);
+	vel = _mm256_blendv_ps(vel, _mm256_or_ps(absVel, signMask), high);
+}
+
+/** mask ? a : b, SSE2 alatt nincs blendv. */
+/** mask ? a : b, SSE2 has no blendv. */
+SIMD_TARGET("sse2") inline __m128 selectSSE(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+SIMD_TARGET("sse2") inline void bounceSSE(__m128 &pos, __m128 &vel, __m128 r, __m128 limit) {
+	const __m128	signMask	= _mm_set1_ps(-0.0f);
+	__m128			low			= _mm_cmplt_ps(_mm_sub_ps(pos, r), _mm_setzero_ps());
+	__m128			high		= _mm_andnot_ps(low, _mm_cmpgt_ps(_mm_add_ps(pos, r), limit));
+	__m128			absVel		= _mm_andnot_ps(signMask, vel);
+
+	pos = selectSSE(low, r, pos);
+	pos = selectSSE(high, _mm_sub_ps(limit, r), pos);
+	vel = selectSSE(low, absVel, vel);
+	vel = selectSSE(high, _mm_or_ps(absVel, signMask), vel);
+}
+#endif
+
+/** A SIMD és a skalár út csak akkor bitre azonos, ha a szorzás és az összeadás nem olvad FMA-vá: GCC és Clang -mfma mellett alapból összevonja (az intrinsicseket is), ezért itt kikapcsoljuk; MSVC alatt a /fp:precise nem von össze. */
+/** The SIMD and scalar paths are only bit-identical if the multiply and the add are not fused into an FMA: GCC and Clang contract them by default with -mfma (the intrinsics too), so it is turned off here; MSVC does not contract under /fp:precise. */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(SIMD_X86)
+/** Az AVX kernel 8 részecskénként, a begin-től; a következő feldolgozatlan indexet adja vissza, a maradék a skalár kódé. */
+/** The AVX kernel, 8 particles at a time from begin; returns the next index not done, the rest is left to the scalar code. */
+SIMD_TARGET("avx") size_t stepParticleRangeAVX(ParticleSystem &particles, size_t begin, size_t end, GLfloat dt, GLfloat width, GLfloat height) {
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#endif
+	GLfloat			*posX	= particles.posX.data();
+	GLfloat			*posY	= particles.posY.data();
+	GLfloat			*velX	= particles.velX.data();
+	GLfloat			*velY	= particles.velY.data();
+	GLfloat			*radius	= particles.radius.data();
+	size_t			i		= begin;
+	const __m256	step	= _mm256_set1_ps(dt);
+	const __m256	limitX	= _mm256_set1_ps(width);
+	const __m256	limitY	= _mm256_set1_ps(height);
+
+	for (; i + 8 <= end; i += 8) {
+		__m256	r	= _mm256_loadu_ps(radius + i);
+		__m256	vx	= _mm256_loadu_ps(velX + i);
+		__m256	vy	= _mm256_loadu_ps(velY + i);
+		__m256	x	= _mm256_add_ps(_mm256_loadu_ps(posX + i), _mm256_mul_ps(vx, step));
+		__m256	y	= _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(vy, step));
+
+		bounceAVX(x, vx, r, limitX);
+		bounceAVX(y, vy, r, limitY);
+		_mm256_storeu_ps(posX + i, x);
+		_mm256_storeu_ps(posY + i, y);
+		_mm256_storeu_ps(velX + i, vx);
+		_mm256_storeu_ps(velY + i, vy);
+	}
+	return i;
+}
+
+/** Az SSE2 kernel 4 részecskénként. */
+/** The SSE2 kernel, 4 particles at a time. */
+SIMD_TARGET("sse2") size_t stepParticleRangeSSE2(ParticleSystem &particles, size_t begin, size_t end, GLfloat dt, GLfloat width, GLfloat height) {
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#endif
+	GLfloat			*posX	= particles.posX.data();
+	GLfloat			*posY	= particles.posY.data();
+	GLfloat			*velX	= particles.velX.data();
+	GLfloat			*velY	= particles.velY.data();
+	GLfloat			*radius	= particles.radius.data();
+	size_t			i		= begin;
+	const __m128	step	= _mm_set1_ps(dt);
+	const __m128	limitX	= _mm_set1_ps(width);
+	const __m128	limitY	= _mm_set1_ps(height);
+
+	for (; i + 4 <= end; i += 4) {
+		__m128	r	= _mm_loadu_ps(radius + i);
+		__m128	vx	= _mm_loadu_ps(velX + i);
+		__m128	vy	= _mm_loadu_ps(velY + i);
+		__m128	x	= _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, step));
+		__m128	y	= _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, step));
+
+		bounceSSE(x, vx, r, limitX);
+		bounceSSE(y, vy, r, limitY);
+		_mm_storeu_ps(posX + i, x);
+		_mm_storeu_ps(posY + i, y);
+		_mm_storeu_ps(velX + i, vx);
+		_mm_storeu_ps(velY + i, vy);
+	}
+	return i;
+}
+#endif
+
+/** A [begin, end) tartományt lépteti dt idővel és visszapattintja a [0, width] x [0, height] falakról; a kernel futás közben választódik (selectSimdKernel). */
+/** Steps the [begin, end) range by dt and bounces it off the [0, width] x [0, height] walls; the kernel is picked at runtime (selectSimdKernel). */
+void stepParticleRange(ParticleSystem &particles, size_t begin, size_t end, GLfloat dt, GLfloat width, GLfloat height, eSimdKernel kernel = SimdKernelAuto) {
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#endif
+	GLfloat	*posX	= particles.posX.data();
+	GLfloat	*posY	= particles.posY.data();
+	GLfloat	*velX	= particles.velX.data();
+	GLfloat	*velY	= particles.velY.data();
+	GLfloat	*radius	= particles.radius.data();
+	size_t	i		= begin;
+
+#if defined(SIMD_X86)
+	switch (selectSimdKernel(kernel)) {
+	case SimdKernelAVX:		i = stepParticleRangeAVX(particles, begin, end, dt, width, height); break;
+	case SimdKernelSSE2:	i = stepParticleRangeSSE2(particles, begin, end, dt, width, height); break;
+	default:				break;
+	}
+#endif
+	/** A maradék elemek (és SIMD nélkül az összes) skalár kóddal. */
+	/** The remaining elements (and all of them without SIMD) with scalar code. */
+	for (; i < end; i++) {
+		posX[i] += velX[i] * dt;
+		posY[i] += velY[i] * dt;
+		bounceScalar(posX[i], velX[i], radius[i], width);
+		bounceScalar(posY[i], velY[i], radius[i], height);
+	}
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+void stepParticles(ParticleSystem &particles, GLfloat dt, GLfloat width, GLfloat height) {
+	stepParticleRange(particles, 0, particleCount(particles), dt, width, height);
+}
+
+/** A GPU oldali bufferek is SoA elrendezésűek, a pozíciók minden képkockán, a többi csak spawnoláskor töltődik fel. */
+/** GPU buffers are SoA as well, positions are uploaded every frame, the rest only on spawn. */
+typedef struct {
+	GLuint	program;
+	GLuint	vao;
+	GLuint	quadBuffer, posXBuffer, posYBuffer, radiusBuffer, colorBuffer;
+	GLint	locationViewportSize, locationOuterColor;
+	GLsizei	count;
+} ParticleRenderer;
+
+/** A program a ParticleVertShader.glsl és ParticleFragShader.glsl shaderekből készül, ezt a minta tölti be. */
+/** The program is built from ParticleVertShader.glsl and ParticleFragShader.glsl, loaded by the sample. */
+void initParticleRenderer(ParticleRenderer &renderer, GLuint program) {
+	const glm::vec2	quad[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+	GLuint			*buffers[] = { &renderer.posXBuffer, &renderer.posYBuffer, &renderer.radiusBuffer };
+
+	renderer.program				= program;
+	renderer.count					= 0;
+	renderer.locationViewportSize	= glGetUniformLocation(program, "viewportSize");
+	renderer.locationOuterColor		= glGetUniformLocation(program, "outerColor");
+
+	glGenVertexArrays(1, &renderer.vao);
+	glGenBuffers(1, &renderer.quadBuffer);
+	glGenBuffers(1, &renderer.posXBuffer);
+	glGenBuffers(1, &renderer.posYBuffer);
+	glGenBuffers(1, &renderer.radiusBuffer);
+	glGenBuffers(1, &renderer.colorBuffer);
+	glBindVertexArray(renderer.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.quadBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+	glEnableVertexAttribArray(0);
+	/** Példányonként egy-egy float a posX, posY és radius tömbökből. */
+	/** One float per instance from each of the posX, posY and radius arrays. */
+	for (GLuint attribute = 1; attribute <= 3; attribute++) {
+		glBindBuffer(GL_ARRAY_BUFFER, *buffers[attribute - 1]);
+		glVertexAttribPointer(attribute, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (void*)0);
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.colorBuffer);
+	glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GLuint), (void*)0);
+	glEnableVertexAttribArray(4);
+	glVertexAttribDivisor(4, 1);
+	glBindVertexArray(0);
+}
+
+/** Spawnolás után: a bufferek újrafoglalása és a méretek, színek feltöltése. */
+/** After spawning: reallocates the buffers and uploads radii and colors. */
+void uploadParticleAttributes(ParticleRenderer &renderer, const ParticleSystem &particles) {
+	renderer.count = (GLsizei)particleCount(particles);
+	GLsizeiptr	floatBytes = renderer.count * sizeof(GLfloat);
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.posXBuffer);
+	glBufferData(GL_ARRAY_BUFFER, floatBytes, particles.posX.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.posYBuffer);
+	glBufferData(GL_ARRAY_BUFFER, floatBytes, particles.posY.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.radiusBuffer);
+	glBufferData(GL_ARRAY_BUFFER, floatBytes, particles.radius.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.colorBuffer);
+	glBufferData(GL_ARRAY_BUFFER, renderer.count * sizeof(GLuint), particles.color.data(), GL_STATIC_DRAW);
+}
+
+/** Minden képkockán: a régi tárterület elengedése (orphaning), hogy a feltöltés ne várjon a GPU-ra. */
+/** Every frame: orphans the old storage so the upload does not wait for the GPU. */
+void uploadParticlePositions(const ParticleRenderer &renderer, const ParticleSystem &particles) {
+	GLsizeiptr	floatBytes = renderer.count * sizeof(GLfloat);
+
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.posXBuffer);
+	glBufferData(GL_ARRAY_BUFFER, floatBytes, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, floatBytes, particles.posX.data());
+	glBindBuffer(GL_ARRAY_BUFFER, renderer.posYBuffer);
+	glBufferData(GL_ARRAY_BUFFER, floatBytes, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, floatBytes, particles.posY.data());
+}
+
+/** Az összes részecske egyetlen instancolt hívással; a hívó engedélyezi a GL_BLEND-et. */
+/** Every particle with one instanced call; the caller enables GL_BLEND. */
+void drawParticles(const ParticleRenderer &renderer, const glm::vec3 &outerColor, GLint width, GLint height) {
+	if (renderer.count == 0) return;
+	glUseProgram(renderer.program);
+	glUniform2f(renderer.locationViewportSize, (GLfloat)width, (GLfloat)height);
+	glUniform3fv(renderer.locationOuterColor, 1, &outerColor[0]);
+	glBindVertexArray(renderer.vao);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, renderer.count);
+}
+
+void deleteParticleRenderer(ParticleRenderer &renderer) {
+	GLuint	buffers[] = { renderer.quadBuffer, renderer.posXBuffer, renderer.posYBuffer, renderer.radiusBuffer, renderer.colorBuffer };
+
+	glDeleteBuffers(5, buffers);
+	glDeleteVertexArrays(1, &renderer.vao);
+	renderer.count = 0;
+}
+#endif
\ No newline at end of file
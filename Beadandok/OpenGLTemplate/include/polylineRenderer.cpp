@@ -0,0 +1,139 @@
+/** Vastag, élsimított törött vonal rajzoló a glLineWidth és a GL_LINE_SMOOTH helyett. */
+/** Thick, antialiased polyline renderer replacing glLineWidth and GL_LINE_SMOOTH. */
+#ifndef POLYLINE_RENDERER_CPP
+#define POLYLINE_RENDERER_CPP
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <vector>
+
+/** Csatlakozási módok, egyeznek a PolylineVertShader.glsl értékeivel. */
+/** Join styles, they match the values of PolylineVertShader.glsl. */
+enum ePolylineJoin {
+	PolylineJoinMiter,
+	PolylineJoinRound
+};
+
+/** A csúcspontok vec4(x, y, z, szélesség pixelben) alakúak, a 0 szélességű elem két törött vonalat választ el. */
+/** Vertices are vec4(x, y, z, width in pixels), an entry with zero width separates two polylines. */
+typedef struct {
+	GLuint			program;
+	GLuint			vao;
+	GLuint			buffer;
+	GLuint			texture;
+	GLint			locationMatTransform, locationViewportSize, locationPointCount, locationJoinStyle, locationMiterLimit, locationColor, locationPoints;
+	GLsizei			capacity;
+	GLsizei			count;
+	ePolylineJoin	joinStyle;
+	GLfloat			miterLimit;
+} PolylineRenderer;
+
+/** A program a PolylineVertShader.glsl és PolylineFragShader.glsl shaderekből készül, ezt a minta tölti be. */
+/** The program is built from PolylineVertShader.glsl and PolylineFragShader.glsl, loaded by the sample. */
+void initPolylineRenderer(PolylineRenderer &renderer, GLuint program) {
+	renderer.program				= program;
+	renderer.capacity				= 0;
+	renderer.count					= 0;
+	renderer.joinStyle				= PolylineJoinRound;
+	renderer.miterLimit				= 4.0f;
+	renderer.locationMatTransform	= glGetUniformLocation(program, "matTransform");
+	renderer.locationViewportSize	= glGetUniformLocation(program, "viewportSize");
+	renderer.locationPointCount		= glGetUniformLocation(program, "pointCount");
+	renderer.locationJoinStyle		= glGetUniformLocation(program, "joinStyle");
+	renderer.locationMiterLimit		= glGetUniformLocation(program, "miterLimit");
+	renderer.locationColor			= glGetUniformLocation(program, "color");
+	renderer.locationPoints			= glGetUniformLocation(program, "points");
+	/** A vertex shader a gl_VertexID és gl_InstanceID alapján olvas a buffer textúrából, így a VAO üres. */
+	/** The vertex shader reads the buffer texture by gl_VertexID and gl_InstanceID, so the VAO is empty. */
+	glGenVertexArrays(1, &renderer.vao);
+	glGenBuffers(1, &renderer.buffer);
+	glGenTextures(1, &renderer.texture);
+	glBindBuffer(GL_TEXTURE_BUFFER, renderer.buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, renderer.texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, renderer.buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/** Egy törött vonalat fűz a csúcspont tömbhöz állandó szélességgel, szükség esetén elválasztóval. */
+/** Appends one polyline with constant width to the vertex array, with a separator when needed. */
+void appendPolyline(std::vector<glm::vec4> &vertices, const glm::vec3 *points, size_t count, GLfloat width) {
+	if (count == 0) return;
+	if (!vertices.empty() && vertices.back().w > 0.0f)
+		vertices.push_back(glm::vec4(0.0f));
+	for (size_t i = 0; i < count; i++)
+		vertices.push_back(glm::vec4(points[i], width));
+}
+
+/** Csak változáskor kell hívni; a buffer mérete mértani sorozat szerint nő. Inicializálás előtt nem csinál semmit. */
+/** Call only on change; the buffer grows geometrically. Does nothing before initialization. */
+void updatePolylines(PolylineRenderer &renderer, const std::vector<glm::vec4> &vertices) {
+	if (renderer.buffer == 0) return;
+	renderer.count = (GLsizei)vertices.size();
+	glBindBuffer(GL_TEXTURE_BUFFER, renderer.buffer);
+	if (renderer.count > renderer.capacity) {
+		renderer.capacity = glm::max(renderer.count, 2 * renderer.capacity);
+		glBufferData(GL_TEXTURE_BUFFER, renderer.capacity * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+	}
+	if (renderer.count > 0)
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, renderer.count * sizeof(glm::vec4), vertices.data());
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/** A GPU-n (transform feedbackkel vagy compute shaderrel) írt törött vonalakhoz: legalább count elemnyi helyet foglal és beállítja a darabszámot, a tartalmat a GPU írja. */
+/** For polylines written on the GPU (by transform feedback or a compute shader): makes room for at least count entries and sets the count, the content is written by the GPU. */
+void reservePolylines(PolylineRenderer &renderer, GLsizei count) {
+	if (renderer.buffer == 0) return;
+	renderer.count = count;
+	if (count <= renderer.capacity) return;
+	renderer.capacity = glm::max(count, 2 * renderer.capacity);
+	glBindBuffer(GL_TEXTURE_BUFFER, renderer.buffer);
+	glBufferData(GL_TEXTURE_BUFFER, renderer.capacity * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/** A rajzolás közös beállításai: program, uniformok, buffer textúra és VAO. */
+/** The common setup of the draws: program, uniforms, buffer texture and VAO. */
+void bindPolylineRenderer(const PolylineRenderer &renderer, const glm::mat4 &matTransform, const glm::vec4 &color, GLint width, GLint height) {
+	glUseProgram(renderer.program);
+	glUniformMatrix4fv(renderer.locationMatTransform, 1, GL_FALSE, glm::value_ptr(matTransform));
+	glUniform2f(renderer.locationViewportSize, (GLfloat)width, (GLfloat)height);
+	glUniform1i(renderer.locationPointCount, renderer.count);
+	glUniform1i(renderer.locationJoinStyle, renderer.joinStyle);
+	glUniform1f(renderer.locationMiterLimit, renderer.miterLimit);
+	glUniform4fv(renderer.locationColor, 1, glm::value_ptr(color));
+	glUniform1i(renderer.locationPoints, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_BUFFER, renderer.texture);
+	glBindVertexArray(renderer.vao);
+}
+
+/** Szakaszonként egy példány, az összes törött vonal egyetlen hívással; a hívó engedélyezi a GL_BLEND-et. */
+/** One instance per segment, every polyline in one call; the caller enables GL_BLEND. */
+void drawPolylines(const PolylineRenderer &renderer, const glm::mat4 &matTransform, const glm::vec4 &color, GLint width, GLint height) {
+	if (renderer.count < 2) return;
+	bindPolylineRenderer(renderer, matTransform, color, width, height);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, renderer.count - 1);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+/** A GPU által írt DrawArraysIndirectCommand tömbből rajzol: törött vonalanként { 4, szakaszok száma, 4 * első pont, 0 }. A pontok előtt és után elválasztó áll. */
+/** Draws from a GPU-written DrawArraysIndirectCommand array: per polyline { 4, segment count, 4 * first point, 0 }. A separator stands before and after the points. */
+void drawPolylinesIndirect(const PolylineRenderer &renderer, const glm::mat4 &matTransform, const glm::vec4 &color, GLint width, GLint height, GLuint commandBuffer, GLsizei drawCount) {
+	if (renderer.count < 2 || drawCount == 0) return;
+	bindPolylineRenderer(renderer, matTransform, color, width, height);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glMultiDrawArraysIndirect(GL_TRIANGLE_STRIP, nullptr, drawCount, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void deletePolylineRenderer(PolylineRenderer &renderer) {
+	glDeleteTextures(1, &renderer.texture);
+	glDeleteBuffers(1, &renderer.buffer);
+	glDeleteVertexArrays(1, &renderer.vao);
+	renderer.capacity	= 0;
+	renderer.count		= 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+/** Futásidejű SIMD választás: a kernelek a saját utasításkészletükre fordulnak (a projektek /arch nélkül épülnek), és a processzor alapján választunk közülük. */
+/** Runtime SIMD selection: the kernels are compiled for their own instruction set (the projects build without /arch), and one is picked by the CPU. */
+#ifndef SIMD_DISPATCH_CPP
+#define SIMD_DISPATCH_CPP
+
+/** SIMD_TARGET: GCC és Clang alatt a függvény erre az utasításkészletre fordul, MSVC minden intrinsicet enged. */
+/** SIMD_TARGET: under GCC and Clang the function is compiled for that instruction set, MSVC allows every intrinsic. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define SIMD_X86
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_X86
+#define SIMD_TARGET(isa)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+enum eSimdKernel {
+	SimdKernelAuto = -1,		// the best one the CPU supports
+	SimdKernelScalar,
+	SimdKernelSSE2,				// 4 floats
+	SimdKernelAVX				// 8 floats
+};
+
+const char *simdKernelName(eSimdKernel kernel) {
+	switch (kernel) {
+	case SimdKernelSSE2:	return "SSE2";
+	case SimdKernelAVX:		return "AVX";
+	default:				return "scalar";
+	}
+}
+
+/** A processzor (és az AVX regisztereknél az operációs rendszer) által támogatott legjobb kernel. */
+/** The best kernel the CPU (and for the AVX registers, the OS) supports. */
+eSimdKernel detectSimdKernel() {
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) return SimdKernelAVX;
+	if (__builtin_cpu_supports("sse2")) return SimdKernelSSE2;
+#elif defined(SIMD_X86)
+	int	info[4];
+
+	__cpuid(info, 1);
+	/** OSXSAVE és AVX, és az operációs rendszer menti az YMM regisztereket. */
+	/** OSXSAVE and AVX, and the OS saves the YMM registers. */
+	if (((info[2] >> 27) & 3) == 3 && (_xgetbv(0) & 6) == 6) return SimdKernelAVX;
+	if ((info[3] >> 26) & 1) return SimdKernelSSE2;
+#endif
+	return SimdKernelScalar;
+}
+
+/** Egyszer vizsgálja meg a processzort (a statikus inicializálás szálbiztos); a kért kernel, ha támogatott, különben a legjobb. */
+/** Checks the CPU once (static initialization is thread safe); the requested kernel if it is supported, the best one otherwise. */
+eSimdKernel selectSimdKernel(eSimdKernel requested = SimdKernelAuto) {
+	static const eSimdKernel	best = detectSimdKernel();
+
+	return requested == SimdKernelAuto || requested > best ? best : requested;
+}
+#endif
@@ -0,0 +1,55 @@
+/** Zár nélküli hármas puffer: a szimulációs szál pillanatképeket tesz közzé, a rajzoló szál mindig a legfrissebbet olvassa. */
+/** Lock-free triple buffer: the simulation thread publishes snapshots, the render thread always reads the latest one. */
+#ifndef TRIPLE_BUFFER_CPP
+#define TRIPLE_BUFFER_CPP
+
+#include <atomic>
+#include <GL/glew.h>
+
+/** Három rés: egyet az író tölt, egyet az olvasó használ, a harmadik közöttük cserélődik. Egyik fél sem vár a másikra. */
+/** Three slots: the writer fills one, the reader uses one, the third is swapped between them. Neither side waits for the other. */
+const GLuint	tripleBufferFresh = 4;		// flag on the shared index: it holds a snapshot the reader has not seen
+
+template <typename T>
+struct TripleBuffer {
+	T					slots[3];
+	std::atomic<GLuint>	shared;				// slot index between writer and reader, with tripleBufferFresh
+	GLuint				write, read;		// owned by the writer and the reader thread
+};
+
+template <typename T>
+void initTripleBuffer(TripleBuffer<T> &buffer) {
+	buffer.write	= 0;
+	buffer.shared.store(1);
+	buffer.read		= 2;
+}
+
+/** Író oldal: ebbe a résbe készül a következő pillanatkép. */
+/** Writer side: the next snapshot is prepared in this slot. */
+template <typename T>
+T &tripleBufferWriteSlot(TripleBuffer<T> &buffer) {
+	return buffer.slots[buffer.write];
+}
+
+/** Író oldal: a kész rés és a közös rés cseréje; egy még nem olvasott pillanatkép így felülíródik. */
+/** Writer side: swaps the finished slot with the shared one; an unread snapshot is overwritten this way. */
+template <typename T>
+void publishTripleBuffer(TripleBuffer<T> &buffer) {
+	buffer.write = buffer.shared.exchange(buffer.write | tripleBufferFresh, std::memory_order_acq_rel) & ~tripleBufferFresh;
+}
+
+/** Olvasó oldal: true, ha érkezett új pillanatkép, ilyenkor a tripleBufferReadSlot már azt adja. */
+/** Reader side: true if a new snapshot arrived, tripleBufferReadSlot returns it from then on. */
+template <typename T>
+bool acquireTripleBuffer(TripleBuffer<T> &buffer) {
+	if (!(buffer.shared.load(std::memory_order_relaxed) & tripleBufferFresh)) return false;
+	buffer.read = buffer.shared.exchange(buffer.read, std::memory_order_acq_rel) & ~tripleBufferFresh;
+
+	return true;
+}
+
+template <typename T>
+const T &tripleBufferReadSlot(const TripleBuffer<T> &buffer) {
+	return buffer.slots[buffer.read];
+}
+#endif
\ No newline at end of file